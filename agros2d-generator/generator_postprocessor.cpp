@@ -40,6 +40,8 @@ void Agros2DGeneratorModule::generatePluginFilterFiles()
         }
     }
 
+    // expressions are numbered, filter resolves its expression in constructor
+    int index = 0;
     foreach (XMLModule::localvariable lv, m_module->postprocessor().localvariables().localvariable())
     {
         foreach (XMLModule::expression expr, lv.expression())
@@ -50,26 +52,26 @@ void Agros2DGeneratorModule::generatePluginFilterFiles()
                 if (coordinateType == CoordinateType_Planar)
                 {
                     if (lv.type() == "scalar")
-                        createFilterExpression(output, QString::fromStdString(lv.id()),
+                        createFilterExpression(output, index, QString::fromStdString(lv.id()),
                                                analysisType,
                                                coordinateType,
                                                PhysicFieldVariableComp_Scalar,
                                                QString::fromStdString(expr.planar().get()));
                     if (lv.type() == "vector")
                     {
-                        createFilterExpression(output, QString::fromStdString(lv.id()),
+                        createFilterExpression(output, index, QString::fromStdString(lv.id()),
                                                analysisType,
                                                coordinateType,
                                                PhysicFieldVariableComp_X,
                                                QString::fromStdString(expr.planar_x().get()));
 
-                        createFilterExpression(output, QString::fromStdString(lv.id()),
+                        createFilterExpression(output, index, QString::fromStdString(lv.id()),
                                                analysisType,
                                                coordinateType,
                                                PhysicFieldVariableComp_Y,
                                                QString::fromStdString(expr.planar_y().get()));
 
-                        createFilterExpression(output, QString::fromStdString(lv.id()),
+                        createFilterExpression(output, index, QString::fromStdString(lv.id()),
                                                analysisType,
                                                coordinateType,
                                                PhysicFieldVariableComp_Magnitude,
@@ -80,26 +82,26 @@ void Agros2DGeneratorModule::generatePluginFilterFiles()
                 else
                 {
                     if (lv.type() == "scalar")
-                        createFilterExpression(output, QString::fromStdString(lv.id()),
+                        createFilterExpression(output, index, QString::fromStdString(lv.id()),
                                                analysisType,
                                                coordinateType,
                                                PhysicFieldVariableComp_Scalar,
                                                QString::fromStdString(expr.axi().get()));
                     if (lv.type() == "vector")
                     {
-                        createFilterExpression(output, QString::fromStdString(lv.id()),
+                        createFilterExpression(output, index, QString::fromStdString(lv.id()),
                                                analysisType,
                                                coordinateType,
                                                PhysicFieldVariableComp_X,
                                                QString::fromStdString(expr.axi_r().get()));
 
-                        createFilterExpression(output, QString::fromStdString(lv.id()),
+                        createFilterExpression(output, index, QString::fromStdString(lv.id()),
                                                analysisType,
                                                coordinateType,
                                                PhysicFieldVariableComp_Y,
                                                QString::fromStdString(expr.axi_z().get()));
 
-                        createFilterExpression(output, QString::fromStdString(lv.id()),
+                        createFilterExpression(output, index, QString::fromStdString(lv.id()),
                                                analysisType,
                                                coordinateType,
                                                PhysicFieldVariableComp_Magnitude,
@@ -324,6 +326,9 @@ void Agros2DGeneratorModule::generatePluginSurfaceIntegralFiles()
         }
     }
 
+    // expressions grouped by analysis and coordinate type
+    QMap<QString, ctemplate::TemplateDictionary *> parts;
+
     int counter = 0;
     foreach (XMLModule::surfaceintegral surf, m_module->postprocessor().surfaceintegrals().surfaceintegral())
     {
@@ -333,7 +338,7 @@ void Agros2DGeneratorModule::generatePluginSurfaceIntegralFiles()
             {
                 if (coordinateType == CoordinateType_Planar)
                 {
-                    createIntegralExpression(output,
+                    createIntegralExpression(output, parts,
                                              "VARIABLE_SOURCE",
                                              QString::fromStdString(surf.id()),
                                              analysisTypeFromStringKey(QString::fromStdString(expr.analysistype())),
@@ -343,7 +348,7 @@ void Agros2DGeneratorModule::generatePluginSurfaceIntegralFiles()
                 }
                 else
                 {
-                    createIntegralExpression(output,
+                    createIntegralExpression(output, parts,
                                              "VARIABLE_SOURCE",
                                              QString::fromStdString(surf.id()),
                                              analysisTypeFromStringKey(QString::fromStdString(expr.analysistype())),
@@ -407,6 +412,9 @@ void Agros2DGeneratorModule::generatePluginVolumeIntegralFiles()
 
     generateSpecialFunctionsPostprocessor(output);
 
+    // expressions grouped by analysis and coordinate type
+    QMap<QString, ctemplate::TemplateDictionary *> parts;
+
     // normal volume integral
     int counter = 0;
     foreach (XMLModule::volumeintegral vol, m_module->postprocessor().volumeintegrals().volumeintegral())
@@ -422,7 +430,7 @@ void Agros2DGeneratorModule::generatePluginVolumeIntegralFiles()
             {
                 if (coordinateType == CoordinateType_Planar)
                 {
-                    createIntegralExpression(output,
+                    createIntegralExpression(output, parts,
                                              "VARIABLE_SOURCE",
                                              QString::fromStdString(vol.id()),
                                              analysisTypeFromStringKey(QString::fromStdString(expr.analysistype())),
@@ -432,7 +440,7 @@ void Agros2DGeneratorModule::generatePluginVolumeIntegralFiles()
                 }
                 else
                 {
-                    createIntegralExpression(output,
+                    createIntegralExpression(output, parts,
                                              "VARIABLE_SOURCE",
                                              QString::fromStdString(vol.id()),
                                              analysisTypeFromStringKey(QString::fromStdString(expr.analysistype())),
@@ -463,7 +471,7 @@ void Agros2DGeneratorModule::generatePluginVolumeIntegralFiles()
                     {
                         if (coordinateType == CoordinateType_Planar)
                         {
-                            createIntegralExpression(output,
+                            createIntegralExpression(output, parts,
                                                      "VARIABLE_SOURCE_EGGSHELL",
                                                      QString::fromStdString(vol.id()),
                                                      analysisTypeFromStringKey(QString::fromStdString(expr.analysistype())),
@@ -473,7 +481,7 @@ void Agros2DGeneratorModule::generatePluginVolumeIntegralFiles()
                         }
                         else
                         {
-                            createIntegralExpression(output,
+                            createIntegralExpression(output, parts,
                                                      "VARIABLE_SOURCE_EGGSHELL",
                                                      QString::fromStdString(vol.id()),
                                                      analysisTypeFromStringKey(QString::fromStdString(expr.analysistype())),
@@ -513,6 +521,7 @@ void Agros2DGeneratorModule::generatePluginVolumeIntegralFiles()
 
 
 void Agros2DGeneratorModule::createFilterExpression(ctemplate::TemplateDictionary &output,
+                                                    int &index,
                                                     const QString &variable,
                                                     AnalysisType analysisType,
                                                     CoordinateType coordinateType,
@@ -523,6 +532,7 @@ void Agros2DGeneratorModule::createFilterExpression(ctemplate::TemplateDictionar
     {
         ctemplate::TemplateDictionary *expression = output.AddSectionDictionary("VARIABLE_SOURCE");
 
+        expression->SetValue("EXPRESSION_INDEX", QString::number(index++).toStdString());
         expression->SetValue("VARIABLE_HASH", QString::number(qHash(variable)).toStdString());
         expression->SetValue("ANALYSIS_TYPE", Agros2DGenerator::analysisTypeStringEnum(analysisType).toStdString());
         expression->SetValue("COORDINATE_TYPE", Agros2DGenerator::coordinateTypeStringEnum(coordinateType).toStdString());
@@ -549,9 +559,21 @@ void Agros2DGeneratorModule::createLocalValueExpression(ctemplate::TemplateDicti
     expression->SetValue("EXPRESSION_SCALAR", exprScalar.isEmpty() ? "0" : m_parser->parsePostprocessorExpression(pmi, exprScalar).replace("[i]", "").toStdString());
     expression->SetValue("EXPRESSION_VECTORX", exprVectorX.isEmpty() ? "0" : m_parser->parsePostprocessorExpression(pmi, exprVectorX).replace("[i]", "").toStdString());
     expression->SetValue("EXPRESSION_VECTORY", exprVectorY.isEmpty() ? "0" : m_parser->parsePostprocessorExpression(pmi, exprVectorY).replace("[i]", "").toStdString());
+
+    // materials resolved per point in batch evaluation
+    foreach (XMLModule::quantity quantity, m_module->volume().quantity())
+    {
+        if (quantity.shortname().present())
+        {
+            ctemplate::TemplateDictionary *variable = expression->AddSectionDictionary("VARIABLE_MATERIAL");
+
+            variable->SetValue("MATERIAL_VARIABLE", quantity.id());
+        }
+    }
 }
 
 void Agros2DGeneratorModule::createIntegralExpression(ctemplate::TemplateDictionary &output,
+                                                      QMap<QString, ctemplate::TemplateDictionary *> &parts,
                                                       const QString &section,
                                                       const QString &variable,
                                                       AnalysisType analysisType,
@@ -561,14 +583,36 @@ void Agros2DGeneratorModule::createIntegralExpression(ctemplate::TemplateDiction
 {
     if (!expr.isEmpty())
     {
+        ParserModuleInfo pmi(*m_module, analysisType, coordinateType, LinearityType_Linear);
+        std::string analysisTypeEnum = Agros2DGenerator::analysisTypeStringEnum(analysisType).toStdString();
+        std::string coordinateTypeEnum = Agros2DGenerator::coordinateTypeStringEnum(coordinateType).toStdString();
+        std::string expressionParsed = m_parser->parsePostprocessorExpression(pmi, expr).toStdString();
+
         ctemplate::TemplateDictionary *expression = output.AddSectionDictionary(section.toStdString());
 
-        ParserModuleInfo pmi(*m_module, analysisType, coordinateType, LinearityType_Linear);
         expression->SetValue("VARIABLE", variable.toStdString());
-        expression->SetValue("ANALYSIS_TYPE", Agros2DGenerator::analysisTypeStringEnum(analysisType).toStdString());
-        expression->SetValue("COORDINATE_TYPE", Agros2DGenerator::coordinateTypeStringEnum(coordinateType).toStdString());
-        expression->SetValue("EXPRESSION", m_parser->parsePostprocessorExpression(pmi, expr).toStdString());
+        expression->SetValue("ANALYSIS_TYPE", analysisTypeEnum);
+        expression->SetValue("COORDINATE_TYPE", coordinateTypeEnum);
+        expression->SetValue("EXPRESSION", expressionParsed);
         expression->SetValue("POSITION", QString::number(pos).toStdString());
+
+        // part of the section with expressions of one analysis and coordinate type (calculator evaluates only one part)
+        QString partKey = QString("%1_%2_%3").arg(section).arg(analysisType).arg(coordinateType);
+        if (!parts.contains(partKey))
+        {
+            ctemplate::TemplateDictionary *part = output.AddSectionDictionary((section + "_PART").toStdString());
+
+            part->SetValue("PART_INDEX", QString::number(parts.count()).toStdString());
+            part->SetValue("ANALYSIS_TYPE", analysisTypeEnum);
+            part->SetValue("COORDINATE_TYPE", coordinateTypeEnum);
+
+            parts[partKey] = part;
+        }
+
+        ctemplate::TemplateDictionary *partExpression = parts[partKey]->AddSectionDictionary("PART_EXPRESSION");
+
+        partExpression->SetValue("EXPRESSION", expressionParsed);
+        partExpression->SetValue("POSITION", QString::number(pos).toStdString());
     }
 }
 
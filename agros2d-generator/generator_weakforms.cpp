@@ -243,10 +243,11 @@ void Agros2DGeneratorModule::generateExtFunction(XMLModule::quantity quantity, A
             dependence = m_parser->parseWeakFormExpression(pmi, dependence);
     }
 
-    // nonlinear or constant (in which case numberFromTable returns just a constant number)
-    QString valueMethod("numberFromTable");
+    // nonlinear or constant (in which case numbersFromTable returns just a constant number)
+    // evaluated for all integration points at once
+    QString valueMethod("numbersFromTable");
     if(derivative)
-        valueMethod = "derivativeFromTable";
+        valueMethod = "derivativesFromTable";
 
     // other dependence
     if(quantity.dependence().present())
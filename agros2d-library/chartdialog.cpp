@@ -53,10 +53,10 @@ QList<Point> ChartLine::getPoints()
     double dy = (end.y - start.y) / (numberOfPoints - 1);
 
     for (int i = 0; i < numberOfPoints; i++)
-        if (reverse)
-            points.insert(0, Point(start.x + i*dx, start.y + i*dy));
-        else
-            points.append(Point(start.x + i*dx, start.y + i*dy));
+    {
+        int j = reverse ? numberOfPoints - 1 - i : i;
+        points.append(Point(start.x + j*dx, start.y + j*dy));
+    }
 
     return points;
 }
@@ -423,31 +423,34 @@ void ChartWidget::plotGeometry()
     {
         if (physicFieldVariable.id() != variable.id()) continue;
 
-        foreach (Point point, points)
+        // all points at once
+        LocalValues *localValues = fieldWidget->selectedField()->plugin()->localValues(fieldWidget->selectedField(),
+                                                                                       fieldWidget->selectedTimeStep(),
+                                                                                       fieldWidget->selectedAdaptivityStep(),
+                                                                                       fieldWidget->selectedAdaptivitySolutionType(),
+                                                                                       points.toVector(),
+                                                                                       QStringList() << variable.id());
+        QVector<LocalPointValue> values = localValues->values(variable.id());
+        values.resize(points.count());
+
+        foreach (LocalPointValue value, values)
         {
-            LocalValue *localValue = fieldWidget->selectedField()->plugin()->localValue(fieldWidget->selectedField(),
-                                                                                        fieldWidget->selectedTimeStep(),
-                                                                                        fieldWidget->selectedAdaptivityStep(),
-                                                                                        fieldWidget->selectedAdaptivitySolutionType(),
-                                                                                        point);
-            QMap<QString, LocalPointValue> values = localValue->values();
-
             if (variable.isScalar())
             {
-                yval.append(values[variable.id()].scalar);
+                yval.append(value.scalar);
             }
             else
             {
                 if (physicFieldVariableComp == PhysicFieldVariableComp_X)
-                    yval.append(values[variable.id()].vector.x);
+                    yval.append(value.vector.x);
                 else if (physicFieldVariableComp == PhysicFieldVariableComp_Y)
-                    yval.append(values[variable.id()].vector.y);
+                    yval.append(value.vector.y);
                 else
-                    yval.append(values[variable.id()].vector.magnitude());
+                    yval.append(value.vector.magnitude());
             }
-
-            delete localValue;
         }
+
+        delete localValues;
     }
 
     assert(xval.count() == yval.count());
@@ -502,26 +505,29 @@ void ChartWidget::plotTime()
 
             Point point(txtTimeX->value(), txtTimeY->value());
             int timeLevelIndex = Agros2D::solutionStore()->nthCalculatedTimeStep(fieldWidget->selectedField(), i);
-            LocalValue *localValue = fieldWidget->selectedField()->plugin()->localValue(fieldWidget->selectedField(),
-                                                                                        timeLevelIndex,
-                                                                                        Agros2D::solutionStore()->lastAdaptiveStep(fieldWidget->selectedField(), SolutionMode_Normal, timeLevelIndex),
-                                                                                        SolutionMode_Normal,
-                                                                                        point);
-            QMap<QString, LocalPointValue> values = localValue->values();
+            // only the plotted variable, element of the initial mesh is found by the cached locator
+            LocalValues *localValues = fieldWidget->selectedField()->plugin()->localValues(fieldWidget->selectedField(),
+                                                                                           timeLevelIndex,
+                                                                                           Agros2D::solutionStore()->lastAdaptiveStep(fieldWidget->selectedField(), SolutionMode_Normal, timeLevelIndex),
+                                                                                           SolutionMode_Normal,
+                                                                                           QVector<Point>() << point,
+                                                                                           QStringList() << variable.id());
+            QVector<LocalPointValue> values = localValues->values(variable.id());
+            LocalPointValue value = values.isEmpty() ? LocalPointValue() : values.first();
 
             if (variable.isScalar())
-                yval.append(values[variable.id()].scalar);
+                yval.append(value.scalar);
             else
             {
                 if (physicFieldVariableComp == PhysicFieldVariableComp_X)
-                    yval.append(values[variable.id()].vector.x);
+                    yval.append(value.vector.x);
                 else if (physicFieldVariableComp == PhysicFieldVariableComp_Y)
-                    yval.append(values[variable.id()].vector.y);
+                    yval.append(value.vector.y);
                 else
-                    yval.append(values[variable.id()].vector.magnitude());
+                    yval.append(value.vector.magnitude());
             }
 
-            delete localValue;
+            delete localValues;
         }
     }
 
@@ -672,18 +678,10 @@ void ChartWidget::doExportData()
                                              Point(txtEndX->value(), txtEndY->value()),
                                              txtHorizontalAxisPoints->value());
 
-        foreach (Point point, chartLine->getPoints())
-        {
-            QMap<QString, double> data = getData(point,
-                                                 fieldWidget->selectedTimeStep(),
-                                                 fieldWidget->selectedAdaptivityStep(),
-                                                 fieldWidget->selectedAdaptivitySolutionType());
-            foreach (QString key, data.keys())
-            {
-                QList<double> *values = &table.operator [](key);
-                values->append(data.value(key));
-            }
-        }
+        table = getData(chartLine->getPoints(),
+                        fieldWidget->selectedTimeStep(),
+                        fieldWidget->selectedAdaptivityStep(),
+                        fieldWidget->selectedAdaptivitySolutionType());
 
         delete chartLine;
     }
@@ -693,10 +691,10 @@ void ChartWidget::doExportData()
         foreach (double timeLevel, Agros2D::solutionStore()->timeLevels(fieldWidget->selectedField()))
         {
             int timeStep = Agros2D::solutionStore()->timeLevelIndex(fieldWidget->selectedField(), timeLevel);
-            QMap<QString, double> data = getData(point,
-                                                 timeStep,
-                                                 Agros2D::solutionStore()->lastAdaptiveStep(fieldWidget->selectedField(), SolutionMode_Normal, timeStep),
-                                                 SolutionMode_Normal);
+            QMap<QString, QList<double> > data = getData(QList<Point>() << point,
+                                                         timeStep,
+                                                         Agros2D::solutionStore()->lastAdaptiveStep(fieldWidget->selectedField(), SolutionMode_Normal, timeStep),
+                                                         SolutionMode_Normal);
             foreach (QString key, data.keys())
             {
                 QList<double> *values = &table.operator [](key);
@@ -757,36 +755,46 @@ void ChartWidget::doSaveImage()
     m_chart->chart()->savePng(fileName, 1024, 768);
 }
 
-QMap<QString, double> ChartWidget::getData(Point point, int timeStep, int adaptivityStep, SolutionMode solutionType)
+QMap<QString, QList<double> > ChartWidget::getData(const QList<Point> &points, int timeStep, int adaptivityStep, SolutionMode solutionType)
 {
-    QMap<QString, double> table;
+    QMap<QString, QList<double> > table;
+
+    // all variables in all points at once
+    LocalValues *localValues = fieldWidget->selectedField()->plugin()->localValues(fieldWidget->selectedField(),
+                                                                                   timeStep,
+                                                                                   adaptivityStep,
+                                                                                   solutionType,
+                                                                                   points.toVector());
 
     foreach (Module::LocalVariable variable, fieldWidget->selectedField()->localPointVariables())
     {
-        LocalValue *localValue = fieldWidget->selectedField()->plugin()->localValue(fieldWidget->selectedField(),
-                                                                                    timeStep,
-                                                                                    adaptivityStep,
-                                                                                    solutionType,
-                                                                                    point);
-        QMap<QString, LocalPointValue> values = localValue->values();
+        QVector<LocalPointValue> values = localValues->values(variable.id());
+        values.resize(points.count());
 
-        if (variable.isScalar())
-        {
-            table.insert(variable.shortname(), values[variable.id()].scalar);
-        }
-        else
+        foreach (LocalPointValue value, values)
         {
-            table.insert(QString(variable.shortname()), values[variable.id()].vector.magnitude());
-            table.insert(QString(variable.shortname() + "x"), values[variable.id()].vector.x);
-            table.insert(QString(variable.shortname() + "y"), values[variable.id()].vector.y);
+            if (variable.isScalar())
+            {
+                table[variable.shortname()].append(value.scalar);
+            }
+            else
+            {
+                table[variable.shortname()].append(value.vector.magnitude());
+                table[variable.shortname() + "x"].append(value.vector.x);
+                table[variable.shortname() + "y"].append(value.vector.y);
+            }
         }
-
-        delete localValue;
     }
 
-    table.insert(Agros2D::problem()->config()->labelX(), point.x);
-    table.insert(Agros2D::problem()->config()->labelY(), point.y);
-    table.insert("t", Agros2D::solutionStore()->timeLevel(fieldWidget->selectedField(), timeStep));
+    delete localValues;
+
+    double time = Agros2D::solutionStore()->timeLevel(fieldWidget->selectedField(), timeStep);
+    foreach (Point point, points)
+    {
+        table[Agros2D::problem()->config()->labelX()].append(point.x);
+        table[Agros2D::problem()->config()->labelY()].append(point.y);
+        table["t"].append(time);
+    }
 
     return table;
 }
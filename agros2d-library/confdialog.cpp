@@ -69,7 +69,8 @@ void ConfigComputerDialog::load()
     txtNumOfThreads->setValue(Agros2D::configComputer()->value(Config::Config_NumberOfThreads).toInt());
 
     // cache size
-    txtCacheSize->setValue(Agros2D::configComputer()->value(Config::Config_CacheSize).toInt());
+    txtCacheSize->setValue(Agros2D::configComputer()->value(Config::Config_CacheMemorySize).toInt());
+    txtPostCacheSize->setValue(Agros2D::configComputer()->value(Config::Config_PostCacheMemorySize).toInt());
 
     // std log
     chkLogStdOut->setChecked(Agros2D::configComputer()->value(Config::Config_LogStdOut).toBool());
@@ -109,7 +110,8 @@ void ConfigComputerDialog::save()
     Agros2D::configComputer()->setValue(Config::Config_NumberOfThreads, txtNumOfThreads->value());
 
     // cache size
-    Agros2D::configComputer()->setValue(Config::Config_CacheSize, txtCacheSize->value());
+    Agros2D::configComputer()->setValue(Config::Config_CacheMemorySize, txtCacheSize->value());
+    Agros2D::configComputer()->setValue(Config::Config_PostCacheMemorySize, txtPostCacheSize->value());
 
     // std log
     Agros2D::configComputer()->setValue(Config::Config_LogStdOut, chkLogStdOut->isChecked());
@@ -268,8 +270,14 @@ QWidget *ConfigComputerDialog::createSolverWidget()
 {
     // general
     txtCacheSize = new QSpinBox(this);
-    txtCacheSize->setMinimum(2);
-    txtCacheSize->setMaximum(50);
+    txtCacheSize->setMinimum(64);
+    txtCacheSize->setMaximum(65536);
+    txtCacheSize->setSingleStep(64);
+
+    txtPostCacheSize = new QSpinBox(this);
+    txtPostCacheSize->setMinimum(0);
+    txtPostCacheSize->setMaximum(65536);
+    txtPostCacheSize->setSingleStep(64);
 
     txtNumOfThreads = new QSpinBox(this);
     txtNumOfThreads->setMinimum(1);
@@ -278,8 +286,10 @@ QWidget *ConfigComputerDialog::createSolverWidget()
     QGridLayout *layoutSolver = new QGridLayout();
     layoutSolver->addWidget(new QLabel(tr("Number of threads:")), 0, 0);
     layoutSolver->addWidget(txtNumOfThreads, 0, 1);
-    layoutSolver->addWidget(new QLabel(tr("Number of cache slots:")), 1, 0);
+    layoutSolver->addWidget(new QLabel(tr("Cache size (MB):")), 1, 0);
     layoutSolver->addWidget(txtCacheSize, 1, 1);
+    layoutSolver->addWidget(new QLabel(tr("Postprocessor cache size (MB):")), 2, 0);
+    layoutSolver->addWidget(txtPostCacheSize, 2, 1);
 
     QGroupBox *grpSolver = new QGroupBox(tr("Solver"));
     grpSolver->setLayout(layoutSolver);
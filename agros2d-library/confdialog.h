@@ -63,6 +63,7 @@ private:
 
     // cache
     QSpinBox *txtCacheSize;
+    QSpinBox *txtPostCacheSize;
 
     // threads
     QSpinBox *txtNumOfThreads;
@@ -19,6 +19,14 @@
 
 #include "datatable.h"
 
+// relative tolerance (to the maximal absolute value and derivative) of the spline resampled on uniform grid
+const double UNIFORM_SPLINE_TOLERANCE = 1e-6;
+// number of intervals of the resampled spline
+const int UNIFORM_SPLINE_MIN_SIZE = 64;
+const int UNIFORM_SPLINE_MAX_SIZE = 4096;
+// maximal number of buckets of piecewise linear table
+const int PIECEWISE_LINEAR_MAX_BUCKETS = 4096;
+
 DataTable::DataTable() : m_valid(false)
 {
     setImplicit();
@@ -42,15 +50,30 @@ DataTable &DataTable::operator =(const DataTable &origin)
     m_type = origin.m_type;
     m_splineFirstDerivatives = origin.m_splineFirstDerivatives;
     m_extrapolateConstant = origin.m_extrapolateConstant;
+    m_uniformResampling = origin.m_uniformResampling;
 
     m_spline = QSharedPointer<Hermes::Hermes2D::CubicSpline>();
+    m_uniformSpline = QSharedPointer<UniformSpline>();
     m_linear = QSharedPointer<PiecewiseLinear>();
     m_constant = QSharedPointer<ConstantTable>();
 
     m_numPoints = origin.m_numPoints;
     m_isEmpty = origin.m_isEmpty;
 
-    validate();
+    // approximations are not modified after validation, copies share them
+    if (origin.m_valid)
+    {
+        m_spline = origin.m_spline;
+        m_uniformSpline = origin.m_uniformSpline;
+        m_linear = origin.m_linear;
+        m_constant = origin.m_constant;
+
+        m_valid = true;
+    }
+    else
+    {
+        validate();
+    }
 
     return *this;
 }
@@ -152,15 +175,24 @@ void DataTable::setExtrapolateConstant(bool ec)
     validate();
 }
 
+void DataTable::setUniformResampling(bool ur)
+{
+    inValidate();
+    m_uniformResampling = ur;
+    validate();
+}
+
 
 void DataTable::setImplicit()
 {
     m_spline.clear();
+    m_uniformSpline.clear();
     m_linear.clear();
     m_constant.clear();
     m_type = DataTableType_PiecewiseLinear;
     m_splineFirstDerivatives = true;
     m_extrapolateConstant = true;
+    m_uniformResampling = false;
     m_valid = false;
     m_numPoints = 0;
     m_isEmpty = true;
@@ -176,7 +208,7 @@ double DataTable::value(double x) const
     }
     else if (m_type == DataTableType_CubicSpline)
     {
-        return m_spline.data()->value(x);
+        return splineValue(x);
     }
     else if (m_type == DataTableType_Constant)
     {
@@ -196,7 +228,7 @@ double DataTable::derivative(double x) const
     }
     else if (m_type == DataTableType_CubicSpline)
     {
-        return m_spline.data()->derivative(x);
+        return splineDerivative(x);
     }
     else if (m_type == DataTableType_Constant)
     {
@@ -206,6 +238,56 @@ double DataTable::derivative(double x) const
         assert(0);
 }
 
+void DataTable::values(const double *x, double *values, int count) const
+{
+    assert(m_valid);
+
+    if (m_type == DataTableType_PiecewiseLinear)
+    {
+        PiecewiseLinear *linear = m_linear.data();
+        for (int i = 0; i < count; i++)
+            values[i] = linear->value(x[i]);
+    }
+    else if (m_type == DataTableType_CubicSpline)
+    {
+        for (int i = 0; i < count; i++)
+            values[i] = splineValue(x[i]);
+    }
+    else if (m_type == DataTableType_Constant)
+    {
+        ConstantTable *constant = m_constant.data();
+        for (int i = 0; i < count; i++)
+            values[i] = constant->value(x[i]);
+    }
+    else
+        assert(0);
+}
+
+void DataTable::derivatives(const double *x, double *derivatives, int count) const
+{
+    assert(m_valid);
+
+    if (m_type == DataTableType_PiecewiseLinear)
+    {
+        PiecewiseLinear *linear = m_linear.data();
+        for (int i = 0; i < count; i++)
+            derivatives[i] = linear->derivative(x[i]);
+    }
+    else if (m_type == DataTableType_CubicSpline)
+    {
+        for (int i = 0; i < count; i++)
+            derivatives[i] = splineDerivative(x[i]);
+    }
+    else if (m_type == DataTableType_Constant)
+    {
+        ConstantTable *constant = m_constant.data();
+        for (int i = 0; i < count; i++)
+            derivatives[i] = constant->derivative(x[i]);
+    }
+    else
+        assert(0);
+}
+
 void DataTable::inValidate()
 {
     m_valid = false;
@@ -214,6 +296,7 @@ void DataTable::inValidate()
 
     m_linear.clear();
     m_spline.clear();
+    m_uniformSpline.clear();
     m_constant.clear();
 }
 
@@ -225,6 +308,7 @@ void DataTable::validate()
 
     assert(m_linear.isNull());
     assert(m_spline.isNull());
+    assert(m_uniformSpline.isNull());
     assert(m_constant.isNull());
     assert(!m_valid);
 
@@ -250,6 +334,15 @@ void DataTable::validate()
                                                                                                       m_splineFirstDerivatives, m_splineFirstDerivatives,
                                                                                                       !m_extrapolateConstant, !m_extrapolateConstant));
             spline.data()->calculate_coeffs();
+
+            // resampled spline (opt-in) is used only if its values and derivatives are accurate enough
+            if (m_uniformResampling)
+            {
+                QSharedPointer<UniformSpline> uniformSpline(new UniformSpline(spline.data(), minKey(), maxKey(), UNIFORM_SPLINE_TOLERANCE));
+                if (uniformSpline->isValid())
+                    m_uniformSpline = uniformSpline;
+            }
+
             m_spline = spline;
         }
         catch (Hermes::Exceptions::Exception e)
@@ -349,6 +442,8 @@ QString DataTable::toStringSetting() const
     str += QString::number(int(m_splineFirstDerivatives));
     str += ",";
     str += QString::number(int(m_extrapolateConstant));
+    str += ",";
+    str += QString::number(int(m_uniformResampling));
     // todo: add more settings here, separated by comas
 
     return str;
@@ -366,6 +461,9 @@ void DataTable::propertiesFromString(const QString &str)
     if(lst.size() >= 3)
         m_extrapolateConstant = lst.at(2).toInt();
 
+    if(lst.size() >= 4)
+        m_uniformResampling = lst.at(3).toInt();
+
     // todo: read more settings here
 }
 
@@ -431,9 +529,40 @@ PiecewiseLinear::PiecewiseLinear(Hermes::vector<double> points, Hermes::vector<d
     {
         m_derivatives.push_back((m_values[i+1] - m_values[i]) / (m_points[i+1] - m_points[i]));
     }
+
+    // uniform buckets
+    m_bucketCount = 0;
+    m_bucketStepInverse = 0.0;
+    if ((m_size > 2) && (m_points.back() > m_points.front()))
+    {
+        m_bucketCount = qMin(2 * m_size, PIECEWISE_LINEAR_MAX_BUCKETS);
+        m_bucketStepInverse = m_bucketCount / (m_points.back() - m_points.front());
+
+        m_buckets.resize(m_bucketCount + 1);
+        for (int k = 0; k <= m_bucketCount; k++)
+            m_buckets[k] = leftIndexBisection(m_points.front() + k / m_bucketStepInverse);
+    }
 }
 
 int PiecewiseLinear::leftIndex(double x)
+{
+    if (m_bucketCount == 0)
+        return leftIndexBisection(x);
+
+    // start of the bucket and linear search (same result as bisection)
+    int k = qBound(0, (int) ((x - m_points.front()) * m_bucketStepInverse), m_bucketCount);
+    int i = m_buckets[k];
+
+    // bucket boundary can be rounded above x
+    while ((i > 0) && !(m_points[i] < x))
+        i--;
+    while ((i + 2 < m_size) && (m_points[i + 1] < x))
+        i++;
+
+    return i;
+}
+
+int PiecewiseLinear::leftIndexBisection(double x)
 {
     // slower implementation
     //
@@ -494,6 +623,91 @@ double PiecewiseLinear::derivative(double x)
     }
 }
 
+UniformSpline::UniformSpline(Hermes::Hermes2D::CubicSpline *spline, double min, double max, double relativeTolerance)
+    : m_min(min), m_max(max), m_step(0.0), m_stepInverse(0.0), m_size(0), m_isValid(false)
+{
+    if (!(max > min))
+        return;
+
+    // refine grid until the error in intervals is within tolerance
+    for (int size = UNIFORM_SPLINE_MIN_SIZE; size <= UNIFORM_SPLINE_MAX_SIZE; size *= 2)
+    {
+        m_size = size;
+        m_step = (max - min) / size;
+        m_stepInverse = size / (max - min);
+
+        m_values.resize(size + 1);
+        m_derivatives.resize(size + 1);
+        double maxValue = 0.0;
+        double maxDerivative = 0.0;
+        for (int i = 0; i <= size; i++)
+        {
+            double x = (i < size) ? min + i * m_step : max;
+            m_values[i] = spline->value(x);
+            m_derivatives[i] = spline->derivative(x);
+
+            maxValue = qMax(maxValue, fabs(m_values[i]));
+            maxDerivative = qMax(maxDerivative, fabs(m_derivatives[i]));
+        }
+
+        // derivatives are used in Jacobian (Newton method), they have to be checked as well
+        double valueTolerance = relativeTolerance * maxValue;
+        double derivativeTolerance = relativeTolerance * maxDerivative;
+
+        bool accurate = true;
+        for (int i = 0; i < size && accurate; i++)
+        {
+            for (int j = 1; j <= 3; j++)
+            {
+                double x = min + (i + 0.25 * j) * m_step;
+                if ((fabs(value(x) - spline->value(x)) > valueTolerance)
+                        || (fabs(derivative(x) - spline->derivative(x)) > derivativeTolerance))
+                {
+                    accurate = false;
+                    break;
+                }
+            }
+        }
+
+        if (accurate)
+        {
+            m_isValid = true;
+            return;
+        }
+    }
+
+    m_values.clear();
+    m_derivatives.clear();
+}
+
+double UniformSpline::value(double x) const
+{
+    double position = (x - m_min) * m_stepInverse;
+    int i = qBound(0, (int) position, m_size - 1);
+    double t = position - i;
+
+    double t2 = t * t;
+    double t3 = t2 * t;
+
+    return (2.0 * t3 - 3.0 * t2 + 1.0) * m_values[i]
+            + (t3 - 2.0 * t2 + t) * m_step * m_derivatives[i]
+            + (- 2.0 * t3 + 3.0 * t2) * m_values[i + 1]
+            + (t3 - t2) * m_step * m_derivatives[i + 1];
+}
+
+double UniformSpline::derivative(double x) const
+{
+    double position = (x - m_min) * m_stepInverse;
+    int i = qBound(0, (int) position, m_size - 1);
+    double t = position - i;
+
+    double t2 = t * t;
+
+    return (6.0 * t2 - 6.0 * t) * (m_values[i] - m_values[i + 1]) * m_stepInverse
+            + (3.0 * t2 - 4.0 * t + 1.0) * m_derivatives[i]
+            + (3.0 * t2 - 2.0 * t) * m_derivatives[i + 1];
+}
+
 /*
 void test()
 {
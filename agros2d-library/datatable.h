@@ -33,12 +33,46 @@ public:
 
 private:
     int leftIndex(double x);
+    int leftIndexBisection(double x);
 
     Hermes::vector<double> m_points;
     Hermes::vector<double> m_values;
 
     Hermes::vector<double> m_derivatives;
     int m_size;
+
+    // left index of the start of uniform buckets (interval is found in O(1))
+    std::vector<int> m_buckets;
+    int m_bucketCount;
+    double m_bucketStepInverse;
+};
+
+// cubic spline resampled on uniform grid (cubic Hermite interpolation of values and derivatives in nodes)
+// O(1) evaluation inside of the table, valid only if the resampling error of values and derivatives
+// is within relative tolerance
+class UniformSpline
+{
+public:
+    UniformSpline(Hermes::Hermes2D::CubicSpline *spline, double min, double max, double relativeTolerance);
+
+    inline bool isValid() const { return m_isValid; }
+    inline bool contains(double x) const { return (x >= m_min) && (x <= m_max); }
+
+    double value(double x) const;
+    double derivative(double x) const;
+
+private:
+    double m_min;
+    double m_max;
+    double m_step;
+    double m_stepInverse;
+    // number of intervals
+    int m_size;
+
+    std::vector<double> m_values;
+    std::vector<double> m_derivatives;
+
+    bool m_isValid;
 };
 
 // for testing.. returns average value. Simple "linearization" of the problem
@@ -68,14 +102,22 @@ public:
     void setType(DataTableType type);
     void setSplineFirstDerivatives(bool fd);
     void setExtrapolateConstant(bool ec);
+    // cubic spline is resampled on uniform grid (faster, values slightly differ), disabled by default
+    void setUniformResampling(bool ur);
 
     double value(double x) const;
     double derivative(double x) const;
+
+    // values (derivatives) at count keys (e.g. all integration points of element), values can overwrite keys
+    void values(const double *x, double *values, int count) const;
+    void derivatives(const double *x, double *derivatives, int count) const;
+
     inline int size() const { return m_numPoints; }
     inline bool isEmpty() const {return m_isEmpty; }
     DataTableType type() const {return m_type;}
     bool splineFirstDerivatives() const {return m_splineFirstDerivatives; }
     bool extrapolateConstant() const {return m_extrapolateConstant; }
+    bool uniformResampling() const {return m_uniformResampling; }
 
     void clear();
 
@@ -110,11 +152,29 @@ private:
     DataTableType m_type;
     bool m_splineFirstDerivatives;
     bool m_extrapolateConstant;
+    bool m_uniformResampling;
 
     QSharedPointer<Hermes::Hermes2D::CubicSpline> m_spline;
+    QSharedPointer<UniformSpline> m_uniformSpline;
     QSharedPointer<PiecewiseLinear> m_linear;
     QSharedPointer<ConstantTable> m_constant;
 
+    inline double splineValue(double x) const
+    {
+        if (!m_uniformSpline.isNull() && m_uniformSpline->contains(x))
+            return m_uniformSpline->value(x);
+        else
+            return m_spline.data()->value(x);
+    }
+
+    inline double splineDerivative(double x) const
+    {
+        if (!m_uniformSpline.isNull() && m_uniformSpline->contains(x))
+            return m_uniformSpline->derivative(x);
+        else
+            return m_spline.data()->derivative(x);
+    }
+
     // efficiency reasons
     int m_numPoints;
     bool m_isEmpty;
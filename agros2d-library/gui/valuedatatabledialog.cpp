@@ -248,6 +248,10 @@ void ValueDataTableDialog::createControls()
     connect(radExtrapolateConstant, SIGNAL(clicked()), this, SLOT(doExtrapolateChanged()));
     connect(radExtrapolateLinear, SIGNAL(clicked()), this, SLOT(doExtrapolateChanged()));
 
+    chkUniformResampling = new QCheckBox(tr("Resample on uniform grid (faster)"));
+    chkUniformResampling->setChecked(m_table.uniformResampling());
+    connect(chkUniformResampling, SIGNAL(clicked()), this, SLOT(doUniformResamplingChanged()));
+
     QVBoxLayout *layoutView = new QVBoxLayout();
     layoutView->addWidget(chkMarkers);
     layoutView->addWidget(chkDerivative);
@@ -268,6 +272,7 @@ void ValueDataTableDialog::createControls()
     layoutInterpolation->addWidget(new QLabel(tr("Extrapolate as")), 2, 0, 1, 2);
     layoutInterpolation->addWidget(radExtrapolateConstant, 3, 0, 1, 1);
     layoutInterpolation->addWidget(radExtrapolateLinear, 3, 1, 1, 1);
+    layoutInterpolation->addWidget(chkUniformResampling, 4, 0, 1, 2);
 
     grpInterpolation = new QGroupBox(tr("Spline properties"));
     grpInterpolation->setLayout(layoutInterpolation);
@@ -475,6 +480,12 @@ void ValueDataTableDialog::doExtrapolateChanged()
     doPlot();
 }
 
+void ValueDataTableDialog::doUniformResamplingChanged()
+{
+    m_table.setUniformResampling(chkUniformResampling->isChecked());
+    doPlot();
+}
+
 void ValueDataTableDialog::doMaterialBrowser()
 {
     MaterialBrowserDialog materialBrowserDialog(this);
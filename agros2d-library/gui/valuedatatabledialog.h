@@ -69,6 +69,7 @@ private:
     QRadioButton *radSecondDerivative;
     QRadioButton *radExtrapolateConstant;
     QRadioButton *radExtrapolateLinear;
+    QCheckBox *chkUniformResampling;
 
     QPushButton *btnOk;
     QPushButton *btnClose;
@@ -96,6 +97,7 @@ private slots:
     void doTypeChanged();
     void doSplineDerivativeChanged();
     void doExtrapolateChanged();
+    void doUniformResamplingChanged();
 };
 
 #endif // DATATABLEDIALOG_H
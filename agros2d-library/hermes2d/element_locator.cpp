@@ -0,0 +1,246 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "element_locator.h"
+
+// maximal number of cells in one direction
+const int ELEMENT_LOCATOR_MAX_CELLS = 1024;
+// crowded cell is divided by nested grid
+const int ELEMENT_LOCATOR_MAX_CELL_ELEMENTS = 16;
+// maximal number of cells of nested grid in one direction
+const int ELEMENT_LOCATOR_MAX_NESTED_CELLS = 32;
+// maximal level of nested grids
+const int ELEMENT_LOCATOR_MAX_DEPTH = 2;
+
+ElementLocator::ElementLocator(Hermes::Hermes2D::MeshSharedPtr mesh, double minimalArcRadius)
+    : m_mesh(mesh)
+{
+    Point min( numeric_limits<double>::max(),  numeric_limits<double>::max());
+    Point max(-numeric_limits<double>::max(), -numeric_limits<double>::max());
+
+    Hermes::Hermes2D::Element *e;
+    for_all_active_elements(e, m_mesh)
+    {
+        RectPoint box = elementBoundingBox(e, minimalArcRadius);
+
+        min.x = qMin(min.x, box.start.x);
+        min.y = qMin(min.y, box.start.y);
+        max.x = qMax(max.x, box.end.x);
+        max.y = qMax(max.y, box.end.y);
+
+        m_elements.append(e);
+        m_boxes.append(box);
+    }
+
+    if (m_elements.isEmpty())
+        return;
+
+    // boxes are slightly enlarged (points on edges)
+    double tolerance = qMax(max.x - min.x, max.y - min.y) * EPS_ZERO;
+    for (int k = 0; k < m_boxes.count(); k++)
+        m_boxes[k] = RectPoint(Point(m_boxes[k].start.x - tolerance, m_boxes[k].start.y - tolerance),
+                               Point(m_boxes[k].end.x + tolerance, m_boxes[k].end.y + tolerance));
+
+    m_min = Point(min.x - tolerance, min.y - tolerance);
+    m_max = Point(max.x + tolerance, max.y + tolerance);
+
+    QVector<int> elements(m_elements.count());
+    for (int k = 0; k < elements.count(); k++)
+        elements[k] = k;
+
+    fillGrid(addGrid(m_min, m_max, m_elements.count(), ELEMENT_LOCATOR_MAX_CELLS), elements, 0);
+}
+
+int ElementLocator::addGrid(const Point &min, const Point &max, int count, int maxCells)
+{
+    // about one element per cell
+    double width = max.x - min.x;
+    double height = max.y - min.y;
+    double minimalCellSize = qMax(width, height) / maxCells;
+    if (minimalCellSize < EPS_ZERO)
+        minimalCellSize = EPS_ZERO;
+
+    Grid grid;
+    grid.min = min;
+    grid.cellSize = qMax(sqrt(qMax(width, minimalCellSize) * qMax(height, minimalCellSize) / qMax(count, 1)), minimalCellSize);
+    grid.nx = qMin(maxCells, (int) (width / grid.cellSize) + 1);
+    grid.ny = qMin(maxCells, (int) (height / grid.cellSize) + 1);
+    grid.offset = m_cells.count();
+
+    m_cells.resize(m_cells.count() + grid.nx * grid.ny);
+    m_grids.append(grid);
+
+    return m_grids.count() - 1;
+}
+
+void ElementLocator::fillGrid(int gridIndex, const QVector<int> &elements, int depth)
+{
+    // copy (nested grids are appended)
+    Grid grid = m_grids[gridIndex];
+
+    foreach (int k, elements)
+    {
+        const RectPoint &box = m_boxes[k];
+
+        int i0 = qBound(0, (int) floor((box.start.x - grid.min.x) / grid.cellSize), grid.nx - 1);
+        int i1 = qBound(0, (int) floor((box.end.x - grid.min.x) / grid.cellSize), grid.nx - 1);
+        int j0 = qBound(0, (int) floor((box.start.y - grid.min.y) / grid.cellSize), grid.ny - 1);
+        int j1 = qBound(0, (int) floor((box.end.y - grid.min.y) / grid.cellSize), grid.ny - 1);
+
+        for (int j = j0; j <= j1; j++)
+            for (int i = i0; i <= i1; i++)
+                m_cells[grid.offset + j * grid.nx + i].elements.append(k);
+    }
+
+    if (depth >= ELEMENT_LOCATOR_MAX_DEPTH)
+        return;
+
+    // divide crowded cells
+    for (int j = 0; j < grid.ny; j++)
+    {
+        for (int i = 0; i < grid.nx; i++)
+        {
+            int c = grid.offset + j * grid.nx + i;
+            if (m_cells[c].elements.count() <= ELEMENT_LOCATOR_MAX_CELL_ELEMENTS)
+                continue;
+
+            Point cellMin(grid.min.x + i * grid.cellSize, grid.min.y + j * grid.cellSize);
+            Point cellMax(cellMin.x + grid.cellSize, cellMin.y + grid.cellSize);
+
+            // elements covering the whole cell would be in all nested cells
+            int covering = 0;
+            foreach (int k, m_cells[c].elements)
+                if (m_boxes[k].start.x <= cellMin.x && m_boxes[k].end.x >= cellMax.x
+                        && m_boxes[k].start.y <= cellMin.y && m_boxes[k].end.y >= cellMax.y)
+                    covering++;
+            if (covering > ELEMENT_LOCATOR_MAX_CELL_ELEMENTS / 2)
+                continue;
+
+            QVector<int> cellElements = m_cells[c].elements;
+            int nestedCells = qMin(ELEMENT_LOCATOR_MAX_NESTED_CELLS, (int) ceil(sqrt((double) cellElements.count())));
+
+            int nested = addGrid(cellMin, cellMax, cellElements.count(), nestedCells);
+            m_cells[c].grid = nested;
+            m_cells[c].elements.clear();
+
+            fillGrid(nested, cellElements, depth + 1);
+        }
+    }
+}
+
+QVector<Hermes::Hermes2D::Element *> ElementLocator::elements(const QVector<Point> &points) const
+{
+    QVector<Hermes::Hermes2D::Element *> result(points.size(), NULL);
+
+    Hermes::Hermes2D::Element *hint = NULL;
+    for (int i = 0; i < points.size(); i++)
+    {
+        result[i] = element(points[i].x, points[i].y, hint);
+        // keep the last element inside of the mesh (line can cross holes)
+        if (result[i])
+            hint = result[i];
+    }
+
+    return result;
+}
+
+RectPoint ElementLocator::elementBoundingBox(Hermes::Hermes2D::Element *element, double minimalArcRadius)
+{
+    Point min(element->vn[0]->x, element->vn[0]->y);
+    Point max = min;
+
+    for (int i = 1; i < element->get_nvert(); i++)
+    {
+        min.x = qMin(min.x, element->vn[i]->x);
+        min.y = qMin(min.y, element->vn[i]->y);
+        max.x = qMax(max.x, element->vn[i]->x);
+        max.y = qMax(max.y, element->vn[i]->y);
+    }
+
+    if (element->is_curved())
+    {
+        double bulge = 0.0;
+        if (minimalArcRadius > 0.0)
+        {
+            // sagitta of the longest chord (decreases with radius)
+            for (int i = 0; i < element->get_nvert(); i++)
+            {
+                Hermes::Hermes2D::Node *start = element->vn[i];
+                Hermes::Hermes2D::Node *end = element->vn[(i + 1) % element->get_nvert()];
+
+                double halfChord = (Point(end->x, end->y) - Point(start->x, start->y)).magnitude() / 2.0;
+                double radius = qMax(minimalArcRadius, halfChord);
+
+                bulge = qMax(bulge, radius - sqrt(radius * radius - halfChord * halfChord));
+            }
+        }
+        else
+        {
+            // curved edges can bulge out of the box of vertices
+            bulge = qMax(max.x - min.x, max.y - min.y);
+        }
+
+        min = Point(min.x - bulge, min.y - bulge);
+        max = Point(max.x + bulge, max.y + bulge);
+    }
+
+    return RectPoint(min, max);
+}
+
+Hermes::Hermes2D::Element *ElementLocator::element(double x, double y, Hermes::Hermes2D::Element *hint) const
+{
+    if (m_grids.isEmpty())
+        return NULL;
+
+    double xRef, yRef;
+    if (hint)
+    {
+        if (Hermes::Hermes2D::RefMap::is_element_on_physical_coordinates(hint, x, y, &xRef, &yRef))
+            return hint;
+
+        // walk to neighbour (neighbours across refined edges are not active)
+        for (int i = 0; i < hint->get_nvert(); i++)
+        {
+            Hermes::Hermes2D::Element *neighbor = hint->get_neighbor(i);
+            if (neighbor && neighbor->active
+                    && Hermes::Hermes2D::RefMap::is_element_on_physical_coordinates(neighbor, x, y, &xRef, &yRef))
+                return neighbor;
+        }
+    }
+
+    if (x < m_min.x || x > m_max.x || y < m_min.y || y > m_max.y)
+        return NULL;
+
+    int c = cellIndex(m_grids[0], x, y);
+    while (m_cells[c].grid != -1)
+        c = cellIndex(m_grids[m_cells[c].grid], x, y);
+
+    // inverse mapping is tested only for boxes containing the point
+    foreach (int k, m_cells[c].elements)
+    {
+        const RectPoint &box = m_boxes[k];
+        if (x < box.start.x || x > box.end.x || y < box.start.y || y > box.end.y)
+            continue;
+
+        if (Hermes::Hermes2D::RefMap::is_element_on_physical_coordinates(m_elements[k], x, y, &xRef, &yRef))
+            return m_elements[k];
+    }
+
+    return NULL;
+}
@@ -0,0 +1,92 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef ELEMENT_LOCATOR_H
+#define ELEMENT_LOCATOR_H
+
+#include "util.h"
+#include "hermes2d.h"
+
+// grid over bounding boxes of active elements of the mesh, finds element containing point
+// built once per mesh and reused for many points (local values, charts, particle tracing)
+// grid is sized to the mesh (about one element per cell), crowded cells of graded meshes are divided by nested grids
+class AGROS_LIBRARY_API ElementLocator
+{
+public:
+    // minimalArcRadius - smallest radius of arcs in the geometry (see elementBoundingBox)
+    ElementLocator(Hermes::Hermes2D::MeshSharedPtr mesh, double minimalArcRadius);
+
+    // element containing point or NULL (point outside of the mesh)
+    // hint (element of the previous point) and its neighbours are tested first,
+    // consecutive points along a line walk the mesh element to element
+    Hermes::Hermes2D::Element *element(double x, double y, Hermes::Hermes2D::Element *hint = NULL) const;
+
+    // elements of points ordered along a line (hint is the element of the previous point)
+    QVector<Hermes::Hermes2D::Element *> elements(const QVector<Point> &points) const;
+
+    inline Hermes::Hermes2D::MeshSharedPtr mesh() const { return m_mesh; }
+
+    // smallest box containing element, curved edges lie on arcs of the geometry (radius at least minimalArcRadius)
+    // and are enlarged by the sagitta of their chord (minimalArcRadius <= 0 - unknown arcs, enlarged by the diagonal)
+    static RectPoint elementBoundingBox(Hermes::Hermes2D::Element *element, double minimalArcRadius);
+
+private:
+    struct Grid
+    {
+        Point min;
+        double cellSize;
+        int nx;
+        int ny;
+        // first cell in m_cells
+        int offset;
+    };
+
+    struct Cell
+    {
+        Cell() : grid(-1) {}
+
+        // nested grid or -1
+        int grid;
+        // indices of elements
+        QVector<int> elements;
+    };
+
+    Hermes::Hermes2D::MeshSharedPtr m_mesh;
+
+    Point m_min;
+    Point m_max;
+
+    QVector<Hermes::Hermes2D::Element *> m_elements;
+    QVector<RectPoint> m_boxes;
+
+    QVector<Grid> m_grids;
+    QVector<Cell> m_cells;
+
+    int addGrid(const Point &min, const Point &max, int count, int maxCells);
+    void fillGrid(int grid, const QVector<int> &elements, int depth);
+    inline int cellIndex(const Grid &grid, double x, double y) const
+    {
+        int i = qBound(0, (int) floor((x - grid.min.x) / grid.cellSize), grid.nx - 1);
+        int j = qBound(0, (int) floor((y - grid.min.y) / grid.cellSize), grid.ny - 1);
+
+        return grid.offset + j * grid.nx + i;
+    }
+};
+
+#endif // ELEMENT_LOCATOR_H
@@ -24,7 +24,9 @@
 #include "hermes2d/problem_config.h"
 #include "scene.h"
 #include "scenemarker.h"
+#include "sceneedge.h"
 #include "module.h"
+#include "element_locator.h"
 #include "plugin_interface.h"
 #include "logview.h"
 
@@ -50,7 +52,8 @@ bool Field::solveInitVariables()
 int FieldInfo::numberIdNext = 0;
 
 FieldInfo::FieldInfo(QString fieldId)
-    : m_plugin(NULL), m_numberOfSolutions(0), m_hermesMarkerToAgrosLabelConversion(nullptr), m_labelAreas(nullptr)
+    : m_plugin(NULL), m_numberOfSolutions(0), m_hermesMarkerToAgrosLabelConversion(nullptr), m_labelAreas(nullptr),
+      m_minimalArcRadius(0.0)
 {    
     assert(!fieldId.isEmpty());
     m_fieldId = fieldId;
@@ -183,16 +186,88 @@ double FieldInfo::labelArea(int agrosLabel) const
     return m_labelAreas[agrosLabel];
 }
 
+QVector<const Value *> FieldInfo::hermesMarkerValues(const QString &id) const
+{
+    QVector<SceneMaterial *> materials = hermesMarkerMaterials();
+
+    QVector<const Value *> table(materials.size(), NULL);
+    for (int marker = 0; marker < materials.size(); marker++)
+        if (materials[marker])
+            table[marker] = materials[marker]->valueNakedPtr(id);
+
+    return table;
+}
+
+QVector<SceneMaterial *> FieldInfo::hermesMarkerMaterials() const
+{
+    // markers are not known before meshing
+    if (!m_initialMesh)
+        return QVector<SceneMaterial *>();
+
+    int num = Agros2D::scene()->labels->count();
+    QVector<SceneMaterial *> table(num + 1, NULL);
+
+    for (int labelIndex = 0; labelIndex < num; labelIndex++)
+    {
+        SceneMaterial *material = Agros2D::scene()->labels->at(labelIndex)->marker(this);
+        if (material->isNone())
+            continue;
+
+        Hermes::Hermes2D::Mesh::MarkersConversion::IntValid intValid = m_initialMesh->get_element_markers_conversion().get_internal_marker(QString::number(labelIndex).toStdString());
+        if (!intValid.valid)
+            continue;
+
+        if (intValid.marker >= table.size())
+            table.resize(intValid.marker + 1);
+        table[intValid.marker] = material;
+    }
+
+    return table;
+}
+
+void FieldInfo::clearInitialMesh()
+{
+    QMutexLocker lock(&m_initialMeshLocatorMutex);
+
+    m_initialMesh = Hermes::Hermes2D::MeshSharedPtr();
+    m_initialMeshLocator.clear();
+    m_minimalArcRadius = 0.0;
+}
+
 void FieldInfo::setInitialMesh(Hermes::Hermes2D::MeshSharedPtr mesh)
 {
     clearInitialMesh();
     m_initialMesh = mesh;
+
+    // geometry is read here (mesh is set by problem), locators can be built later from any thread
+    double radius = 0.0;
+    foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
+        if (!edge->isStraight() && (radius == 0.0 || edge->radius() < radius))
+            radius = edge->radius();
+
+    m_minimalArcRadius = radius;
+}
+
+QSharedPointer<ElementLocator> FieldInfo::initialMeshLocator() const
+{
+    QMutexLocker lock(&m_initialMeshLocatorMutex);
+
+    if (m_initialMeshLocator.isNull() && m_initialMesh.get())
+        m_initialMeshLocator = QSharedPointer<ElementLocator>(new ElementLocator(m_initialMesh, m_minimalArcRadius));
+
+    return m_initialMeshLocator;
 }
 
 void FieldInfo::setAnalysisType(AnalysisType at)
 {
     m_analysisType = at;
 
+    // metadata of the new analysis
+    {
+        QMutexLocker lock(&m_moduleCacheMutex);
+        m_moduleCache.clear();
+    }
+
     foreach (XMLModule::analysis an, m_plugin->module()->general_field().analyses().analysis())
     {
         if (an.type() == analysisTypeToStringKey(at).toStdString())
@@ -432,9 +507,53 @@ QList<QString> FieldInfo::allMaterialQuantities() const
     return result;
 }
 
-// material type
-QList<Module::MaterialTypeVariable> FieldInfo::materialTypeVariables() const
+struct FieldInfo::ModuleCache
+{
+    AnalysisType analysisType;
+    LinearityType linearityType;
+    CoordinateType coordinateType;
+
+    QList<Module::MaterialTypeVariable> materialTypeVariables;
+    QList<Module::BoundaryType> boundaryTypes;
+    QList<Module::LocalVariable> localPointVariables;
+    QList<Module::LocalVariable> viewVectorVariables;
+    QList<Module::Integral> surfaceIntegrals;
+    QList<Module::Integral> volumeIntegrals;
+    QList<Module::ErrorCalculator> errorCalculators;
+    Module::Force force;
+
+    // id -> position in the lists above
+    QHash<QString, int> materialTypeVariableIndex;
+    QHash<QString, int> boundaryTypeIndex;
+    QHash<QString, int> localPointVariableIndex;
+    QHash<QString, int> surfaceIntegralIndex;
+    QHash<QString, int> volumeIntegralIndex;
+};
+
+QSharedPointer<const FieldInfo::ModuleCache> FieldInfo::moduleCache() const
+{
+    QMutexLocker lock(&m_moduleCacheMutex);
+
+    CoordinateType coordinateType = Agros2D::problem()->config()->coordinateType();
+    if (m_moduleCache.isNull()
+            || m_moduleCache->analysisType != m_analysisType
+            || m_moduleCache->linearityType != m_linearityType
+            || m_moduleCache->coordinateType != coordinateType)
+        m_moduleCache = QSharedPointer<const ModuleCache>(createModuleCache());
+
+    return m_moduleCache;
+}
+
+FieldInfo::ModuleCache *FieldInfo::createModuleCache() const
 {
+    ModuleCache *cache = new ModuleCache();
+    cache->analysisType = m_analysisType;
+    cache->linearityType = m_linearityType;
+    cache->coordinateType = Agros2D::problem()->config()->coordinateType();
+
+    std::string analysisTypeKey = analysisTypeToStringKey(cache->analysisType).toStdString();
+    bool isPlanar = (cache->coordinateType == CoordinateType_Planar);
+
     // all materials variables
     QList<Module::MaterialTypeVariable> materialTypeVariablesAll;
     for (int i = 0; i < m_plugin->module()->volume().quantity().size(); i++)
@@ -479,12 +598,12 @@ QList<Module::MaterialTypeVariable> FieldInfo::materialTypeVariables() const
         materialTypeVariablesAll.append(Module::MaterialTypeVariable(quant));
     }
 
-    QList<Module::MaterialTypeVariable> materialTypeVariables;
+    // material type
     for (unsigned int i = 0; i < m_plugin->module()->volume().weakforms_volume().weakform_volume().size(); i++)
     {
         XMLModule::weakform_volume wf = m_plugin->module()->volume().weakforms_volume().weakform_volume().at(i);
 
-        if (wf.analysistype() == analysisTypeToStringKey(analysisType()).toStdString())
+        if (wf.analysistype() == analysisTypeKey)
         {
             for (unsigned int i = 0; i < wf.quantity().size(); i++)
             {
@@ -495,7 +614,7 @@ QList<Module::MaterialTypeVariable> FieldInfo::materialTypeVariables() const
                     if (variable.id().toStdString() == qty.id())
                     {
                         QString nonlinearExpression;
-                        if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar && qty.nonlinearity_planar().present())
+                        if (isPlanar && qty.nonlinearity_planar().present())
                             nonlinearExpression = QString::fromStdString(qty.nonlinearity_planar().get());
                         else
                             if (qty.nonlinearity_axi().present())
@@ -505,8 +624,10 @@ QList<Module::MaterialTypeVariable> FieldInfo::materialTypeVariables() const
                         if (qty.dependence().present())
                             isTimeDep = (QString::fromStdString(qty.dependence().get()) == "time");
 
-                        materialTypeVariables.append(Module::MaterialTypeVariable(variable.id(), variable.shortname(),
-                                                                                  nonlinearExpression, isTimeDep, variable.isBool(), variable.onlyIf(), variable.onlyIfNot(), variable.isSource()));
+                        if (!cache->materialTypeVariableIndex.contains(variable.id()))
+                            cache->materialTypeVariableIndex[variable.id()] = cache->materialTypeVariables.count();
+                        cache->materialTypeVariables.append(Module::MaterialTypeVariable(variable.id(), variable.shortname(),
+                                                                                         nonlinearExpression, isTimeDep, variable.isBool(), variable.onlyIf(), variable.onlyIfNot(), variable.isSource()));
                     }
                 }
             }
@@ -515,17 +636,176 @@ QList<Module::MaterialTypeVariable> FieldInfo::materialTypeVariables() const
 
     materialTypeVariablesAll.clear();
 
-    return materialTypeVariables;
+    // boundary conditions
+    QList<Module::BoundaryTypeVariable> boundaryTypeVariablesAll;
+    for (int i = 0; i < m_plugin->module()->surface().quantity().size(); i++)
+    {
+        XMLModule::quantity quant = m_plugin->module()->surface().quantity().at(i);
+
+        // add to list
+        boundaryTypeVariablesAll.append(Module::BoundaryTypeVariable(quant));
+    }
+
+    for (int i = 0; i < m_plugin->module()->surface().weakforms_surface().weakform_surface().size(); i++)
+    {
+        XMLModule::weakform_surface wf = m_plugin->module()->surface().weakforms_surface().weakform_surface().at(i);
+
+        if (wf.analysistype() == analysisTypeKey)
+        {
+            for (int i = 0; i < wf.boundary().size(); i++)
+            {
+                XMLModule::boundary bdy = wf.boundary().at(i);
+                Module::BoundaryType boundaryType(this, boundaryTypeVariablesAll, bdy);
+
+                if (!cache->boundaryTypeIndex.contains(boundaryType.id()))
+                    cache->boundaryTypeIndex[boundaryType.id()] = cache->boundaryTypes.count();
+                cache->boundaryTypes.append(boundaryType);
+            }
+        }
+    }
+
+    boundaryTypeVariablesAll.clear();
+
+    // force
+    XMLModule::force force = m_plugin->module()->postprocessor().force();
+    for (unsigned int i = 0; i < force.expression().size(); i++)
+    {
+        XMLModule::expression exp = force.expression().at(i);
+        if (exp.analysistype() == analysisTypeKey)
+        {
+            cache->force = Module::Force(isPlanar ? QString::fromStdString(exp.planar_x().get()) : QString::fromStdString(exp.axi_r().get()),
+                                         isPlanar ? QString::fromStdString(exp.planar_y().get()) : QString::fromStdString(exp.axi_z().get()),
+                                         isPlanar ? QString::fromStdString(exp.planar_z().get()) : QString::fromStdString(exp.axi_phi().get()));
+            break;
+        }
+    }
+
+    // error calculators
+    for (unsigned int i = 0; i < m_plugin->module()->error_calculator().calculator().size(); i++)
+    {
+        XMLModule::calculator calc = m_plugin->module()->error_calculator().calculator().at(i);
+
+        for (unsigned int i = 0; i < calc.expression().size(); i++)
+        {
+            XMLModule::expression expr = calc.expression().at(i);
+            if (expr.analysistype() == analysisTypeKey)
+            {
+                if (isPlanar)
+                    cache->errorCalculators.append(Module::ErrorCalculator(QString::fromStdString(calc.id()), QString::fromStdString(calc.name()), QString::fromStdString(expr.planar().get()).trimmed()));
+                else
+                    cache->errorCalculators.append(Module::ErrorCalculator(QString::fromStdString(calc.id()), QString::fromStdString(calc.name()), QString::fromStdString(expr.axi().get()).trimmed()));
+            }
+        }
+    }
+
+    // local variables
+    for (unsigned int i = 0; i < m_plugin->module()->postprocessor().localvariables().localvariable().size(); i++)
+    {
+        XMLModule::localvariable lv = m_plugin->module()->postprocessor().localvariables().localvariable().at(i);
+
+        for (unsigned int i = 0; i < lv.expression().size(); i++)
+        {
+            XMLModule::expression expr = lv.expression().at(i);
+            if (expr.analysistype() == analysisTypeKey)
+            {
+                Module::LocalVariable variable(this, lv, cache->coordinateType, cache->analysisType);
+
+                if (!cache->localPointVariableIndex.contains(variable.id()))
+                    cache->localPointVariableIndex[variable.id()] = cache->localPointVariables.count();
+                cache->localPointVariables.append(variable);
+
+                // vector variables
+                if (!variable.isScalar())
+                    cache->viewVectorVariables.append(variable);
+            }
+        }
+    }
+
+    // surface integrals
+    for (unsigned int i = 0; i < m_plugin->module()->postprocessor().surfaceintegrals().surfaceintegral().size(); i++)
+    {
+        XMLModule::surfaceintegral sur = m_plugin->module()->postprocessor().surfaceintegrals().surfaceintegral().at(i);
+
+        QString expr;
+        for (unsigned int i = 0; i < sur.expression().size(); i++)
+        {
+            XMLModule::expression exp = sur.expression().at(i);
+            if (exp.analysistype() == analysisTypeKey)
+            {
+                if (isPlanar)
+                    expr = QString::fromStdString(exp.planar().get()).trimmed();
+                else
+                    expr = QString::fromStdString(exp.axi().get()).trimmed();
+            }
+        }
+
+        // new integral
+        if (!expr.isEmpty())
+        {
+            Module::Integral surint = Module::Integral(
+                        QString::fromStdString(sur.id()),
+                        m_plugin->localeName(QString::fromStdString(sur.name())),
+                        QString::fromStdString(sur.shortname()),
+                        (sur.shortname_html().present()) ? QString::fromStdString(sur.shortname_html().get()) : QString::fromStdString(sur.shortname()),
+                        QString::fromStdString(sur.unit()),
+                        (sur.unit_html().present()) ? QString::fromStdString(sur.unit_html().get()) : QString::fromStdString(sur.unit()),
+                        expr,
+                        false);
+
+            if (!cache->surfaceIntegralIndex.contains(surint.id()))
+                cache->surfaceIntegralIndex[surint.id()] = cache->surfaceIntegrals.count();
+            cache->surfaceIntegrals.append(surint);
+        }
+    }
+
+    // volume integrals
+    foreach (XMLModule::volumeintegral vol, m_plugin->module()->postprocessor().volumeintegrals().volumeintegral())
+    {
+        QString expr;
+        for (unsigned int i = 0; i < vol.expression().size(); i++)
+        {
+            XMLModule::expression exp = vol.expression().at(i);
+            if (exp.analysistype() == analysisTypeKey)
+            {
+                if (isPlanar)
+                    expr = QString::fromStdString(exp.planar().get()).trimmed();
+                else
+                    expr = QString::fromStdString(exp.axi().get()).trimmed();
+            }
+        }
+
+        // new integral
+        if (!expr.isEmpty())
+        {
+            Module::Integral volint = Module::Integral(
+                        QString::fromStdString(vol.id()),
+                        m_plugin->localeName(QString::fromStdString(vol.name())),
+                        QString::fromStdString(vol.shortname()),
+                        (vol.shortname_html().present()) ? QString::fromStdString(vol.shortname_html().get()) : QString::fromStdString(vol.shortname()),
+                        QString::fromStdString(vol.unit()),
+                        (vol.unit_html().present()) ? QString::fromStdString(vol.unit_html().get()) : QString::fromStdString(vol.unit()),
+                        expr,
+                        (vol.eggshell().present()) ? (vol.eggshell().get() == 1) : false);
+
+            if (!cache->volumeIntegralIndex.contains(volint.id()))
+                cache->volumeIntegralIndex[volint.id()] = cache->volumeIntegrals.count();
+            cache->volumeIntegrals.append(volint);
+        }
+    }
+
+    return cache;
+}
+
+// material type
+QList<Module::MaterialTypeVariable> FieldInfo::materialTypeVariables() const
+{
+    return moduleCache()->materialTypeVariables;
 }
 
 // variable by name
 bool FieldInfo::materialTypeVariableContains(const QString &id) const
 {
-    foreach (Module::MaterialTypeVariable var, materialTypeVariables())
-        if (var.id() == id)
-            return true;
-
-    return false;
+    return moduleCache()->materialTypeVariableIndex.contains(id);
 }
 
 bool FieldInfo::functionUsedInAnalysis(const QString &id) const
@@ -547,42 +827,15 @@ bool FieldInfo::functionUsedInAnalysis(const QString &id) const
 
 Module::MaterialTypeVariable FieldInfo::materialTypeVariable(const QString &id) const
 {
-    foreach (Module::MaterialTypeVariable var, materialTypeVariables())
-        if (var.id() == id)
-            return var;
+    QSharedPointer<const ModuleCache> cache = moduleCache();
+    assert(cache->materialTypeVariableIndex.contains(id));
 
-    assert(0);
+    return cache->materialTypeVariables.at(cache->materialTypeVariableIndex.value(id));
 }
 
 QList<Module::BoundaryType> FieldInfo::boundaryTypes() const
 {
-    QList<Module::BoundaryTypeVariable> boundaryTypeVariablesAll;
-    for (int i = 0; i < m_plugin->module()->surface().quantity().size(); i++)
-    {
-        XMLModule::quantity quant = m_plugin->module()->surface().quantity().at(i);
-
-        // add to list
-        boundaryTypeVariablesAll.append(Module::BoundaryTypeVariable(quant));
-    }
-
-    QList<Module::BoundaryType> boundaryTypes;
-    for (int i = 0; i < m_plugin->module()->surface().weakforms_surface().weakform_surface().size(); i++)
-    {
-        XMLModule::weakform_surface wf = m_plugin->module()->surface().weakforms_surface().weakform_surface().at(i);
-
-        if (wf.analysistype() == analysisTypeToStringKey(analysisType()).toStdString())
-        {
-            for (int i = 0; i < wf.boundary().size(); i++)
-            {
-                XMLModule::boundary bdy = wf.boundary().at(i);
-                boundaryTypes.append(Module::BoundaryType(this, boundaryTypeVariablesAll, bdy));
-            }
-        }
-    }
-
-    boundaryTypeVariablesAll.clear();
-
-    return boundaryTypes;
+    return moduleCache()->boundaryTypes;
 }
 
 // default boundary condition
@@ -602,18 +855,14 @@ Module::BoundaryType FieldInfo::boundaryTypeDefault() const
 // variable by name
 bool FieldInfo::boundaryTypeContains(const QString &id) const
 {
-    foreach (Module::BoundaryType var, boundaryTypes())
-        if (var.id() == id)
-            return true;
-
-    return false;
+    return moduleCache()->boundaryTypeIndex.contains(id);
 }
 
 Module::BoundaryType FieldInfo::boundaryType(const QString &id) const
 {
-    foreach (Module::BoundaryType var, boundaryTypes())
-        if (var.id() == id)
-            return var;
+    QSharedPointer<const ModuleCache> cache = moduleCache();
+    if (cache->boundaryTypeIndex.contains(id))
+        return cache->boundaryTypes.at(cache->boundaryTypeIndex.value(id));
 
     throw AgrosModuleException(QString("Boundary type %1 not found. Probably using corrupted a2d file or wrong version.").arg(id));
 }
@@ -621,40 +870,13 @@ Module::BoundaryType FieldInfo::boundaryType(const QString &id) const
 // force
 Module::Force FieldInfo::force() const
 {
-    // force
-    XMLModule::force force = m_plugin->module()->postprocessor().force();
-    for (unsigned int i = 0; i < force.expression().size(); i++)
-    {
-        XMLModule::expression exp = force.expression().at(i);
-        if (exp.analysistype() == analysisTypeToStringKey(analysisType()).toStdString())
-            return Module::Force((Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar) ? QString::fromStdString(exp.planar_x().get()) : QString::fromStdString(exp.axi_r().get()),
-                                 (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar) ? QString::fromStdString(exp.planar_y().get()) : QString::fromStdString(exp.axi_z().get()),
-                                 (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar) ? QString::fromStdString(exp.planar_z().get()) : QString::fromStdString(exp.axi_phi().get()));
-    }
+    return moduleCache()->force;
 }
 
 // error calculators
 QList<Module::ErrorCalculator> FieldInfo::errorCalculators() const
 {
-    QList<Module::ErrorCalculator> calculators;
-    for (unsigned int i = 0; i < m_plugin->module()->error_calculator().calculator().size(); i++)
-    {
-        XMLModule::calculator calc = m_plugin->module()->error_calculator().calculator().at(i);
-
-        for (unsigned int i = 0; i < calc.expression().size(); i++)
-        {
-            XMLModule::expression expr = calc.expression().at(i);
-            if (expr.analysistype() == analysisTypeToStringKey(analysisType()).toStdString())
-            {
-                if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
-                    calculators.append(Module::ErrorCalculator(QString::fromStdString(calc.id()), QString::fromStdString(calc.name()), QString::fromStdString(expr.planar().get()).trimmed()));
-                else
-                    calculators.append(Module::ErrorCalculator(QString::fromStdString(calc.id()), QString::fromStdString(calc.name()), QString::fromStdString(expr.axi().get()).trimmed()));
-            }
-        }
-    }
-
-    return calculators;
+    return moduleCache()->errorCalculators;
 }
 
 // material and boundary user interface
@@ -687,135 +909,40 @@ Module::DialogUI FieldInfo::boundaryUI() const
 // local point variables
 QList<Module::LocalVariable> FieldInfo::localPointVariables() const
 {
-    // local variables
-    QList<Module::LocalVariable> variables;
-    for (unsigned int i = 0; i < m_plugin->module()->postprocessor().localvariables().localvariable().size(); i++)
-    {
-        XMLModule::localvariable lv = m_plugin->module()->postprocessor().localvariables().localvariable().at(i);
-
-        for (unsigned int i = 0; i < lv.expression().size(); i++)
-        {
-            XMLModule::expression expr = lv.expression().at(i);
-            if (expr.analysistype() == analysisTypeToStringKey(analysisType()).toStdString())
-            {
-                variables.append(Module::LocalVariable(this,
-                                                       lv,
-                                                       Agros2D::problem()->config()->coordinateType(),
-                                                       analysisType()));
-            }
-        }
-    }
-
-    return variables;
+    return moduleCache()->localPointVariables;
 }
 
 // view scalar variables
 QList<Module::LocalVariable> FieldInfo::viewScalarVariables() const
 {
     // scalar variables = local variables
-    return localPointVariables();
+    return moduleCache()->localPointVariables;
 }
 
 // view vector variables
 QList<Module::LocalVariable> FieldInfo::viewVectorVariables() const
 {
-    // vector variables
-    QList<Module::LocalVariable> variables;
-    foreach (Module::LocalVariable var, localPointVariables())
-        if (!var.isScalar())
-            variables.append(var);
-
-    return variables;
+    return moduleCache()->viewVectorVariables;
 }
 
 // surface integrals
 QList<Module::Integral> FieldInfo::surfaceIntegrals() const
 {
-    // surface integrals
-    QList<Module::Integral> surfaceIntegrals;
-    for (unsigned int i = 0; i < m_plugin->module()->postprocessor().surfaceintegrals().surfaceintegral().size(); i++)
-    {
-        XMLModule::surfaceintegral sur = m_plugin->module()->postprocessor().surfaceintegrals().surfaceintegral().at(i);
-
-        QString expr;
-        for (unsigned int i = 0; i < sur.expression().size(); i++)
-        {
-            XMLModule::expression exp = sur.expression().at(i);
-            if (exp.analysistype() == analysisTypeToStringKey(analysisType()).toStdString())
-            {
-                if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
-                    expr = QString::fromStdString(exp.planar().get()).trimmed();
-                else
-                    expr = QString::fromStdString(exp.axi().get()).trimmed();
-            }
-        }
-
-        // new integral
-        if (!expr.isEmpty())
-        {
-            Module::Integral surint = Module::Integral(
-                        QString::fromStdString(sur.id()),
-                        m_plugin->localeName(QString::fromStdString(sur.name())),
-                        QString::fromStdString(sur.shortname()),
-                        (sur.shortname_html().present()) ? QString::fromStdString(sur.shortname_html().get()) : QString::fromStdString(sur.shortname()),
-                        QString::fromStdString(sur.unit()),
-                        (sur.unit_html().present()) ? QString::fromStdString(sur.unit_html().get()) : QString::fromStdString(sur.unit()),
-                        expr,
-                        false);
-
-            surfaceIntegrals.append(surint);
-        }
-    }
-
-    return surfaceIntegrals;
+    return moduleCache()->surfaceIntegrals;
 }
 
 // volume integrals
 QList<Module::Integral> FieldInfo::volumeIntegrals() const
 {
-    // volume integrals
-    QList<Module::Integral> volumeIntegrals;
-    foreach (XMLModule::volumeintegral vol, m_plugin->module()->postprocessor().volumeintegrals().volumeintegral())
-    {
-        QString expr;
-        for (unsigned int i = 0; i < vol.expression().size(); i++)
-        {
-            XMLModule::expression exp = vol.expression().at(i);
-            if (exp.analysistype() == analysisTypeToStringKey(analysisType()).toStdString())
-            {
-                if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
-                    expr = QString::fromStdString(exp.planar().get()).trimmed();
-                else
-                    expr = QString::fromStdString(exp.axi().get()).trimmed();
-            }
-        }
-
-        // new integral
-        if (!expr.isEmpty())
-        {
-            Module::Integral volint = Module::Integral(
-                        QString::fromStdString(vol.id()),
-                        m_plugin->localeName(QString::fromStdString(vol.name())),
-                        QString::fromStdString(vol.shortname()),
-                        (vol.shortname_html().present()) ? QString::fromStdString(vol.shortname_html().get()) : QString::fromStdString(vol.shortname()),
-                        QString::fromStdString(vol.unit()),
-                        (vol.unit_html().present()) ? QString::fromStdString(vol.unit_html().get()) : QString::fromStdString(vol.unit()),
-                        expr,
-                        (vol.eggshell().present()) ? (vol.eggshell().get() == 1) : false);
-
-            volumeIntegrals.append(volint);
-        }
-    }
-
-    return volumeIntegrals;
+    return moduleCache()->volumeIntegrals;
 }
 
 // variable by name
 Module::LocalVariable FieldInfo::localVariable(const QString &id) const
 {
-    foreach (Module::LocalVariable var, localPointVariables())
-        if (var.id() == id)
-            return var;
+    QSharedPointer<const ModuleCache> cache = moduleCache();
+    if (cache->localPointVariableIndex.contains(id))
+        return cache->localPointVariables.at(cache->localPointVariableIndex.value(id));
 
     qDebug() << "Warning: unable to return local variable: " << id;
     return Module::LocalVariable();
@@ -823,9 +950,9 @@ Module::LocalVariable FieldInfo::localVariable(const QString &id) const
 
 Module::Integral FieldInfo::surfaceIntegral(const QString &id) const
 {
-    foreach (Module::Integral var, surfaceIntegrals())
-        if (var.id() == id)
-            return var;
+    QSharedPointer<const ModuleCache> cache = moduleCache();
+    if (cache->surfaceIntegralIndex.contains(id))
+        return cache->surfaceIntegrals.at(cache->surfaceIntegralIndex.value(id));
 
     qDebug() << "surfaceIntegral: " << id;
     assert(0);
@@ -833,9 +960,9 @@ Module::Integral FieldInfo::surfaceIntegral(const QString &id) const
 
 Module::Integral FieldInfo::volumeIntegral(const QString &id) const
 {
-    foreach (Module::Integral var, volumeIntegrals())
-        if (var.id() == id)
-            return var;
+    QSharedPointer<const ModuleCache> cache = moduleCache();
+    if (cache->volumeIntegralIndex.contains(id))
+        return cache->volumeIntegrals.at(cache->volumeIntegralIndex.value(id));
 
     qDebug() << "volumeIntegral: " << id;
     assert(0);
@@ -40,6 +40,7 @@ class CouplingInfo;
 class LocalForceValue;
 class PluginInterface;
 class Value;
+class ElementLocator;
 
 const int LABEL_OUTSIDE_FIELD = -10000;
 
@@ -59,8 +60,12 @@ public:
     inline int numberId() const { return m_numberId; }
 
     inline Hermes::Hermes2D::MeshSharedPtr initialMesh() const { return m_initialMesh; }
-    inline void clearInitialMesh() { m_initialMesh = Hermes::Hermes2D::MeshSharedPtr();}
+    void clearInitialMesh();
     void setInitialMesh(Hermes::Hermes2D::MeshSharedPtr mesh);
+    // element locator of the initial mesh (built on demand, shared by post-processing)
+    QSharedPointer<ElementLocator> initialMeshLocator() const;
+    // smallest radius of arcs in the geometry of the initial mesh (0 - no arcs)
+    inline double minimalArcRadius() const { return m_minimalArcRadius; }
 
     enum Type
     {
@@ -237,6 +242,12 @@ public:
     QList<QWeakPointer<Value> > valuePointerTable(QString id) const;
     int hermesMarkerToAgrosLabel(int hermesMarker) const;
     double labelArea(int agrosLabel) const;
+
+    // material values indexed by Hermes element marker of the initial mesh (NULL outside of the field),
+    // resolved once by post-processing calculators instead of per element (empty without initial mesh)
+    QVector<const Value *> hermesMarkerValues(const QString &id) const;
+    QVector<SceneMaterial *> hermesMarkerMaterials() const;
+
     inline double frequency() const { return m_frequency; }
 
 
@@ -255,6 +266,9 @@ private:
 
     // initial mesh
     Hermes::Hermes2D::MeshSharedPtr m_initialMesh;
+    mutable QSharedPointer<ElementLocator> m_initialMeshLocator;
+    mutable QMutex m_initialMeshLocatorMutex;
+    double m_minimalArcRadius;
 
     // analysis type
     AnalysisType m_analysisType;
@@ -283,6 +297,15 @@ private:
     void setDefaultValues();
     void setStringKeys();
 
+    // module metadata (variables, boundary types, integrals, ...) materialized from the XML description,
+    // rebuilt when analysis, linearity or coordinate type changes; built cache is never modified
+    struct ModuleCache;
+    mutable QSharedPointer<const ModuleCache> m_moduleCache;
+    mutable QMutex m_moduleCacheMutex;
+
+    QSharedPointer<const ModuleCache> moduleCache() const;
+    ModuleCache *createModuleCache() const;
+
     // for speed optimisations
     QMap<QString, QList<QWeakPointer<Value> > > m_valuePointersTable;
     int* m_hermesMarkerToAgrosLabelConversion;
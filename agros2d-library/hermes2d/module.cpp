@@ -146,6 +146,9 @@ WeakFormAgros<Scalar>::WeakFormAgros(Block* block) :
 template <typename Scalar>
 WeakFormAgros<Scalar>::~WeakFormAgros()
 {
+    foreach (FieldSolutionID solutionID, m_pinnedSolutions)
+        Agros2D::solutionStore()->unpinSolution(solutionID);
+
     foreach (Hermes::Hermes2D::Form<Scalar> *form, this->forms)
         delete form;
 
@@ -481,7 +484,41 @@ void WeakFormAgros<Scalar>::registerForms()
 }
 
 template <typename Scalar>
-Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > WeakFormAgros<Scalar>::quantitiesAndSpecialFunctions(const FieldInfo* fieldInfo, bool linearize) const
+Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > WeakFormAgros<Scalar>::extFunctions(const FieldInfo* fieldInfo, bool linearize)
+{
+    QPair<const FieldInfo *, bool> key(fieldInfo, linearize);
+    double time = Agros2D::problem()->actualTime();
+
+    // tables are indexed by markers of the initial mesh
+    if (!m_extFunctions.contains(key) || m_extFunctions[key].initialMesh != fieldInfo->initialMesh().get())
+    {
+        ExtFunctions extFunctions;
+        extFunctions.initialMesh = fieldInfo->initialMesh().get();
+        extFunctions.time = time;
+        extFunctions.functions = quantitiesAndSpecialFunctions(fieldInfo, linearize, extFunctions.timeDependent);
+
+        m_extFunctions[key] = extFunctions;
+    }
+    else
+    {
+        ExtFunctions &extFunctions = m_extFunctions[key];
+
+        // other functions read values, previous solutions and u_ext through offsets during assembling
+        if (extFunctions.time != time)
+        {
+            foreach (AgrosExtFunction *extFunction, extFunctions.timeDependent)
+                extFunction->updateTime();
+
+            extFunctions.time = time;
+        }
+    }
+
+    return m_extFunctions[key].functions;
+}
+
+template <typename Scalar>
+Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > WeakFormAgros<Scalar>::quantitiesAndSpecialFunctions(const FieldInfo* fieldInfo, bool linearize,
+                                                                                                                      QList<AgrosExtFunction *> &timeDependent) const
 {
     Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > result;
 
@@ -575,9 +612,12 @@ Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > WeakFormAgros<S
         Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> extFunction;
         if(containedInAnalysis)
         {
-            Hermes::Hermes2D::UExtFunction<Scalar> *extFunctionPtr = fieldInfo->plugin()->extFunction(problemId, functionID, false, linearize, this);
+            AgrosExtFunction *extFunctionPtr = fieldInfo->plugin()->extFunction(problemId, functionID, false, linearize, this);
             assert(extFunctionPtr);
             extFunction = Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar>(extFunctionPtr);
+
+            if (extFunctionPtr->isTimeDependent())
+                timeDependent.append(extFunctionPtr);
         }
         else
             extFunction = Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar>(new AgrosEmptyExtFunction());
@@ -589,7 +629,15 @@ Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > WeakFormAgros<S
 }
 
 template <typename Scalar>
-Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > WeakFormAgros<Scalar>::previousTimeLevelsSolutions(const FieldInfo* fieldInfo) const
+void WeakFormAgros<Scalar>::pinSolution(FieldSolutionID solutionID)
+{
+    // pin before loading, loading of other solutions can not evict it
+    Agros2D::solutionStore()->pinSolution(solutionID);
+    m_pinnedSolutions.append(solutionID);
+}
+
+template <typename Scalar>
+Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > WeakFormAgros<Scalar>::previousTimeLevelsSolutions(const FieldInfo* fieldInfo)
 {
     Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > result;
 
@@ -608,6 +656,7 @@ Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > WeakFormAgros<S
             solutionID.solutionMode = SolutionMode_Normal;
         assert(Agros2D::solutionStore()->contains(solutionID));
 
+        pinSolution(solutionID);
         for (int comp = 0; comp < solutionID.group->numberOfSolutions(); comp++)
             result.push_back(Agros2D::solutionStore()->multiArray(solutionID).solutions().at(comp));
     }
@@ -616,11 +665,12 @@ Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > WeakFormAgros<S
 }
 
 template <typename Scalar>
-Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > WeakFormAgros<Scalar>::sourceCouplingSolutions(const FieldInfo* fieldInfo) const
+Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > WeakFormAgros<Scalar>::sourceCouplingSolutions(const FieldInfo* fieldInfo)
 {
     Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > result;
 
     FieldSolutionID solutionID = Agros2D::solutionStore()->lastTimeAndAdaptiveSolution(fieldInfo, SolutionMode_Finer);
+    pinSolution(solutionID);
 
     for (int comp = 0; comp < solutionID.group->numberOfSolutions(); comp++)
         result.push_back(Agros2D::solutionStore()->multiArray(solutionID).solutions().at(comp));
@@ -636,6 +686,10 @@ void WeakFormAgros<Scalar>::updateExtField()
     for(int i = 0; i < MAX_FIELDS; i++)
         m_positionInfos[i] = PositionInfo();
 
+    // solutions pinned in the previous step are released after the new ones are pinned
+    QList<FieldSolutionID> previousPinnedSolutions = m_pinnedSolutions;
+    m_pinnedSolutions.clear();
+
     // register two types of external functions. Quantities and special functions of all fields go to externalUSlns
     Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > externalUSlns;
     Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > fieldUExt;
@@ -645,7 +699,7 @@ void WeakFormAgros<Scalar>::updateExtField()
     {
         // quantities have to be linearized (field that they depend on has allready been solved, now we are solving different
         // field and thus 1. u_ext does not contain the source field and 2. it would be unnecessary anyway)
-        fieldUExt = quantitiesAndSpecialFunctions(fieldInfo, true);
+        fieldUExt = extFunctions(fieldInfo, true);
 
         m_positionInfos[fieldInfo->numberId()].numQuantAndSpecFun = fieldUExt.size();
         m_positionInfos[fieldInfo->numberId()].quantAndSpecOffset = externalUSlns.size();
@@ -660,7 +714,7 @@ void WeakFormAgros<Scalar>::updateExtField()
         FieldInfo* fieldInfo = field->fieldInfo();
 
         // inside the block use nonlinear quantities
-        fieldUExt = quantitiesAndSpecialFunctions(fieldInfo, false);
+        fieldUExt = extFunctions(fieldInfo, false);
 
         m_positionInfos[fieldInfo->numberId()].formsOffset = m_block->offset(field);
         m_positionInfos[fieldInfo->numberId()].numQuantAndSpecFun = fieldUExt.size();
@@ -708,6 +762,16 @@ void WeakFormAgros<Scalar>::updateExtField()
     this->set_u_ext_fn(externalUSlns);
     this->set_ext(externalSlns);
 
+    foreach (FieldSolutionID solutionID, previousPinnedSolutions)
+        Agros2D::solutionStore()->unpinSolution(solutionID);
+
+    // position infos are final, forms and external functions resolve their offsets once for the whole step
+    foreach (Hermes::Hermes2D::Form<Scalar> *form, this->forms)
+        dynamic_cast<FormAgrosInterface<Scalar> *>(form)->updateOffset();
+
+    for (int i = 0; i < externalUSlns.size(); i++)
+        dynamic_cast<AgrosExtFunction *>(externalUSlns[i].get())->updateOffset();
+
     // outputPositionInfos();
     // qDebug() << "total number of u_ext_fn: " << externalUSlns.size() << " and ext_fn: " << externalSlns.size();
 }
@@ -30,7 +30,7 @@ AgrosExtFunction::~AgrosExtFunction()
 {
 }
 
-AgrosSpecialExtFunction::AgrosSpecialExtFunction(const FieldInfo *fieldInfo,  const WeakFormAgros<double>* wfAgros, SpecialFunctionType type, int count) : AgrosExtFunction(fieldInfo, wfAgros), m_type(type), m_count(count)
+AgrosSpecialExtFunction::AgrosSpecialExtFunction(const FieldInfo *fieldInfo,  const WeakFormAgros<double>* wfAgros, SpecialFunctionType type, int count) : AgrosExtFunction(fieldInfo, wfAgros), m_type(type), m_count(count), m_stepInverse(0.0)
 {
     if((type == SpecialFunctionType_Constant) || (count > 0))
         m_useTable = true;
@@ -42,6 +42,12 @@ void AgrosSpecialExtFunction::init()
 {
     if(m_useTable)
     {
+        if (m_type != SpecialFunctionType_Constant)
+        {
+            assert(m_count >= 2);
+            m_stepInverse = (m_count - 1) / (m_boundHi - m_boundLow);
+        }
+
         for (int labelNum = 0; labelNum < Agros2D::scene()->labels->count(); labelNum++)
         {
             SceneLabel* label = Agros2D::scene()->labels->at(labelNum);
@@ -50,7 +56,7 @@ void AgrosSpecialExtFunction::init()
             {
                 assert(marker.valid);
                 int hermesMarker = marker.marker;
-                assert(!m_data.contains(hermesMarker));
+                assert(hermesMarker >= m_data.size() || !m_data.at(hermesMarker).m_isValid);
                 createOneTable(hermesMarker);
             }
         }
@@ -63,8 +69,7 @@ void AgrosSpecialExtFunction::createOneTable(int hermesMarker)
     double constantValue = -123456;
     double extrapolationLow = -123456;
     double extrapolationHi = -123456;
-    Hermes::vector<double> points;
-    Hermes::vector<double> values;
+    int offset = m_table.size();
 
     if(m_type == SpecialFunctionType_Constant)
         constantValue = calculateValue(hermesMarker, 0);
@@ -74,20 +79,50 @@ void AgrosSpecialExtFunction::createOneTable(int hermesMarker)
         for (int i = 0; i < m_count; i++)
         {
             double h = m_boundLow + i * step;
-            points.push_back(h);
-            values.push_back(calculateValue(hermesMarker, h));
+            m_table.append(calculateValue(hermesMarker, h));
         }
         extrapolationLow = calculateValue(hermesMarker, m_boundLow - 1);
         extrapolationHi = calculateValue(hermesMarker, m_boundHi + 1);
     }
-    QSharedPointer<DataTable> table(new DataTable(points, values));
-    AgrosSpecialExtFunctionOneMaterial materialData(table, constantValue, extrapolationLow, extrapolationHi);
-    m_data[hermesMarker] = materialData;
+
+    if (hermesMarker >= m_data.size())
+        m_data.resize(hermesMarker + 1);
+    m_data[hermesMarker] = AgrosSpecialExtFunctionOneMaterial(offset, constantValue, extrapolationLow, extrapolationHi);
+}
+
+QList<QWeakPointer<Value> > AgrosSpecialExtFunction::parameterPointerTable(const QString &id)
+{
+    QList<QWeakPointer<Value> > pointers = m_fieldInfo->valuePointerTable(id);
+    m_parameters.append(pointers);
+
+    return pointers;
+}
+
+bool AgrosSpecialExtFunction::isTimeDependent() const
+{
+    // without table, values are calculated from actual parameters
+    if (!m_useTable)
+        return false;
+
+    foreach (QList<QWeakPointer<Value> > pointers, m_parameters)
+        foreach (QWeakPointer<Value> pointer, pointers)
+            if (!pointer.isNull() && pointer.data()->isTimeDependent())
+                return true;
+
+    return false;
+}
+
+void AgrosSpecialExtFunction::updateTime()
+{
+    m_data.clear();
+    m_table.clear();
+    init();
 }
 
 double AgrosSpecialExtFunction::valueFromTable(int hermesMarker, double h) const
 {
-    AgrosSpecialExtFunctionOneMaterial data = m_data[hermesMarker];
+    // no copies (and reference counting) of shared data, called from assembling threads
+    const AgrosSpecialExtFunctionOneMaterial &data = m_data.at(hermesMarker);
 
     assert(data.m_isValid);
 
@@ -100,7 +135,14 @@ double AgrosSpecialExtFunction::valueFromTable(int hermesMarker, double h) const
         else if(h > m_boundHi)
             return data.m_extrapolationHi;
         else
-            return data.m_dataTable->value(h);
+        {
+            // uniform step, linear interpolation
+            double position = (h - m_boundLow) * m_stepInverse;
+            int index = qMin((int) position, m_count - 2);
+            const double *values = m_table.constData() + data.m_offset;
+
+            return values[index] + (position - index) * (values[index + 1] - values[index]);
+        }
     }
 }
 
@@ -56,11 +56,21 @@ public:
 
     virtual void init() {}
 
+    // data prepared in init() depend on time dependent values and have to be updated in each time step
+    virtual bool isTimeDependent() const { return false; }
+    virtual void updateTime() {}
+
+    // offsets in the block are fixed for one step, generated functions read the cached value
+    void updateOffset() { if (m_wfAgros && m_fieldInfo) m_offset = m_wfAgros->offsetInfo(nullptr, m_fieldInfo); }
+
 protected:
     const FieldInfo* m_fieldInfo;
     const WeakFormAgros<double>* m_wfAgros;
    // int m_formsOffset;
 
+    // offsets of the field (set in WeakFormAgros::updateExtField)
+    Offset m_offset;
+
 };
 
 
@@ -83,13 +93,13 @@ public:
 class AGROS_LIBRARY_API AgrosSpecialExtFunctionOneMaterial
 {
 public:
-    AgrosSpecialExtFunctionOneMaterial() : m_constantValue(-123456), m_extrapolationLow(-123456), m_extrapolationHi(-123456), m_isValid(false) {}
-    AgrosSpecialExtFunctionOneMaterial(QSharedPointer<DataTable> dataTable, double constantValue, double extrapolationLow, double extrapolationHi) :
-        m_dataTable(dataTable), m_constantValue(constantValue), m_extrapolationLow(extrapolationLow), m_extrapolationHi(extrapolationHi), m_isValid(true) {}
+    AgrosSpecialExtFunctionOneMaterial() : m_offset(-1), m_constantValue(-123456), m_extrapolationLow(-123456), m_extrapolationHi(-123456), m_isValid(false) {}
+    AgrosSpecialExtFunctionOneMaterial(int offset, double constantValue, double extrapolationLow, double extrapolationHi) :
+        m_offset(offset), m_constantValue(constantValue), m_extrapolationLow(extrapolationLow), m_extrapolationHi(extrapolationHi), m_isValid(true) {}
 
 protected:
-    // using pointer from efficiency reasons. Each copy constructor of DataTable calculates approximation.
-    QSharedPointer<DataTable> m_dataTable;
+    // position of the first sample of the material in the table of the function
+    int m_offset;
     double m_constantValue;
     double m_extrapolationLow;
     double m_extrapolationHi;
@@ -108,9 +118,17 @@ public:
     double getValue(int hermesMarker, double h) const;
     virtual double calculateValue(int hermesMarker, double h) const = 0;
 
+    // tables are kept unless some parameter depends on time
+    virtual bool isTimeDependent() const;
+    virtual void updateTime();
+
 protected:
     void createOneTable(int hermesMarker);
 
+    // value pointers of a parameter, registered as a dependency of tables
+    QList<QWeakPointer<Value> > parameterPointerTable(const QString &id);
+    QList<QList<QWeakPointer<Value> > > m_parameters;
+
     inline bool useInterpolation() const { return m_count > 0; }
 
     SpecialFunctionType m_type;
@@ -118,9 +136,14 @@ protected:
     double m_boundHi;
     int m_count;
     QString m_variant;
-    QMap<int , AgrosSpecialExtFunctionOneMaterial> m_data;
     bool m_useTable;
 
+    // materials indexed by Hermes element marker and their samples (m_count values with uniform step
+    // from m_boundLow to m_boundHi), tables are only read during assembling (shared by threads)
+    QVector<AgrosSpecialExtFunctionOneMaterial> m_data;
+    QVector<double> m_table;
+    double m_stepInverse;
+
     double valueFromTable(int hermesMarker, double h) const;
 };
 
@@ -176,6 +199,48 @@ protected:
     QMap<QString, LocalPointValue> m_values;
 };
 
+// solution meshes different from the initial mesh get own element locator for at least this number of points
+const int LOCAL_VALUES_MIN_POINTS_LOCATOR = 64;
+
+// local values in many points evaluated in one pass
+// points are located by ElementLocator and grouped by elements, only requested variables are evaluated
+class LocalValues
+{
+public:
+    LocalValues(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                const QVector<Point> &points, const QStringList &variables = QStringList())
+        : m_fieldInfo(fieldInfo), m_timeStep(timeStep), m_adaptivityStep(adaptivityStep), m_solutionType(solutionType),
+          m_points(points), m_variables(variables) {}
+    virtual ~LocalValues() {}
+
+    // points
+    inline QVector<Point> points() const { return m_points; }
+    // point lies in the field
+    inline bool isFound(int index) const { return m_found.testBit(index); }
+
+    // values in points (default values in points outside of the field)
+    inline QVector<LocalPointValue> values(const QString &variable) const { return m_values.value(variable); }
+
+    virtual void calculate() = 0;
+
+protected:
+    // points
+    QVector<Point> m_points;
+    QBitArray m_found;
+    // requested variables (empty - all variables)
+    QStringList m_variables;
+    // field info
+    const FieldInfo *m_fieldInfo;
+    int m_timeStep;
+    int m_adaptivityStep;
+    SolutionMode m_solutionType;
+
+    // variables
+    QMap<QString, QVector<LocalPointValue> > m_values;
+
+    inline bool isRequested(const QString &variable) const { return m_variables.isEmpty() || m_variables.contains(variable); }
+};
+
 class IntegralValue
 {
 public:
@@ -219,6 +284,9 @@ public:
     void setMarkerVolume(double volume) { m_markerVolume = volume; }
     inline double markerVolume() const { return m_markerVolume; }
 
+    // offsets in the block are fixed for one step, generated forms read the cached value
+    void updateOffset() { m_offset = m_wfAgros->offsetInfo(m_markerSource, m_markerTarget); }
+
 protected:
     // source or single marker
     const Marker *m_markerSource;
@@ -237,6 +305,9 @@ protected:
     const WeakFormAgros<Scalar> *m_wfAgros;
 
     double m_markerVolume;
+
+    // offsets of the form (copied to clones used in assembling)
+    Offset m_offset;
 };
 
 // weakforms
@@ -319,12 +390,14 @@ public:
 
     // local values
     virtual LocalValue *localValue(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType, const Point &point) = 0;
+    virtual LocalValues *localValues(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                                     const QVector<Point> &points, const QStringList &variables = QStringList()) = 0;
     // surface integrals
     virtual IntegralValue *surfaceIntegral(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType) = 0;
     // volume integrals
     virtual IntegralValue *volumeIntegral(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType) = 0;
-    // force calculation
-    virtual Point3 force(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+    // force calculation (solutions are owned by the caller, every thread uses its own copies)
+    virtual Point3 force(const FieldInfo *fieldInfo, int timeStep, const Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > &solutions,
                          Hermes::Hermes2D::Element *element, SceneMaterial *material, const Point3 &point, const Point3 &velocity) = 0;
     virtual bool hasForce(const FieldInfo *fieldInfo) = 0;
 
@@ -651,6 +651,9 @@ void Problem::solve(bool commandLine)
     if (Agros2D::configComputer()->value(Config::Config_LinearSystemSave).toBool())
         Agros2D::log()->printWarning(tr("Solver"), tr("Matrix and RHS will be saved on the disk and this will slow down the calculation. You may disable it in application settings."));
 
+    // external solver server (if used) is stopped at the end of calculation
+    AgrosExternalSolverServerGuard externalSolverServerGuard;
+
     try
     {
         Hermes::HermesCommonApi.set_integral_param_value(Hermes::numThreads, Agros2D::configComputer()->value(Config::Config_NumberOfThreads).toInt());
@@ -785,61 +788,47 @@ void Problem::solveAction()
         solvers[block].data()->createInitialSpace();
     }
 
+    // independent blocks are solved concurrently
+    QList<QList<Block *> > levels = blockLevels();
+
     TimeStepInfo nextTimeStep(config()->initialTimeStepLength());
     bool doNextTimeStep = true;
     do
     {
-        foreach (Block* block, m_blocks)
+        foreach (QList<Block *> level, levels)
         {
-            // qDebug() << "solving " << block->fields().at(0)->fieldInfo()->fieldId();
-            if (block->isTransient() && (actualTimeStep() == 0))
-            {
-                solvers[block]->solveInitialTimeStep();
-            }
-            else if(!skipThisTimeStep(block))
+            QList<Block *> solvedBlocks;
+            QList<Block *> preparedBlocks;
+
+            foreach (Block* block, level)
             {
-                stepMessage(block);
-                if (block->adaptivityType() == AdaptivityType_None)
+                // qDebug() << "solving " << block->fields().at(0)->fieldInfo()->fieldId();
+                if (block->isTransient() && (actualTimeStep() == 0))
                 {
-                    // no adaptivity
-                    solvers[block]->solveSimple(actualTimeStep(), 0);
+                    solvers[block]->solveInitialTimeStep();
                 }
-                else
+                else if(!skipThisTimeStep(block))
                 {
-                    // adaptivity
-                    int adaptStep = 1;
-                    bool doContinueAdaptivity = true;
-                    while (doContinueAdaptivity && (adaptStep <= block->adaptivitySteps()) && !m_abort)
+                    stepMessage(block);
+                    if ((level.size() > 1) && isConcurrentBlock(block))
                     {
-                        // solve problem
-                        solvers[block]->solveReferenceAndProject(actualTimeStep(), adaptStep - 1);
-                        // create adapted space
-                        doContinueAdaptivity = solvers[block]->createAdaptedSpace(actualTimeStep(), adaptStep);
-
-                        // Python callback
-                        foreach (Field *field, block->fields())
-                        {
-                            QString command = QString("(agros2d.field(\"%1\").adaptivity_callback(%2) if (agros2d.field(\"%1\").adaptivity_callback is not None and hasattr(agros2d.field(\"%1\").adaptivity_callback, '__call__')) else True)").
-                                arg(field->fieldInfo()->fieldId()).
-                                arg(adaptStep - 1);
-
-                            double cont = 1.0;
-                            bool successfulRun = currentPythonEngine()->runExpression(command, &cont);
-                            if (!successfulRun)
-                            {
-                                ErrorResult result = currentPythonEngine()->parseError();
-                                Agros2D::log()->printError(QObject::tr("Adaptivity callback"), result.error());
-                            }
-
-                            if (!cont)
-                                doContinueAdaptivity = false;
-                            break;
-                        }
-
-                        adaptStep++;
+                        // solved later together with other blocks of the level
+                        solvers[block]->prepareSimple(actualTimeStep(), 0);
+                        preparedBlocks.append(block);
                     }
+                    else
+                    {
+                        solveBlock(block, solvers[block]);
+                    }
+
+                    solvedBlocks.append(block);
                 }
+            }
 
+            solveBlocksConcurrently(preparedBlocks, solvers);
+
+            foreach (Block* block, solvedBlocks)
+            {
                 // TODO: it should be estimated in the first step as well
                 // TODO: what if more blocks are transient? (take minimum? )
 
@@ -894,6 +883,174 @@ void Problem::solveAction()
     } while (doNextTimeStep && !m_abort);
 }
 
+QList<QList<Block *> > Problem::blockLevels() const
+{
+    // sources of weak coupling are solved before the target block (longest path in the coupling graph),
+    // source can be later in m_blocks than its target
+    QMap<Block *, int> blockLevel;
+    foreach (Block *block, m_blocks)
+        blockLevel[block] = 0;
+
+    bool changed = true;
+    for (int iteration = 0; changed && iteration <= m_blocks.size(); iteration++)
+    {
+        changed = false;
+        foreach (Block *block, m_blocks)
+        {
+            foreach (FieldInfo *sourceFieldInfo, block->sourceFieldInfosCoupling())
+            {
+                Block *sourceBlock = blockOfField(sourceFieldInfo);
+                if (sourceBlock && (sourceBlock != block) && (blockLevel[block] <= blockLevel[sourceBlock]))
+                {
+                    blockLevel[block] = blockLevel[sourceBlock] + 1;
+                    changed = true;
+                }
+            }
+        }
+    }
+    // weak couplings have to be acyclic
+    assert(!changed);
+
+    QList<QList<Block *> > levels;
+    foreach (Block *block, m_blocks)
+    {
+        int level = blockLevel[block];
+        while (levels.size() <= level)
+            levels.append(QList<Block *>());
+        levels[level].append(block);
+    }
+
+    return levels;
+}
+
+bool Problem::isConcurrentBlock(Block *block) const
+{
+    // adaptivity runs Python callbacks, external solver server is bound to the calculation thread
+    return (block->adaptivityType() == AdaptivityType_None) &&
+            (block->matrixSolver() != Hermes::SOLVER_EXTERNAL);
+}
+
+void Problem::solveBlock(Block *block, QSharedPointer<ProblemSolver<double> > solver)
+{
+    if (block->adaptivityType() == AdaptivityType_None)
+    {
+        // no adaptivity
+        solver->solveSimple(actualTimeStep(), 0);
+    }
+    else
+    {
+        // adaptivity
+        int adaptStep = 1;
+        bool doContinueAdaptivity = true;
+        while (doContinueAdaptivity && (adaptStep <= block->adaptivitySteps()) && !m_abort)
+        {
+            // solve problem
+            solver->solveReferenceAndProject(actualTimeStep(), adaptStep - 1);
+            // create adapted space
+            doContinueAdaptivity = solver->createAdaptedSpace(actualTimeStep(), adaptStep);
+
+            // Python callback
+            foreach (Field *field, block->fields())
+            {
+                QString command = QString("(agros2d.field(\"%1\").adaptivity_callback(%2) if (agros2d.field(\"%1\").adaptivity_callback is not None and hasattr(agros2d.field(\"%1\").adaptivity_callback, '__call__')) else True)").
+                    arg(field->fieldInfo()->fieldId()).
+                    arg(adaptStep - 1);
+
+                double cont = 1.0;
+                bool successfulRun = currentPythonEngine()->runExpression(command, &cont);
+                if (!successfulRun)
+                {
+                    ErrorResult result = currentPythonEngine()->parseError();
+                    Agros2D::log()->printError(QObject::tr("Adaptivity callback"), result.error());
+                }
+
+                if (!cont)
+                    doContinueAdaptivity = false;
+                break;
+            }
+
+            adaptStep++;
+        }
+    }
+}
+
+class BlockSolverRunnable : public QRunnable
+{
+public:
+    BlockSolverRunnable(QSharedPointer<ProblemSolver<double> > solver, int timeStep)
+        : m_solver(solver), m_timeStep(timeStep) {}
+
+    void run()
+    {
+        try
+        {
+            m_solver->solveSimplePrepared(m_timeStep, 0);
+        }
+        catch (Hermes::Exceptions::Exception &e)
+        {
+            m_error = QString::fromStdString(e.info());
+        }
+        catch (AgrosException &e)
+        {
+            m_error = e.toString();
+        }
+        catch (...)
+        {
+            m_error = QObject::tr("An unknown exception occurred in solver");
+        }
+    }
+
+    inline QString error() const { return m_error; }
+
+private:
+    QSharedPointer<ProblemSolver<double> > m_solver;
+    int m_timeStep;
+    QString m_error;
+};
+
+void Problem::solveBlocksConcurrently(const QList<Block *> &blocks, QMap<Block *, QSharedPointer<ProblemSolver<double> > > &solvers)
+{
+    if (blocks.isEmpty())
+        return;
+
+    if (blocks.size() == 1)
+    {
+        solvers[blocks.first()]->solveSimplePrepared(actualTimeStep(), 0);
+        return;
+    }
+
+    // assembly threads are divided between blocks
+    int numThreads = Agros2D::configComputer()->value(Config::Config_NumberOfThreads).toInt();
+    Hermes::HermesCommonApi.set_integral_param_value(Hermes::numThreads, qMax(1, numThreads / blocks.size()));
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(blocks.size());
+
+    QList<BlockSolverRunnable *> runnables;
+    foreach (Block *block, blocks)
+    {
+        BlockSolverRunnable *runnable = new BlockSolverRunnable(solvers[block], actualTimeStep());
+        runnable->setAutoDelete(false);
+        runnables.append(runnable);
+
+        pool.start(runnable);
+    }
+    pool.waitForDone();
+
+    Hermes::HermesCommonApi.set_integral_param_value(Hermes::numThreads, numThreads);
+
+    QString error;
+    foreach (BlockSolverRunnable *runnable, runnables)
+    {
+        if (error.isEmpty())
+            error = runnable->error();
+        delete runnable;
+    }
+
+    if (!error.isEmpty())
+        throw AgrosSolverException(error);
+}
+
 void Problem::stepMessage(Block* block)
 {
     // log analysis
@@ -1050,7 +1207,7 @@ void Problem::readSolutionsFromFile()
 {
     Agros2D::log()->printMessage(tr("Problem"), tr("Loading spaces and solutions from disk"));
 
-    if (QFile::exists(QString("%1/runtime.xml").arg(cacheProblemDir())))
+    if (SolutionStore::hasRunTimeDetails())
     {
         // load structure
         Agros2D::solutionStore()->loadRunTimeDetails();
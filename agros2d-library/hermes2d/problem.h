@@ -16,6 +16,9 @@ class ProblemConfig;
 class ProblemSetting;
 class PyProblem;
 
+template <typename Scalar>
+class ProblemSolver;
+
 class CalculationThread : public QThread
 {
    Q_OBJECT
@@ -201,6 +204,13 @@ private:
     void solve(bool commandLine);
     void solveAction(); // called by solve, can throw SolverException
 
+    // blocks in one level do not depend on each other (sources of weak coupling are in lower levels)
+    QList<QList<Block *> > blockLevels() const;
+    bool isConcurrentBlock(Block *block) const;
+    void solveBlock(Block *block, QSharedPointer<ProblemSolver<double> > solver);
+    // prepared blocks (ProblemSolver::prepareSimple) are solved in worker threads
+    void solveBlocksConcurrently(const QList<Block *> &blocks, QMap<Block *, QSharedPointer<ProblemSolver<double> > > &solvers);
+
     void stepMessage(Block* block);    
 
     friend class CalculationThread;
@@ -259,6 +259,7 @@ void ProblemSetting::setStringKeys()
     m_settingKey[View_ParticleCustomForceZ] = "View_ParticleCustomForceZ";
     m_settingKey[View_ParticleP2PElectricForce] = "View_ParticleP2PElectricForce";
     m_settingKey[View_ParticleP2PMagneticForce] = "View_ParticleP2PMagneticForce";
+    m_settingKey[View_ParticleP2POpeningAngle] = "View_ParticleP2POpeningAngle";
     m_settingKey[View_ChartStartX] = "View_ChartStartX";
     m_settingKey[View_ChartStartY] = "View_ChartStartY";
     m_settingKey[View_ChartEndX] = "View_ChartEndX";
@@ -348,6 +349,7 @@ void ProblemSetting::setDefaultValues()
     m_settingDefault[View_ParticleCustomForceZ] = 0.0;
     m_settingDefault[View_ParticleP2PElectricForce] = false;
     m_settingDefault[View_ParticleP2PMagneticForce] = false;
+    m_settingDefault[View_ParticleP2POpeningAngle] = 0.0;
     m_settingDefault[View_ChartStartX] = 0.0;
     m_settingDefault[View_ChartStartY] = 0.0;
     m_settingDefault[View_ChartEndX] = 0.0;
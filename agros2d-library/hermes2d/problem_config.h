@@ -194,6 +194,7 @@ public:
         View_ParticleCustomForceZ,
         View_ParticleP2PElectricForce,
         View_ParticleP2PMagneticForce,
+        View_ParticleP2POpeningAngle,
         View_ChartStartX,
         View_ChartStartY,
         View_ChartEndX,
@@ -33,6 +33,48 @@
 
 using namespace Hermes::Hermes2D;
 
+static QString runTimeJournalFileName() { return QString("%1/runtime.journal").arg(cacheProblemDir()); }
+static QString runTimeXMLFileName() { return QString("%1/runtime.xml").arg(cacheProblemDir()); }
+
+// write-behind pipeline
+const int SOLUTION_WRITER_THREADS = 2;
+const int SOLUTION_WRITER_MAX_PENDING = 4;
+
+// writes own copies of solutions (stored solutions stay available to the solver)
+class SolutionWriter : public QRunnable
+{
+public:
+    SolutionWriter(SolutionStore *store, FieldSolutionID solutionID,
+                   Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > solutions, QStringList fileNames)
+        : m_store(store), m_solutionID(solutionID), m_solutions(solutions), m_fileNames(fileNames) {}
+
+    void run()
+    {
+        QString error;
+
+        try
+        {
+            for (int i = 0; i < m_fileNames.size(); i++)
+                dynamic_cast<Hermes::Hermes2D::Solution<double> *>(m_solutions.at(i).get())->save_bson(m_fileNames.at(i).toStdString().c_str());
+        }
+        catch (Hermes::Exceptions::Exception &e)
+        {
+            error = QString::fromStdString(e.info());
+        }
+
+        // release copies before finishing
+        m_solutions.clear();
+
+        m_store->finishWrite(m_solutionID, error);
+    }
+
+private:
+    SolutionStore *m_store;
+    FieldSolutionID m_solutionID;
+    Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > m_solutions;
+    QStringList m_fileNames;
+};
+
 void SolutionStore::printDebugCacheStatus()
 {
     assert(m_multiSolutionCacheIDOrder.size() == m_multiSolutionCache.keys().size());
@@ -44,11 +86,45 @@ void SolutionStore::printDebugCacheStatus()
     }
 }
 
+SolutionStore::SolutionStore() : m_mutex(QMutex::Recursive), m_multiSolutionCacheTotalMemory(0)
+{
+    m_writerPool.setMaxThreadCount(SOLUTION_WRITER_THREADS);
+}
+
 SolutionStore::~SolutionStore()
 {
     clearAll();
 }
 
+void SolutionStore::flush()
+{
+    QMutexLocker locker(&m_pendingWritesMutex);
+    while (!m_pendingWrites.isEmpty())
+        m_pendingWritesCondition.wait(&m_pendingWritesMutex);
+
+    foreach (QString error, m_writeErrors)
+        Agros2D::log()->printError(QObject::tr("Solver"), error);
+    m_writeErrors.clear();
+}
+
+void SolutionStore::waitForWrite(FieldSolutionID solutionID)
+{
+    QMutexLocker locker(&m_pendingWritesMutex);
+    while (m_pendingWrites.contains(solutionID))
+        m_pendingWritesCondition.wait(&m_pendingWritesMutex);
+}
+
+void SolutionStore::finishWrite(FieldSolutionID solutionID, const QString &error)
+{
+    // called from writer thread
+    QMutexLocker locker(&m_pendingWritesMutex);
+    m_pendingWrites.remove(solutionID);
+    if (!error.isEmpty())
+        m_writeErrors.append(error);
+
+    m_pendingWritesCondition.wakeAll();
+}
+
 QString SolutionStore::baseStoreFileName(FieldSolutionID solutionID) const
 {
     QString fn = QString("%1/%2").
@@ -60,30 +136,41 @@ QString SolutionStore::baseStoreFileName(FieldSolutionID solutionID) const
 
 void SolutionStore::clearAll()
 {
+    QMutexLocker lock(&m_mutex);
+
+    flush();
+
     // fast remove of all files
     foreach (FieldSolutionID sid, m_multiSolutions)
         removeSolution(sid, false);
 
+    // pins of solutions, which were not stored
+    m_pinnedSolutions.clear();
+
     // remove runtime
-    QString fn = QString("%1/runtime.xml").arg(cacheProblemDir());
-    if (QFile::exists(fn))
-        QFile::remove(fn);
+    if (QFile::exists(runTimeXMLFileName()))
+        QFile::remove(runTimeXMLFileName());
+    if (QFile::exists(runTimeJournalFileName()))
+        QFile::remove(runTimeJournalFileName());
 
     assert(m_multiSolutions.isEmpty());
+    assert(m_multiSolutionSet.isEmpty());
     assert(m_multiSolutionRunTimeDetails.isEmpty());
     assert(m_multiSolutionCache.isEmpty());
 }
 
 MultiArray<double> SolutionStore::multiArray(FieldSolutionID solutionID)
 {
+    QMutexLocker lock(&m_mutex);
+
     if(solutionID.solutionMode == SolutionMode_Finer)
     {
         solutionID.solutionMode = SolutionMode_Reference;
-        if(!m_multiSolutions.contains(solutionID))
+        if(!contains(solutionID))
             solutionID.solutionMode = SolutionMode_Normal;
     }
 
-    assert(m_multiSolutions.contains(solutionID));
+    assert(contains(solutionID));
 
     if (!m_multiSolutionCache.contains(solutionID))
     {
@@ -177,17 +264,25 @@ MultiArray<double> SolutionStore::multiArray(FieldSolutionID solutionID)
     }
     else
     {
+        // least recently used solution is evicted first
+        m_multiSolutionCacheIDOrder.removeOne(solutionID);
+        m_multiSolutionCacheIDOrder.append(solutionID);
+
         return m_multiSolutionCache[solutionID];
     }
 }
 
 bool SolutionStore::contains(FieldSolutionID solutionID) const
 {
-    return m_multiSolutions.contains(solutionID);
+    QMutexLocker lock(&m_mutex);
+
+    return m_multiSolutionSet.contains(solutionID);
 }
 
 MultiArray<double> SolutionStore::multiArray(BlockSolutionID solutionID)
 {
+    QMutexLocker lock(&m_mutex);
+
     MultiArray<double> ma;
     foreach (Field *field, solutionID.group->fields())
     {
@@ -201,7 +296,7 @@ MultiArray<double> SolutionStore::multiArray(BlockSolutionID solutionID)
 void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> multiSolution, SolutionRunTimeDetails runTime)
 {
     // qDebug() << "saving solution " << solutionID;
-    assert(!m_multiSolutions.contains(solutionID));
+    assert(!contains(solutionID));
     assert(solutionID.timeStep >= 0);
     assert(solutionID.adaptivityStep >= 0);
 
@@ -263,17 +358,17 @@ void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> m
         }
     }
 
-    // solutions
+    // solutions (written in background, meshes and spaces can be changed by the solver later)
+    // copies are written, the solver can still use stored solutions (e.g. as previous time step)
+    QStringList solutionFileNames;
+    Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > solutionsToWrite;
     for (int i = 0; i < multiSolution.size(); i++)
     {
         if (fileNames[i].solutionFileName().isEmpty())
         {
             QString solutionFN = QString("%1_%2.sln").arg(baseFN).arg(i);
-            // QTime time;
-            // time.start();
-            // dynamic_cast<Hermes::Hermes2D::Solution<double> *>(multiSolution.solutions().at(i).get())->save(solutionFN.toLatin1().data());
-            dynamic_cast<Hermes::Hermes2D::Solution<double> *>(multiSolution.solutions().at(i).get())->save_bson(compatibleFilename(solutionFN).toStdString().c_str());
-            // qDebug() << "SAVE" << time.elapsed();
+            solutionFileNames.append(compatibleFilename(solutionFN));
+            solutionsToWrite.push_back(multiSolution.solutions().at(i)->clone());
 
             fileNames[i].setSolutionFileName(QFileInfo(solutionFN).fileName());
         }
@@ -283,6 +378,7 @@ void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> m
 
     // append multisolution
     m_multiSolutions.append(solutionID);
+    insertToIndex(solutionID);
 
     // append properties
     m_multiSolutionRunTimeDetails.insert(solutionID, runTime);
@@ -292,8 +388,18 @@ void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> m
 
     //printDebugCacheStatus();
 
-    // save run time details to the file
-    saveRunTimeDetails();
+    // write solutions in background (bounded number of pending solutions)
+    {
+        QMutexLocker locker(&m_pendingWritesMutex);
+        while (m_pendingWrites.count() >= SOLUTION_WRITER_MAX_PENDING)
+            m_pendingWritesCondition.wait(&m_pendingWritesMutex);
+
+        m_pendingWrites.insert(solutionID);
+    }
+    m_writerPool.start(new SolutionWriter(this, solutionID, solutionsToWrite, solutionFileNames));
+
+    // append run time details to the journal
+    appendRunTimeDetailsToJournal(solutionID, runTime);
 
     // save to the memory info (for debug purposes)
     // m_memoryInfos[solutionID] = tr1::shared_ptr<MemoryInfo>(new MemoryInfo(multiSolution));
@@ -301,20 +407,21 @@ void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> m
 
 void SolutionStore::removeSolution(FieldSolutionID solutionID, bool saveRunTime)
 {
-    assert(m_multiSolutions.contains(solutionID));
+    assert(contains(solutionID));
+
+    // files can be removed after they are written
+    waitForWrite(solutionID);
 
     // remove from list
     m_multiSolutions.removeOne(solutionID);
+    removeFromIndex(solutionID);
     // remove properties
     m_multiSolutionRunTimeDetails.remove(solutionID);
     // remove from cache
     if (m_multiSolutionCache.contains(solutionID))
-    {
-        // free ma
-        m_multiSolutionCache[solutionID].clear();
-        m_multiSolutionCache.remove(solutionID);
-        m_multiSolutionCacheIDOrder.removeOne(solutionID);
-    }
+        removeMultiSolutionFromCache(solutionID);
+    // remove pin
+    m_pinnedSolutions.remove(solutionID);
 
     // remove old files
     QFileInfo info(Agros2D::problem()->config()->fileName());
@@ -338,13 +445,15 @@ void SolutionStore::removeSolution(FieldSolutionID solutionID, bool saveRunTime)
         }
     }
 
-    // save structure to the file
+    // append removal to the journal
     if (saveRunTime)
-        saveRunTimeDetails();
+        appendRemovalToJournal(solutionID);
 }
 
 void SolutionStore::addSolution(BlockSolutionID blockSolutionID, MultiArray<double> multiSolution, SolutionRunTimeDetails runTime)
 {
+    QMutexLocker lock(&m_mutex);
+
     foreach (Field* field, blockSolutionID.group->fields())
     {
         FieldSolutionID fieldSID = blockSolutionID.fieldSolutionID(field->fieldInfo());
@@ -357,6 +466,8 @@ void SolutionStore::addSolution(BlockSolutionID blockSolutionID, MultiArray<doub
 
 void SolutionStore::removeSolution(BlockSolutionID solutionID)
 {
+    QMutexLocker lock(&m_mutex);
+
     foreach(Field* field, solutionID.group->fields())
     {
         FieldSolutionID fieldSID = solutionID.fieldSolutionID(field->fieldInfo());
@@ -366,6 +477,8 @@ void SolutionStore::removeSolution(BlockSolutionID solutionID)
 
 void SolutionStore::removeTimeStep(int timeStep)
 {
+    QMutexLocker lock(&m_mutex);
+
     foreach (FieldSolutionID sid, m_multiSolutions)
     {
         if (sid.timeStep == timeStep)
@@ -374,20 +487,74 @@ void SolutionStore::removeTimeStep(int timeStep)
 
 }
 
-int SolutionStore::lastTimeStep(const FieldInfo *fieldInfo, SolutionMode solutionType) const
+void SolutionStore::insertToIndex(FieldSolutionID solutionID)
 {
-    int timeStep = NOT_FOUND_SO_FAR;
-    foreach (FieldSolutionID sid, m_multiSolutions)
+    m_multiSolutionSet.insert(solutionID);
+
+    FieldSolutionIndex &index = m_multiSolutionIndex[solutionID.group];
+    index.steps[solutionID.solutionMode].insert(qMakePair(solutionID.timeStep, solutionID.adaptivityStep), solutionID);
+    index.timeSteps[solutionID.timeStep]++;
+
+    if ((solutionID.solutionMode == SolutionMode_Normal) && (solutionID.adaptivityStep == 0))
     {
-        if((sid.group == fieldInfo) && (sid.solutionMode == solutionType) && (sid.timeStep > timeStep))
-            timeStep = sid.timeStep;
+        // time steps are usually appended
+        QVector<int>::iterator it = std::lower_bound(index.calculatedTimeSteps.begin(), index.calculatedTimeSteps.end(), solutionID.timeStep);
+        index.calculatedTimeSteps.insert(it, solutionID.timeStep);
     }
+}
 
-    return timeStep;
+void SolutionStore::removeFromIndex(FieldSolutionID solutionID)
+{
+    m_multiSolutionSet.remove(solutionID);
+
+    FieldSolutionIndex &index = m_multiSolutionIndex[solutionID.group];
+    index.steps[solutionID.solutionMode].remove(qMakePair(solutionID.timeStep, solutionID.adaptivityStep));
+    if (index.steps[solutionID.solutionMode].isEmpty())
+        index.steps.remove(solutionID.solutionMode);
+
+    if (--index.timeSteps[solutionID.timeStep] == 0)
+        index.timeSteps.remove(solutionID.timeStep);
+
+    if ((solutionID.solutionMode == SolutionMode_Normal) && (solutionID.adaptivityStep == 0))
+    {
+        QVector<int>::iterator it = std::lower_bound(index.calculatedTimeSteps.begin(), index.calculatedTimeSteps.end(), solutionID.timeStep);
+        assert((it != index.calculatedTimeSteps.end()) && (*it == solutionID.timeStep));
+        index.calculatedTimeSteps.erase(it);
+    }
+
+    if (index.timeSteps.isEmpty())
+        m_multiSolutionIndex.remove(solutionID.group);
+}
+
+const QMap<QPair<int, int>, FieldSolutionID> *SolutionStore::solutionSteps(const FieldInfo *fieldInfo, SolutionMode solutionType) const
+{
+    QMap<const FieldInfo *, FieldSolutionIndex>::const_iterator itIndex = m_multiSolutionIndex.constFind(fieldInfo);
+    if (itIndex == m_multiSolutionIndex.constEnd())
+        return NULL;
+
+    QMap<SolutionMode, QMap<QPair<int, int>, FieldSolutionID> >::const_iterator itSteps = itIndex.value().steps.constFind(solutionType);
+    if (itSteps == itIndex.value().steps.constEnd())
+        return NULL;
+
+    return &itSteps.value();
+}
+
+int SolutionStore::lastTimeStep(const FieldInfo *fieldInfo, SolutionMode solutionType) const
+{
+    QMutexLocker lock(&m_mutex);
+
+    const QMap<QPair<int, int>, FieldSolutionID> *steps = solutionSteps(fieldInfo, solutionType);
+    if (!steps)
+        return NOT_FOUND_SO_FAR;
+
+    // last (time step, adaptivity step)
+    return steps->lastKey().first;
 }
 
 int SolutionStore::lastTimeStep(const Block *block, SolutionMode solutionType) const
 {
+    QMutexLocker lock(&m_mutex);
+
     int timeStep = lastTimeStep(block->fields().at(0)->fieldInfo(), solutionType);
 
     foreach(Field* field, block->fields())
@@ -400,6 +567,8 @@ int SolutionStore::lastTimeStep(const Block *block, SolutionMode solutionType) c
 
 MultiArray<double> SolutionStore::multiSolutionPreviousCalculatedTS(BlockSolutionID solutionID)
 {
+    QMutexLocker lock(&m_mutex);
+
     MultiArray<double> ma;
     foreach(Field *field, solutionID.group->fields())
     {
@@ -415,54 +584,49 @@ MultiArray<double> SolutionStore::multiSolutionPreviousCalculatedTS(BlockSolutio
 
 int SolutionStore::nthCalculatedTimeStep(const FieldInfo *fieldInfo, int n) const
 {
-    int count = 0;
-    for(int step = 0; step <= lastTimeStep(fieldInfo, SolutionMode_Normal); step++)
-    {
-        if(this->contains(FieldSolutionID(fieldInfo, step, 0, SolutionMode_Normal)))
-            count++;
+    QMutexLocker lock(&m_mutex);
 
-        // n is counted from zero
-        if(count == n + 1)
-            return step;
-    }
+    assert(m_multiSolutionIndex.contains(fieldInfo));
+
+    // n is counted from zero
+    const QVector<int> &calculatedTimeSteps = m_multiSolutionIndex.constFind(fieldInfo).value().calculatedTimeSteps;
+    assert((n >= 0) && (n < calculatedTimeSteps.size()));
 
-    assert(0);
+    return calculatedTimeSteps.at(n);
 }
 
 
 int SolutionStore::nearestTimeStep(const FieldInfo *fieldInfo, int timeStep) const
 {
-    int ts = timeStep;
-    while (!this->contains(FieldSolutionID(fieldInfo, ts, 0, SolutionMode_Normal)))
-    {
-        ts--;
-        if (ts <= 0)
-            return 0;
-    }
-    return ts;
+    QMutexLocker lock(&m_mutex);
+
+    QMap<const FieldInfo *, FieldSolutionIndex>::const_iterator itIndex = m_multiSolutionIndex.constFind(fieldInfo);
+    if (itIndex == m_multiSolutionIndex.constEnd())
+        return 0;
+
+    // last calculated time step not greater than timeStep
+    const QVector<int> &calculatedTimeSteps = itIndex.value().calculatedTimeSteps;
+    QVector<int>::const_iterator it = std::upper_bound(calculatedTimeSteps.begin(), calculatedTimeSteps.end(), timeStep);
+    if (it == calculatedTimeSteps.begin())
+        return 0;
+
+    return qMax(0, *(it - 1));
 }
 
 double SolutionStore::lastTime(const FieldInfo *fieldInfo)
 {
+    QMutexLocker lock(&m_mutex);
+
     int timeStep = lastTimeStep(fieldInfo, SolutionMode_Normal);
-    double time = NOT_FOUND_SO_FAR;
+    assert(timeStep != NOT_FOUND_SO_FAR);
 
-    foreach (FieldSolutionID id, m_multiSolutions)
-    {
-        if ((id.group == fieldInfo) && (id.timeStep == timeStep))
-        {
-            if (time == NOT_FOUND_SO_FAR)
-                time = Agros2D::problem()->timeStepToTotalTime(id.timeStep);
-            else
-                assert(time == Agros2D::problem()->timeStepToTotalTime(id.timeStep));
-        }
-    }
-    assert(time != NOT_FOUND_SO_FAR);
-    return time;
+    return Agros2D::problem()->timeStepToTotalTime(timeStep);
 }
 
 double SolutionStore::lastTime(const Block *block)
 {
+    QMutexLocker lock(&m_mutex);
+
     double time = lastTime(block->fields().at(0)->fieldInfo());
 
     foreach(Field* field, block->fields())
@@ -476,21 +640,31 @@ double SolutionStore::lastTime(const Block *block)
 
 int SolutionStore::lastAdaptiveStep(const FieldInfo *fieldInfo, SolutionMode solutionType, int timeStep) const
 {
+    QMutexLocker lock(&m_mutex);
+
     if (timeStep == -1)
         timeStep = lastTimeStep(fieldInfo, solutionType);
 
-    int adaptiveStep = NOT_FOUND_SO_FAR;
-    foreach (FieldSolutionID sid, m_multiSolutions)
-    {
-        if ((sid.group == fieldInfo) && (sid.solutionMode == solutionType) && (sid.timeStep == timeStep) && (sid.adaptivityStep > adaptiveStep))
-            adaptiveStep = sid.adaptivityStep;
-    }
+    const QMap<QPair<int, int>, FieldSolutionID> *steps = solutionSteps(fieldInfo, solutionType);
+    if (!steps)
+        return NOT_FOUND_SO_FAR;
 
-    return adaptiveStep;
+    // last entry before the first adaptivity step of the next time step (adaptivity steps are not negative)
+    QMap<QPair<int, int>, FieldSolutionID>::const_iterator it = steps->lowerBound(qMakePair(timeStep + 1, 0));
+    if (it == steps->constBegin())
+        return NOT_FOUND_SO_FAR;
+
+    --it;
+    if (it.key().first != timeStep)
+        return NOT_FOUND_SO_FAR;
+
+    return it.key().second;
 }
 
 int SolutionStore::lastAdaptiveStep(const Block *block, SolutionMode solutionType, int timeStep) const
 {
+    QMutexLocker lock(&m_mutex);
+
     int adaptiveStep = lastAdaptiveStep(block->fields().at(0)->fieldInfo(), solutionType, timeStep);
 
     foreach(Field* field, block->fields())
@@ -503,6 +677,8 @@ int SolutionStore::lastAdaptiveStep(const Block *block, SolutionMode solutionTyp
 
 FieldSolutionID SolutionStore::lastTimeAndAdaptiveSolution(const FieldInfo *fieldInfo, SolutionMode solutionType)
 {
+    QMutexLocker lock(&m_mutex);
+
     FieldSolutionID solutionID;
     if (solutionType == SolutionMode_Finer) {
         FieldSolutionID solutionIDNormal = lastTimeAndAdaptiveSolution(fieldInfo, SolutionMode_Normal);
@@ -530,6 +706,8 @@ FieldSolutionID SolutionStore::lastTimeAndAdaptiveSolution(const FieldInfo *fiel
 
 BlockSolutionID SolutionStore::lastTimeAndAdaptiveSolution(const Block *block, SolutionMode solutionType)
 {
+    QMutexLocker lock(&m_mutex);
+
     FieldSolutionID fsid = lastTimeAndAdaptiveSolution(block->fields().at(0)->fieldInfo(), solutionType);
     BlockSolutionID bsid = fsid.blockSolutionID(block);
 
@@ -544,14 +722,18 @@ BlockSolutionID SolutionStore::lastTimeAndAdaptiveSolution(const Block *block, S
 
 QList<double> SolutionStore::timeLevels(const FieldInfo *fieldInfo) const
 {
+    QMutexLocker lock(&m_mutex);
+
     QList<double> list;
 
-    foreach(FieldSolutionID fsid, m_multiSolutions)
+    QMap<const FieldInfo *, FieldSolutionIndex>::const_iterator itIndex = m_multiSolutionIndex.constFind(fieldInfo);
+    if (itIndex != m_multiSolutionIndex.constEnd())
     {
-        if (fsid.group == fieldInfo)
+        // ordered time steps
+        foreach (int timeStep, itIndex.value().timeSteps.keys())
         {
-            double time = Agros2D::problem()->timeStepToTotalTime(fsid.timeStep);
-            if (!list.contains(time))
+            double time = Agros2D::problem()->timeStepToTotalTime(timeStep);
+            if (list.isEmpty() || list.last() != time)
                 list.push_back(time);
         }
     }
@@ -561,6 +743,8 @@ QList<double> SolutionStore::timeLevels(const FieldInfo *fieldInfo) const
 
 int SolutionStore::timeLevelIndex(const FieldInfo *fieldInfo, double time)
 {
+    QMutexLocker lock(&m_mutex);
+
     int level = -1;
     QList<double> levels = timeLevels(fieldInfo);
     if(levels.isEmpty())
@@ -577,43 +761,146 @@ int SolutionStore::timeLevelIndex(const FieldInfo *fieldInfo, double time)
 
 double SolutionStore::timeLevel(const FieldInfo *fieldInfo, int timeLevelIndex)
 {
+    QMutexLocker lock(&m_mutex);
+
     QList<double> levels = timeLevels(fieldInfo);
     if (timeLevelIndex >= 0 && timeLevelIndex < levels.count())
         return levels.at(timeLevelIndex);
 }
 
-void SolutionStore::insertMultiSolutionToCache(FieldSolutionID solutionID, MultiArray<double> multiSolution)
+// estimated memory of solution (meshes and spaces shared by more solutions are counted for each of them)
+static qint64 multiSolutionMemory(MultiArray<double> multiSolution)
 {
-    if (!m_multiSolutionCache.contains(solutionID))
+    qint64 memory = 0;
+    for (int i = 0; i < multiSolution.size(); i++)
     {
-        // flush cache
-        if (m_multiSolutionCache.count() > Agros2D::configComputer()->value(Config::Config_CacheSize).toInt())
-        {
-            assert(! m_multiSolutionCacheIDOrder.empty());
-            FieldSolutionID idRemove = m_multiSolutionCacheIDOrder[0];
-            m_multiSolutionCacheIDOrder.removeFirst();
+        qint64 numDOFs = multiSolution.spaces().at(i)->get_num_dofs();
+        qint64 numElements = multiSolution.spaces().at(i)->get_mesh()->get_num_active_elements();
 
-            // free ma
-            m_multiSolutionCache[idRemove].clear();
-            m_multiSolutionCache.remove(idRemove);
-        }
+        // solution coefficients, space and mesh data
+        memory += numDOFs * 4 * sizeof(double) + numElements * (sizeof(Hermes::Hermes2D::Element) + 256);
+    }
+
+    return memory;
+}
+
+void SolutionStore::pinSolution(FieldSolutionID solutionID)
+{
+    QMutexLocker lock(&m_mutex);
 
+    m_pinnedSolutions[solutionID]++;
+}
+
+void SolutionStore::unpinSolution(FieldSolutionID solutionID)
+{
+    QMutexLocker lock(&m_mutex);
+
+    // solution can be removed in the meantime
+    if (m_pinnedSolutions.contains(solutionID) && (--m_pinnedSolutions[solutionID] == 0))
+        m_pinnedSolutions.remove(solutionID);
+}
+
+void SolutionStore::insertMultiSolutionToCache(FieldSolutionID solutionID, MultiArray<double> multiSolution)
+{
+    if (!m_multiSolutionCache.contains(solutionID))
+    {
         // add solution
+        qint64 memory = multiSolutionMemory(multiSolution);
+
         m_multiSolutionCache.insert(solutionID, multiSolution);
         m_multiSolutionCacheIDOrder.append(solutionID);
+        m_multiSolutionCacheMemory.insert(solutionID, memory);
+        m_multiSolutionCacheTotalMemory += memory;
+
+        // flush cache (least recently used first)
+        qint64 cacheSize = qint64(Agros2D::configComputer()->value(Config::Config_CacheMemorySize).toInt()) * 1024 * 1024;
+
+        int index = 0;
+        while ((m_multiSolutionCacheTotalMemory > cacheSize) && (index < m_multiSolutionCacheIDOrder.size()))
+        {
+            FieldSolutionID idRemove = m_multiSolutionCacheIDOrder[index];
+
+            // inserted solution and solutions needed by the solver stay in the cache
+            if ((idRemove == solutionID) || m_pinnedSolutions.contains(idRemove))
+            {
+                index++;
+                continue;
+            }
+
+            // file is not complete until written (solution cannot be read back yet)
+            waitForWrite(idRemove);
+
+            removeMultiSolutionFromCache(idRemove);
+        }
     }
 }
 
+void SolutionStore::removeMultiSolutionFromCache(FieldSolutionID solutionID)
+{
+    assert(m_multiSolutionCache.contains(solutionID));
+
+    // free ma
+    m_multiSolutionCache[solutionID].clear();
+    m_multiSolutionCache.remove(solutionID);
+    m_multiSolutionCacheIDOrder.removeOne(solutionID);
+
+    m_multiSolutionCacheTotalMemory -= m_multiSolutionCacheMemory[solutionID];
+    m_multiSolutionCacheMemory.remove(solutionID);
+}
+
+bool SolutionStore::hasRunTimeDetails()
+{
+    return (QFile::exists(runTimeJournalFileName()) || QFile::exists(runTimeXMLFileName()));
+}
+
 void SolutionStore::loadRunTimeDetails()
 {
-    QString fn = QString("%1/runtime.xml").arg(cacheProblemDir());
+    QMutexLocker lock(&m_mutex);
 
+    QList<FieldSolutionID> solutionIDs;
+    QMap<FieldSolutionID, SolutionRunTimeDetails> runTimes;
+
+    // journal is up to date, runtime.xml is read from files saved without journal
+    bool isJournal = QFile::exists(runTimeJournalFileName());
+    if (isJournal)
+        readRunTimeJournal(solutionIDs, runTimes);
+    else
+        readRunTimeXML(solutionIDs, runTimes);
+
+    int time_step = 0;
+    foreach (FieldSolutionID solutionID, solutionIDs)
+    {
+        SolutionRunTimeDetails runTime = runTimes[solutionID];
+
+        // append multisolution
+        m_multiSolutions.append(solutionID);
+        insertToIndex(solutionID);
+
+        // TODO: remove "problem time step structures"
+        // define transient time step
+        if (solutionID.timeStep > time_step)
+        {
+            // new time step
+            time_step = solutionID.timeStep;
+
+            Agros2D::problem()->defineActualTimeStepLength(runTime.timeStepLength());
+        }
+
+        // append run time details
+        m_multiSolutionRunTimeDetails.insert(solutionID, runTime);
+    }
+
+    if (!isJournal)
+        compactRunTimeJournal();
+}
+
+void SolutionStore::readRunTimeXML(QList<FieldSolutionID> &solutionIDs, QMap<FieldSolutionID, SolutionRunTimeDetails> &runTimes)
+{
     try
     {
-        std::auto_ptr<XMLStructure::structure> structure_xsd = XMLStructure::structure_(compatibleFilename(fn).toStdString(), xml_schema::flags::dont_validate);
+        std::auto_ptr<XMLStructure::structure> structure_xsd = XMLStructure::structure_(compatibleFilename(runTimeXMLFileName()).toStdString(), xml_schema::flags::dont_validate);
         XMLStructure::structure *structure = structure_xsd.get();
 
-        int time_step = 0;
         for (unsigned int i = 0; i < structure->element_data().size(); i++)
         {
             XMLStructure::element_data data = structure->element_data().at(i);
@@ -626,18 +913,6 @@ void SolutionStore::loadRunTimeDetails()
                                        data.time_step(),
                                        data.adaptivity_step(),
                                        solutionTypeFromStringKey(QString::fromStdString(data.solution_type())));
-            // append multisolution
-            m_multiSolutions.append(solutionID);
-
-            // TODO: remove "problem time step structures"
-            // define transient time step
-            if (data.time_step() > time_step)
-            {
-                // new time step
-                time_step = data.time_step();
-
-                Agros2D::problem()->defineActualTimeStepLength(data.time_step_length().get());
-            }
 
             QList<SolutionRunTimeDetails::FileName> fileNames;
             for (int j = 0; j < data.files().file().size(); j++)
@@ -654,9 +929,8 @@ void SolutionStore::loadRunTimeDetails()
                                            data.dofs().get());
             runTime.setFileNames(fileNames);
 
-            // append run time details
-            m_multiSolutionRunTimeDetails.insert(solutionID,
-                                                 runTime);
+            solutionIDs.append(solutionID);
+            runTimes.insert(solutionID, runTime);
         }
     }
     catch (const xml_schema::exception& e)
@@ -665,9 +939,175 @@ void SolutionStore::loadRunTimeDetails()
     }
 }
 
+void SolutionStore::readRunTimeJournal(QList<FieldSolutionID> &solutionIDs, QMap<FieldSolutionID, SolutionRunTimeDetails> &runTimes)
+{
+    QFile file(runTimeJournalFileName());
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        throw AgrosException(QObject::tr("Could not read run time journal '%1'.").arg(runTimeJournalFileName()));
+
+    // replay records, later record replaces the previous one
+    QTextStream in(&file);
+    while (!in.atEnd())
+    {
+        QStringList record = in.readLine().split("\t");
+
+        // unfinished record (interrupted write)
+        if (record.size() < 5)
+            continue;
+
+        // check field
+        QString fieldId = record.at(1);
+        if (!Agros2D::problem()->hasField(fieldId))
+            throw AgrosException(QObject::tr("Field '%1' info mismatch.").arg(fieldId));
+
+        FieldSolutionID solutionID(Agros2D::problem()->fieldInfo(fieldId),
+                                   record.at(2).toInt(),
+                                   record.at(3).toInt(),
+                                   solutionTypeFromStringKey(record.at(4)));
+
+        if (record.at(0) == "R")
+        {
+            solutionIDs.removeOne(solutionID);
+            runTimes.remove(solutionID);
+        }
+        else if (record.at(0) == "A")
+        {
+            int pos = 5;
+            if (record.size() < pos + 5)
+                continue;
+
+            SolutionRunTimeDetails runTime(record.at(pos).toDouble(),
+                                           record.at(pos + 1).toDouble(),
+                                           record.at(pos + 2).toInt());
+            runTime.setJacobianCalculations(record.at(pos + 3).toInt());
+            pos += 4;
+
+            bool isValid = true;
+
+            QList<SolutionRunTimeDetails::FileName> fileNames;
+            int numFiles = record.at(pos++).toInt();
+            isValid = isValid && (record.size() >= pos + 3 * numFiles + 1);
+            for (int i = 0; isValid && i < numFiles; i++, pos += 3)
+                fileNames.append(SolutionRunTimeDetails::FileName(record.at(pos), record.at(pos + 1), record.at(pos + 2)));
+            runTime.setFileNames(fileNames);
+
+            // newton residuals, damping coefficients, relative changes of solutions
+            QVector<double> vectors[3];
+            for (int v = 0; isValid && v < 3; v++)
+            {
+                isValid = isValid && (record.size() >= pos + 1);
+                if (!isValid)
+                    break;
+
+                int size = record.at(pos++).toInt();
+                isValid = isValid && (record.size() >= pos + size);
+                for (int i = 0; isValid && i < size; i++)
+                    vectors[v].append(record.at(pos++).toDouble());
+            }
+
+            if (!isValid)
+                continue;
+
+            runTime.setNewtonResidual(vectors[0]);
+            runTime.setNonlinearDamping(vectors[1]);
+            runTime.setRelativeChangeOfSolutions(vectors[2]);
+
+            if (!runTimes.contains(solutionID))
+                solutionIDs.append(solutionID);
+            runTimes.insert(solutionID, runTime);
+        }
+    }
+}
+
+QString SolutionStore::runTimeJournalRecord(FieldSolutionID solutionID, const SolutionRunTimeDetails &runTime) const
+{
+    QStringList record;
+    record << "A"
+           << solutionID.group->fieldId()
+           << QString::number(solutionID.timeStep)
+           << QString::number(solutionID.adaptivityStep)
+           << solutionTypeToStringKey(solutionID.solutionMode)
+           << QString::number(runTime.timeStepLength(), 'g', 17)
+           << QString::number(runTime.adaptivityError(), 'g', 17)
+           << QString::number(runTime.DOFs())
+           << QString::number(runTime.jacobianCalculations());
+
+    record << QString::number(runTime.fileNames().size());
+    foreach (SolutionRunTimeDetails::FileName fileName, runTime.fileNames())
+        record << fileName.meshFileName() << fileName.spaceFileName() << fileName.solutionFileName();
+
+    QVector<double> vectors[3] = { runTime.newtonResidual(), runTime.nonlinearDamping(), runTime.relativeChangeOfSolutions() };
+    for (int v = 0; v < 3; v++)
+    {
+        record << QString::number(vectors[v].size());
+        foreach (double value, vectors[v])
+            record << QString::number(value, 'g', 17);
+    }
+
+    return record.join("\t");
+}
+
+void SolutionStore::appendRunTimeDetailsToJournal(FieldSolutionID solutionID, const SolutionRunTimeDetails &runTime)
+{
+    appendToJournal(runTimeJournalRecord(solutionID, runTime));
+}
+
+void SolutionStore::appendRemovalToJournal(FieldSolutionID solutionID)
+{
+    QStringList record;
+    record << "R"
+           << solutionID.group->fieldId()
+           << QString::number(solutionID.timeStep)
+           << QString::number(solutionID.adaptivityStep)
+           << solutionTypeToStringKey(solutionID.solutionMode);
+
+    appendToJournal(record.join("\t"));
+}
+
+void SolutionStore::appendToJournal(const QString &record)
+{
+    QFile file(runTimeJournalFileName());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+    {
+        Agros2D::log()->printError(QObject::tr("Solver"), QObject::tr("Could not write run time journal '%1'.").arg(runTimeJournalFileName()));
+        return;
+    }
+
+    QTextStream out(&file);
+    out << record << "\n";
+}
+
+void SolutionStore::compactRunTimeJournal()
+{
+    // rewrite journal with stored solutions only
+    QString fnTemp = runTimeJournalFileName() + ".tmp";
+
+    QFile file(fnTemp);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        Agros2D::log()->printError(QObject::tr("Solver"), QObject::tr("Could not write run time journal '%1'.").arg(fnTemp));
+        return;
+    }
+
+    QTextStream out(&file);
+    foreach (FieldSolutionID solutionID, m_multiSolutions)
+        out << runTimeJournalRecord(solutionID, m_multiSolutionRunTimeDetails[solutionID]) << "\n";
+    out.flush();
+    file.close();
+
+    if (QFile::exists(runTimeJournalFileName()))
+        QFile::remove(runTimeJournalFileName());
+    QFile::rename(fnTemp, runTimeJournalFileName());
+}
+
 void SolutionStore::saveRunTimeDetails()
 {
-    QString fn = QString("%1/runtime.xml").arg(cacheProblemDir());
+    QMutexLocker lock(&m_mutex);
+
+    compactRunTimeJournal();
+
+    // export run time details (readable by previous versions)
+    QString fn = runTimeXMLFileName();
 
     try
     {
@@ -734,10 +1174,12 @@ void SolutionStore::saveRunTimeDetails()
 
 void SolutionStore::multiSolutionRunTimeDetailReplace(FieldSolutionID solutionID, SolutionRunTimeDetails runTime)
 {
+    QMutexLocker lock(&m_mutex);
+
     assert(m_multiSolutionRunTimeDetails.contains(solutionID));
     m_multiSolutionRunTimeDetails[solutionID] = runTime;
 
-    // save structure to the file
-    saveRunTimeDetails();
+    // newer record replaces the previous one
+    appendRunTimeDetailsToJournal(solutionID, runTime);
 }
 
@@ -22,9 +22,12 @@
 
 #include "solutiontypes.h"
 
+class SolutionWriter;
+
 class AGROS_LIBRARY_API SolutionStore
 {
 public:
+    SolutionStore();
     ~SolutionStore();
 
     class SolutionRunTimeDetails
@@ -128,30 +131,83 @@ public:
     FieldSolutionID lastTimeAndAdaptiveSolution(const FieldInfo* fieldInfo, SolutionMode solutionType);
     BlockSolutionID lastTimeAndAdaptiveSolution(const Block *block, SolutionMode solutionType);
 
+    // run time details are stored in append-only journal, runtime.xml is written on save
     void loadRunTimeDetails();
+    void saveRunTimeDetails();
+    static bool hasRunTimeDetails();
 
-    SolutionRunTimeDetails multiSolutionRunTimeDetail(FieldSolutionID solutionID) const { assert(m_multiSolutionRunTimeDetails.contains(solutionID)); return m_multiSolutionRunTimeDetails[solutionID]; }
+    SolutionRunTimeDetails multiSolutionRunTimeDetail(FieldSolutionID solutionID) const { QMutexLocker lock(&m_mutex); assert(m_multiSolutionRunTimeDetails.contains(solutionID)); return m_multiSolutionRunTimeDetails[solutionID]; }
     void multiSolutionRunTimeDetailReplace(FieldSolutionID solutionID, SolutionRunTimeDetails runTime);
 
-    inline bool isEmpty() const { return m_multiSolutions.isEmpty(); }
+    // pinned solutions (previous time levels, coupling sources) are not evicted from the cache
+    void pinSolution(FieldSolutionID solutionID);
+    void unpinSolution(FieldSolutionID solutionID);
+
+    inline bool isEmpty() const { QMutexLocker lock(&m_mutex); return m_multiSolutions.isEmpty(); }
     void clearAll();
 
+    // solution files are written in background, waits until all of them are written
+    void flush();
+
     void printDebugCacheStatus();
 
 private:
+    // blocks can be solved concurrently (recursive, public methods call each other)
+    mutable QMutex m_mutex;
+
+    // index of stored solutions of one field
+    struct FieldSolutionIndex
+    {
+        // ordered by (time step, adaptivity step) for each solution mode
+        QMap<SolutionMode, QMap<QPair<int, int>, FieldSolutionID> > steps;
+        // number of stored solutions in time step (all solution modes)
+        QMap<int, int> timeSteps;
+        // ordered time steps with normal solution in the first adaptivity step
+        QVector<int> calculatedTimeSteps;
+    };
+
     QList<FieldSolutionID> m_multiSolutions;
+    QSet<FieldSolutionID> m_multiSolutionSet;
+    QMap<const FieldInfo *, FieldSolutionIndex> m_multiSolutionIndex;
     QMap<FieldSolutionID, SolutionRunTimeDetails> m_multiSolutionRunTimeDetails;
     QMap<FieldSolutionID, MultiArray<double> > m_multiSolutionCache;
     QList<FieldSolutionID> m_multiSolutionCacheIDOrder;
+    QMap<FieldSolutionID, qint64> m_multiSolutionCacheMemory;
+    qint64 m_multiSolutionCacheTotalMemory;
+    QHash<FieldSolutionID, int> m_pinnedSolutions;
+
+    // write-behind of solution files (copies of solutions are written, pending solutions stay in the cache)
+    QThreadPool m_writerPool;
+    QMutex m_pendingWritesMutex;
+    QWaitCondition m_pendingWritesCondition;
+    QSet<FieldSolutionID> m_pendingWrites;
+    QStringList m_writeErrors;
+
+    void waitForWrite(FieldSolutionID solutionID);
+    void finishWrite(FieldSolutionID solutionID, const QString &error);
 
     void addSolution(FieldSolutionID solutionID, MultiArray<double> multiArray, SolutionRunTimeDetails runTime);
     void removeSolution(FieldSolutionID solutionID, bool saveRunTime = true);
 
+    void insertToIndex(FieldSolutionID solutionID);
+    void removeFromIndex(FieldSolutionID solutionID);
+    const QMap<QPair<int, int>, FieldSolutionID> *solutionSteps(const FieldInfo *fieldInfo, SolutionMode solutionType) const;
+
     void insertMultiSolutionToCache(FieldSolutionID solutionID, MultiArray<double> multiArray);
+    void removeMultiSolutionFromCache(FieldSolutionID solutionID);
 
     QString baseStoreFileName(FieldSolutionID solutionID) const;
 
-    void saveRunTimeDetails();
+    void appendRunTimeDetailsToJournal(FieldSolutionID solutionID, const SolutionRunTimeDetails &runTime);
+    void appendRemovalToJournal(FieldSolutionID solutionID);
+    void appendToJournal(const QString &record);
+    void compactRunTimeJournal();
+    QString runTimeJournalRecord(FieldSolutionID solutionID, const SolutionRunTimeDetails &runTime) const;
+
+    void readRunTimeJournal(QList<FieldSolutionID> &solutionIDs, QMap<FieldSolutionID, SolutionRunTimeDetails> &runTimes);
+    void readRunTimeXML(QList<FieldSolutionID> &solutionIDs, QMap<FieldSolutionID, SolutionRunTimeDetails> &runTimes);
+
+    friend class SolutionWriter;
 };
 
 #endif // SOLUTIONSTORE_H
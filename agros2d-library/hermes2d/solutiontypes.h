@@ -141,6 +141,12 @@ inline bool operator!=(const SolutionID<Group> &sid1, const SolutionID<Group> &s
     return !(sid1 == sid2);
 }
 
+template <typename Group>
+inline uint qHash(const SolutionID<Group> &sid)
+{
+    return qHash(sid.group) ^ (uint(sid.timeStep) << 12) ^ (uint(sid.adaptivityStep) << 4) ^ uint(sid.solutionMode);
+}
+
 template <typename Group>
 ostream& operator<<(ostream& output, const SolutionID<Group>& id)
 {
@@ -41,6 +41,7 @@
 #include "bdf2.h"
 #include "plugin_interface.h"
 #include "weak_form.h"
+#include "solver_external_protocol.h"
 
 #include "pythonlab/pythonengine.h"
 
@@ -60,6 +61,206 @@ Hermes::Solvers::ExternalSolver<double>* getExternalSolver(CSCMatrix<double> *m,
     //return new AgrosExternalSolverUMFPack(m, rhs);
 }
 
+AgrosExternalSolverServer *AgrosExternalSolverServer::server()
+{
+    static AgrosExternalSolverServer server;
+    return &server;
+}
+
+AgrosExternalSolverServer::AgrosExternalSolverServer()
+    : m_process(NULL), m_socket(NULL), m_sharedMemoryGeneration(0), m_failed(false), m_lastMatrix(NULL)
+{
+    m_serverName = QString("agros2d-solver-%1").arg(QCoreApplication::applicationPid());
+}
+
+AgrosExternalSolverServer::~AgrosExternalSolverServer()
+{
+    stop();
+}
+
+bool AgrosExternalSolverServer::start()
+{
+    m_process = new QProcess();
+    m_process->setStandardOutputFile(tempProblemDir() + "/solver.out");
+    m_process->setStandardErrorFile(tempProblemDir() + "/solver.err");
+    m_process->start(QString("\"%1/solver_external\" --server \"%2\"").
+                     arg(QApplication::applicationDirPath()).
+                     arg(m_serverName));
+
+    if (m_process->waitForStarted())
+    {
+        m_socket = new QLocalSocket();
+
+        // server is listening shortly after start
+        for (int i = 0; i < 100; i++)
+        {
+            m_socket->connectToServer(m_serverName);
+            if (m_socket->waitForConnected(100))
+                return true;
+
+            // process finished (or wait for 50 ms)
+            if (m_process->waitForFinished(50))
+                break;
+        }
+    }
+
+    Agros2D::log()->printWarning(QObject::tr("Solver"), QObject::tr("Could not start external solver server, file based external solver is used"));
+    stop();
+    m_failed = true;
+
+    return false;
+}
+
+void AgrosExternalSolverServer::stop()
+{
+    QMutexLocker lock(&m_mutex);
+
+    m_lastMatrix = NULL;
+
+    if (m_socket)
+    {
+        if (m_socket->state() == QLocalSocket::ConnectedState)
+        {
+            QByteArray request;
+            QDataStream out(&request, QIODevice::WriteOnly);
+            out << (qint32) SolverExternalCommand_Quit;
+
+            writeSolverExternalMessage(m_socket, request);
+            m_socket->disconnectFromServer();
+        }
+
+        delete m_socket;
+        m_socket = NULL;
+    }
+
+    if (m_process)
+    {
+        if (!m_process->waitForFinished(1000))
+            m_process->kill();
+
+        delete m_process;
+        m_process = NULL;
+
+        QFile::remove(tempProblemDir() + "/solver.out");
+        QFile::remove(tempProblemDir() + "/solver.err");
+    }
+
+    if (m_sharedMemory.isAttached())
+        m_sharedMemory.detach();
+
+    // new calculation can try again
+    m_failed = false;
+}
+
+bool AgrosExternalSolverServer::prepareSharedMemory(qint64 size)
+{
+    if (m_sharedMemory.isAttached() && m_sharedMemory.size() >= size)
+        return true;
+
+    if (m_sharedMemory.isAttached())
+        m_sharedMemory.detach();
+
+    // new key, server reattaches when the key changes
+    m_sharedMemory.setKey(QString("%1-%2").arg(m_serverName).arg(++m_sharedMemoryGeneration));
+
+    // reserve space for growing system (adaptivity)
+    if (!m_sharedMemory.create(size + size / 4))
+    {
+        Agros2D::log()->printWarning(QObject::tr("Solver"), QObject::tr("Could not create shared memory for external solver: %1").arg(m_sharedMemory.errorString()));
+        return false;
+    }
+
+    return true;
+}
+
+bool AgrosExternalSolverServer::sendRequest(const QByteArray &request, qint32 &status, QString &message)
+{
+    QByteArray response;
+    if (!writeSolverExternalMessage(m_socket, request) || !readSolverExternalMessage(m_socket, response))
+    {
+        Agros2D::log()->printError(QObject::tr("External solver"), QObject::tr("Connection to external solver server lost: %1").arg(m_socket->errorString()));
+        return false;
+    }
+
+    QDataStream in(&response, QIODevice::ReadOnly);
+    in >> status >> message;
+
+    return true;
+}
+
+bool AgrosExternalSolverServer::solve(const QString &solverName, CSCMatrix<double> *matrix, SimpleVector<double> *rhs, bool reuseExpected, double *sln)
+{
+    if (m_failed)
+        return false;
+
+    if (!m_socket && !start())
+        return false;
+
+    QMutexLocker lock(&m_mutex);
+
+    int size = matrix->get_size();
+    int nnz = matrix->get_nnz();
+
+    if (!prepareSharedMemory(solverExternalSharedMemorySize(size, nnz)))
+        return false;
+
+    // server finds factorizations by structure hash (matrix is compared exactly)
+    quint64 structureHash = solverExternalHash(matrix->get_Ap(), (size + 1) * sizeof(int));
+    structureHash = solverExternalHash(matrix->get_Ai(), nnz * sizeof(int), structureHash);
+
+    // copy rhs to shared memory (matrix only if factorization can not be reused)
+    m_sharedMemory.lock();
+    void *data = m_sharedMemory.data();
+    memcpy(solverExternalRHS(data, size, nnz), rhs->v, size * sizeof(double));
+    m_sharedMemory.unlock();
+
+    // server reuses factorization of its previous solve, blocks solved concurrently share the server
+    bool matrixIncluded = !reuseExpected || (matrix != m_lastMatrix);
+    qint32 status = SolverExternalStatus_MatrixRequired;
+    QString message;
+
+    while (status == SolverExternalStatus_MatrixRequired)
+    {
+        if (matrixIncluded)
+        {
+            m_sharedMemory.lock();
+            memcpy(solverExternalAx(data, size, nnz), matrix->get_Ax(), nnz * sizeof(double));
+            memcpy(solverExternalAp(data, size, nnz), matrix->get_Ap(), (size + 1) * sizeof(int));
+            memcpy(solverExternalAi(data, size, nnz), matrix->get_Ai(), nnz * sizeof(int));
+            m_sharedMemory.unlock();
+        }
+
+        QByteArray request;
+        QDataStream out(&request, QIODevice::WriteOnly);
+        out << (qint32) SolverExternalCommand_Solve << solverName << m_sharedMemory.key() << (qint32) size << (qint32) nnz
+            << structureHash << matrixIncluded;
+
+        if (!sendRequest(request, status, message))
+        {
+            lock.unlock();
+            stop();
+            m_failed = true;
+
+            return false;
+        }
+
+        // server does not have factorization anymore
+        if (status == SolverExternalStatus_MatrixRequired && matrixIncluded)
+            throw AgrosSolverException(QObject::tr("External solver refused the matrix"));
+        matrixIncluded = true;
+    }
+
+    m_lastMatrix = (status == SolverExternalStatus_OK) ? matrix : NULL;
+    if (status != SolverExternalStatus_OK)
+        throw AgrosSolverException(QObject::tr("External solver failed: %1").arg(message));
+
+    m_sharedMemory.lock();
+    memcpy(sln, solverExternalSln(m_sharedMemory.data(), size, nnz), size * sizeof(double));
+    m_sharedMemory.unlock();
+
+    return true;
+}
+
 AgrosExternalSolverExternal::AgrosExternalSolverExternal(CSCMatrix<double> *m, SimpleVector<double> *rhs)
     : ExternalSolver<double>(m, rhs), initialGuess(NULL)
 {
@@ -74,6 +275,24 @@ void AgrosExternalSolverExternal::solve(double* initial_guess)
 {
     initialGuess = initial_guess;
 
+    // persistent server (direct solvers do not use initial guess)
+    // Hermes sets complete reuse when the matrix was not assembled again (constant jacobian)
+    double *slnServer = new double[this->rhs->get_size()];
+    if (AgrosExternalSolverServer::server()->solve(solverName(), this->m, this->rhs,
+                                                   this->reuse_scheme == HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY,
+                                                   slnServer))
+    {
+        delete [] this->sln;
+        this->sln = slnServer;
+
+        if (!(Agros2D::problem()->isTransient() || Agros2D::problem()->isNonlinear()))
+            this->m->free();
+        this->rhs->free();
+
+        return;
+    }
+    delete [] slnServer;
+
     fileMatrix = QString("%1/solver_matrix").arg(cacheProblemDir());
     fileRHS = QString("%1/solver_rhs").arg(cacheProblemDir());
     fileInitial = QString("%1/solver_initial").arg(cacheProblemDir());
@@ -495,12 +714,19 @@ Scalar *ProblemSolver<Scalar>::solveOneProblem(Hermes::vector<Hermes::Hermes2D::
 
 template <typename Scalar>
 void ProblemSolver<Scalar>::solveSimple(int timeStep, int adaptivityStep)
+{
+    prepareSimple(timeStep, adaptivityStep);
+    solveSimplePrepared(timeStep, adaptivityStep);
+}
+
+template <typename Scalar>
+void ProblemSolver<Scalar>::prepareSimple(int timeStep, int adaptivityStep)
 {
     // to be used as starting vector for the Newton solver
-    MultiArray<Scalar> previousTSMultiSolutionArray;
+    m_previousTSMultiSolutionArray = MultiArray<Scalar>();
     // if ((m_block->isTransient() && m_block->linearityType() != LinearityType_Linear) && (timeStep > 0))
     if ((m_block->isTransient()) && (timeStep > 0))
-        previousTSMultiSolutionArray = Agros2D::solutionStore()->multiSolutionPreviousCalculatedTS(BlockSolutionID(m_block, timeStep, adaptivityStep, SolutionMode_Normal));
+        m_previousTSMultiSolutionArray = Agros2D::solutionStore()->multiSolutionPreviousCalculatedTS(BlockSolutionID(m_block, timeStep, adaptivityStep, SolutionMode_Normal));
 
     // check for DOFs
     int ndof = Hermes::Hermes2D::Space<Scalar>::get_num_dofs(actualSpaces());
@@ -529,11 +755,15 @@ void ProblemSolver<Scalar>::solveSimple(int timeStep, int adaptivityStep)
 
     m_block->weakForm()->set_current_time(Agros2D::problem()->actualTime());
     m_block->weakForm()->updateExtField();
+}
 
+template <typename Scalar>
+void ProblemSolver<Scalar>::solveSimplePrepared(int timeStep, int adaptivityStep)
+{
     try
     {
         Scalar *solutionVector = solveOneProblem(actualSpaces(), adaptivityStep,
-                                                 previousTSMultiSolutionArray.solutions());
+                                                 m_previousTSMultiSolutionArray.solutions());
 
         // output
         Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > solutions = createSolutions<Scalar>(spacesMeshes(actualSpaces()));
@@ -554,8 +784,11 @@ void ProblemSolver<Scalar>::solveSimple(int timeStep, int adaptivityStep)
     }
     catch (AgrosSolverException e)
     {
+        m_previousTSMultiSolutionArray = MultiArray<Scalar>();
         throw AgrosSolverException(QObject::tr("Solver failed: %1").arg(e.toString()));
     }
+
+    m_previousTSMultiSolutionArray = MultiArray<Scalar>();
 }
 
 template <typename Scalar>
@@ -74,6 +74,46 @@ protected:
     int m_jacobianCalculations;
 };
 
+// solver_external running in server mode, started on the first external solve and kept
+// for the whole calculation (matrix and vectors are passed in shared memory)
+class AgrosExternalSolverServer
+{
+public:
+    static AgrosExternalSolverServer *server();
+
+    // returns false if the server is not available (file based solver is used instead)
+    // reuseExpected - matrix is the same as in the previous solve, it is sent only if the server asks for it
+    bool solve(const QString &solverName, CSCMatrix<double> *matrix, SimpleVector<double> *rhs, bool reuseExpected, double *sln);
+    void stop();
+
+private:
+    AgrosExternalSolverServer();
+    ~AgrosExternalSolverServer();
+
+    bool start();
+    bool prepareSharedMemory(qint64 size);
+    bool sendRequest(const QByteArray &request, qint32 &status, QString &message);
+
+    QMutex m_mutex;
+
+    QProcess *m_process;
+    QLocalSocket *m_socket;
+    QSharedMemory m_sharedMemory;
+    QString m_serverName;
+    int m_sharedMemoryGeneration;
+    bool m_failed;
+
+    // matrix of the previous solve (factorization of the server)
+    const CSCMatrix<double> *m_lastMatrix;
+};
+
+// stops the external solver server when the calculation finishes
+class AgrosExternalSolverServerGuard
+{
+public:
+    ~AgrosExternalSolverServerGuard() { AgrosExternalSolverServer::server()->stop(); }
+};
+
 class AgrosExternalSolverExternal : public QObject, public ExternalSolver<double>
 {
     Q_OBJECT
@@ -83,6 +123,7 @@ public:
     void solve();
     void solve(double* initial_guess);
 
+    virtual QString solverName() const = 0;
     virtual void setSolverCommand() = 0;
 
 protected:
@@ -107,6 +148,7 @@ class AgrosExternalSolverMUMPS : public AgrosExternalSolverExternal
 public:
     AgrosExternalSolverMUMPS(CSCMatrix<double> *m, SimpleVector<double> *rhs);
 
+    virtual QString solverName() const { return "mumps"; }
     virtual void setSolverCommand();
 };
 
@@ -115,6 +157,7 @@ class AgrosExternalSolverUMFPack : public AgrosExternalSolverExternal
 public:
     AgrosExternalSolverUMFPack(CSCMatrix<double> *m, SimpleVector<double> *rhs);
 
+    virtual QString solverName() const { return "umfpack"; }
     virtual void setSolverCommand();
 };
 
@@ -176,6 +219,10 @@ public:
     TimeStepInfo estimateTimeStepLength(int timeStep, int adaptivityStep);
 
     void solveSimple(int timeStep, int adaptivityStep);
+    // solveSimple split for concurrent solution of blocks: preparation (time functions, Python values,
+    // coupling sources) has to be called in the calculation thread, prepared problem can be solved in a worker
+    void prepareSimple(int timeStep, int adaptivityStep);
+    void solveSimplePrepared(int timeStep, int adaptivityStep);
     void solveReferenceAndProject(int timeStep, int adaptivityStep);
     bool createAdaptedSpace(int timeStep, int adaptivityStep);
 
@@ -199,6 +246,9 @@ private:
     // to be used in advanced time step adaptivity
     double m_averageErrorToLenghtRatio;
 
+    // starting vector for the Newton solver (between prepareSimple and solveSimplePrepared)
+    MultiArray<Scalar> m_previousTSMultiSolutionArray;
+
     void initSelectors(Hermes::vector<QSharedPointer<Hermes::Hermes2D::RefinementSelectors::Selector<Scalar> > >& selectors);
 
     Scalar *solveOneProblem(Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<Scalar> > spaces, int adaptivityStep, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > previousSolution = Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> >());
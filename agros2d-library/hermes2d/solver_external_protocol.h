@@ -0,0 +1,115 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef SOLVER_EXTERNAL_PROTOCOL_H
+#define SOLVER_EXTERNAL_PROTOCOL_H
+
+// protocol of solver_external running in server mode (shared by library and solver_external)
+//
+// messages are length prefixed (quint32, big endian) QDataStream blocks sent over QLocalSocket
+// request:  qint32 command, for solve: QString solver, QString shared memory key, qint32 size, qint32 nnz,
+//           quint64 structure hash, bool matrix included
+// response: qint32 status, QString message
+//
+// matrix (CSC) and vectors are passed in shared memory:
+// Ax[nnz], rhs[size], sln[size] (double), Ap[size + 1], Ai[nnz] (int)
+//
+// server keeps factorizations keyed by the structure hash; the hash only finds the candidate, sent matrix
+// is compared with the stored copy: unchanged values skip the factorization, changed values reuse the symbolic
+// analysis; if the client expects reuse (matrix was not assembled again) and sends only rhs, server reuses
+// the factorization of the previous solve or answers SolverExternalStatus_MatrixRequired
+
+#include <QtCore>
+#include <QLocalSocket>
+
+enum SolverExternalCommand
+{
+    SolverExternalCommand_Solve = 1,
+    SolverExternalCommand_Quit = 2
+};
+
+enum SolverExternalStatus
+{
+    SolverExternalStatus_OK = 0,
+    SolverExternalStatus_Error = 1,
+    SolverExternalStatus_MatrixRequired = 2
+};
+
+// 64-bit FNV-1a over bytes with final avalanche (lookup of factorizations, never used alone to decide reuse)
+inline quint64 solverExternalHash(const void *data, qint64 bytes, quint64 hash = 14695981039346656037ULL)
+{
+    const quint64 prime = 1099511628211ULL;
+
+    const uchar *bytesData = (const uchar *) data;
+    for (qint64 i = 0; i < bytes; i++)
+        hash = (hash ^ bytesData[i]) * prime;
+
+    // every input bit affects all bits of the result
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+inline qint64 solverExternalSharedMemorySize(int size, int nnz)
+{
+    return (qint64) (nnz + 2 * size) * sizeof(double) + (qint64) (size + 1 + nnz) * sizeof(int);
+}
+
+inline double *solverExternalAx(void *data, int size, int nnz) { return (double *) data; }
+inline double *solverExternalRHS(void *data, int size, int nnz) { return (double *) data + nnz; }
+inline double *solverExternalSln(void *data, int size, int nnz) { return (double *) data + nnz + size; }
+inline int *solverExternalAp(void *data, int size, int nnz) { return (int *) ((double *) data + nnz + 2 * size); }
+inline int *solverExternalAi(void *data, int size, int nnz) { return solverExternalAp(data, size, nnz) + size + 1; }
+
+inline bool writeSolverExternalMessage(QLocalSocket *socket, const QByteArray &message)
+{
+    quint32 length = qToBigEndian((quint32) message.size());
+    socket->write((const char *) &length, sizeof(quint32));
+    socket->write(message);
+
+    while (socket->bytesToWrite() > 0)
+        if (!socket->waitForBytesWritten(-1))
+            return false;
+
+    return true;
+}
+
+inline bool readSolverExternalMessage(QLocalSocket *socket, QByteArray &message)
+{
+    while (socket->bytesAvailable() < (qint64) sizeof(quint32))
+        if (!socket->waitForReadyRead(-1))
+            return false;
+
+    quint32 length;
+    socket->read((char *) &length, sizeof(quint32));
+    length = qFromBigEndian(length);
+
+    while (socket->bytesAvailable() < (qint64) length)
+        if (!socket->waitForReadyRead(-1))
+            return false;
+
+    message = socket->read(length);
+    return true;
+}
+
+#endif // SOLVER_EXTERNAL_PROTOCOL_H
@@ -2,6 +2,7 @@
 #define WEAK_FORM_H
 
 #include "form_info.h"
+#include "solutiontypes.h"
 
 class BDF2Table;
 class Block;
@@ -12,6 +13,7 @@ class Material;
 class SceneMaterial;
 class CouplingInfo;
 class FieldInfo;
+class AgrosExtFunction;
 
 namespace XMLModule
 {
@@ -149,9 +151,26 @@ private:
 
     int m_numberOfForms;
 
-    Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > quantitiesAndSpecialFunctions(const FieldInfo* fieldInfo, bool linearize) const;
-    Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > previousTimeLevelsSolutions(const FieldInfo* fieldInfo) const;
-    Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > sourceCouplingSolutions(const FieldInfo* fieldInfo) const;
+    // previous time levels and coupling sources used by forms (pinned in the solution store cache)
+    QList<FieldSolutionID> m_pinnedSolutions;
+
+    // quantities and special functions of field (linearized or not), kept for following steps
+    struct ExtFunctions
+    {
+        Hermes::Hermes2D::Mesh *initialMesh;
+        double time;
+        Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > functions;
+        // functions with data depending on time
+        QList<AgrosExtFunction *> timeDependent;
+    };
+    QMap<QPair<const FieldInfo *, bool>, ExtFunctions> m_extFunctions;
+
+    Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > extFunctions(const FieldInfo* fieldInfo, bool linearize);
+    Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > quantitiesAndSpecialFunctions(const FieldInfo* fieldInfo, bool linearize,
+                                                                                                    QList<AgrosExtFunction *> &timeDependent) const;
+    Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > previousTimeLevelsSolutions(const FieldInfo* fieldInfo);
+    Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > sourceCouplingSolutions(const FieldInfo* fieldInfo);
+    void pinSolution(FieldSolutionID solutionID);
 };
 
 #endif // WEAK_FORM_H
@@ -0,0 +1,515 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "expression.h"
+
+static double functionDegrees(double x) { return x * 180.0 / M_PI; }
+static double functionRadians(double x) { return x * M_PI / 180.0; }
+static double functionLogBase(double x, double base) { return log(x) / log(base); }
+static double functionIdentity(double x) { return x; }
+
+struct ExpressionFunction
+{
+    const char *name;
+    int argc;
+    double (*function1)(double);
+    double (*function2)(double, double);
+    bool isIntegerPreserving;
+};
+
+// functions of Python math module and builtins used in practice
+static const ExpressionFunction expressionFunctions[] =
+{
+    { "sin", 1, ::sin, NULL, false },
+    { "cos", 1, ::cos, NULL, false },
+    { "tan", 1, ::tan, NULL, false },
+    { "asin", 1, ::asin, NULL, false },
+    { "acos", 1, ::acos, NULL, false },
+    { "atan", 1, ::atan, NULL, false },
+    { "sinh", 1, ::sinh, NULL, false },
+    { "cosh", 1, ::cosh, NULL, false },
+    { "tanh", 1, ::tanh, NULL, false },
+    { "asinh", 1, ::asinh, NULL, false },
+    { "acosh", 1, ::acosh, NULL, false },
+    { "atanh", 1, ::atanh, NULL, false },
+    { "exp", 1, ::exp, NULL, false },
+    { "expm1", 1, ::expm1, NULL, false },
+    { "log", 1, ::log, NULL, false },
+    { "log10", 1, ::log10, NULL, false },
+    { "log1p", 1, ::log1p, NULL, false },
+    { "sqrt", 1, ::sqrt, NULL, false },
+    { "fabs", 1, ::fabs, NULL, false },
+    { "abs", 1, ::fabs, NULL, true },
+    { "floor", 1, ::floor, NULL, false },
+    { "ceil", 1, ::ceil, NULL, false },
+    { "round", 1, ::round, NULL, false },
+    { "erf", 1, ::erf, NULL, false },
+    { "erfc", 1, ::erfc, NULL, false },
+    { "degrees", 1, functionDegrees, NULL, false },
+    { "radians", 1, functionRadians, NULL, false },
+    { "float", 1, functionIdentity, NULL, false },
+    { "atan2", 2, NULL, ::atan2, false },
+    { "pow", 2, NULL, ::pow, false },
+    { "fmod", 2, NULL, ::fmod, false },
+    { "hypot", 2, NULL, ::hypot, false },
+    { "copysign", 2, NULL, ::copysign, false },
+    { "log", 2, NULL, functionLogBase, false },
+    { NULL, 0, NULL, NULL, false }
+};
+
+class ExpressionCompilerException
+{
+};
+
+// recursive descent compiler (Python operator precedence) emitting postfix program
+class ExpressionCompiler
+{
+public:
+    ExpressionCompiler(CompiledExpression *expression, const QList<Token> &tokens)
+        : m_expression(expression), m_position(0), m_depth(0), m_maxDepth(0)
+    {
+        // lexical analyser joins sign with the following number ("2*-3" -> "2", "*", "-3")
+        foreach (Token token, tokens)
+        {
+            QString text = token.toString();
+            if (token.type() == ParserTokenType_NUMBER && (text.startsWith("-") || text.startsWith("+")))
+            {
+                m_tokens.append(Token(ParserTokenType_OPERATOR, text.left(1)));
+                m_tokens.append(Token(ParserTokenType_NUMBER, text.mid(1)));
+            }
+            else
+            {
+                m_tokens.append(token);
+            }
+        }
+    }
+
+    void compile()
+    {
+        if (m_tokens.isEmpty())
+            throw ExpressionCompilerException();
+
+        parseComparison();
+
+        // unprocessed tokens
+        if (m_position != m_tokens.count())
+            throw ExpressionCompilerException();
+
+        if (m_maxDepth > CompiledExpression::MAX_STACK_SIZE)
+            throw ExpressionCompilerException();
+    }
+
+private:
+    CompiledExpression *m_expression;
+    QList<Token> m_tokens;
+    int m_position;
+    int m_depth;
+    int m_maxDepth;
+
+    inline bool isOperator(const QString &op)
+    {
+        return (m_position < m_tokens.count()
+                && m_tokens[m_position].type() == ParserTokenType_OPERATOR
+                && m_tokens[m_position].toString() == op);
+    }
+
+    void expect(const QString &op)
+    {
+        if (!isOperator(op))
+            throw ExpressionCompilerException();
+        m_position++;
+    }
+
+    void emitInstruction(ExpressionOpcode opcode, int stackChange, double value = 0.0, int index = 0,
+                         double (*function1)(double) = NULL, double (*function2)(double, double) = NULL)
+    {
+        CompiledExpression::Instruction instruction;
+        instruction.opcode = opcode;
+        instruction.value = value;
+        instruction.index = index;
+        instruction.function1 = function1;
+        instruction.function2 = function2;
+        m_expression->m_program.push_back(instruction);
+
+        m_depth += stackChange;
+        m_maxDepth = qMax(m_maxDepth, m_depth);
+    }
+
+    // returns true if the subexpression is of Python integer type
+    bool parseComparison()
+    {
+        bool isInteger = parseSum();
+
+        ExpressionOpcode opcode;
+        if (isOperator("<")) opcode = ExpressionOpcode_Less;
+        else if (isOperator(">")) opcode = ExpressionOpcode_Greater;
+        else if (isOperator("<=")) opcode = ExpressionOpcode_LessEqual;
+        else if (isOperator(">=")) opcode = ExpressionOpcode_GreaterEqual;
+        else if (isOperator("==")) opcode = ExpressionOpcode_Equal;
+        else if (isOperator("!=")) opcode = ExpressionOpcode_NotEqual;
+        else return isInteger;
+
+        m_position++;
+        parseSum();
+        emitInstruction(opcode, -1);
+
+        // chained comparison (a < b < c) has different meaning in Python
+        if (isOperator("<") || isOperator(">") || isOperator("<=") || isOperator(">=") || isOperator("==") || isOperator("!="))
+            throw ExpressionCompilerException();
+
+        return true;
+    }
+
+    bool parseSum()
+    {
+        bool isInteger = parseTerm();
+
+        while (isOperator("+") || isOperator("-"))
+        {
+            ExpressionOpcode opcode = isOperator("+") ? ExpressionOpcode_Add : ExpressionOpcode_Subtract;
+            m_position++;
+            bool isIntegerRight = parseTerm();
+            emitInstruction(opcode, -1);
+
+            isInteger = isInteger && isIntegerRight;
+        }
+
+        return isInteger;
+    }
+
+    bool parseTerm()
+    {
+        bool isInteger = parseUnary();
+
+        while (isOperator("*") || isOperator("/"))
+        {
+            bool isDivision = isOperator("/");
+            m_position++;
+            bool isIntegerRight = parseUnary();
+
+            // integer division (Python 2) is left to Python
+            if (isDivision && isInteger && isIntegerRight)
+                throw ExpressionCompilerException();
+
+            emitInstruction(isDivision ? ExpressionOpcode_Divide : ExpressionOpcode_Multiply, -1);
+
+            isInteger = isInteger && isIntegerRight;
+        }
+
+        return isInteger;
+    }
+
+    bool parseUnary()
+    {
+        if (isOperator("-"))
+        {
+            m_position++;
+            bool isInteger = parseUnary();
+            emitInstruction(ExpressionOpcode_Negate, 0);
+            return isInteger;
+        }
+        if (isOperator("+"))
+        {
+            m_position++;
+            return parseUnary();
+        }
+
+        return parsePower();
+    }
+
+    bool parsePower()
+    {
+        bool isInteger = parsePrimary();
+
+        if (isOperator("**"))
+        {
+            m_position++;
+            // right associative, binds tighter than unary operator on the left only
+            bool isIntegerRight = parseUnary();
+            emitInstruction(ExpressionOpcode_Power, -1);
+
+            isInteger = isInteger && isIntegerRight;
+        }
+
+        return isInteger;
+    }
+
+    bool parsePrimary()
+    {
+        if (m_position >= m_tokens.count())
+            throw ExpressionCompilerException();
+
+        Token token = m_tokens[m_position];
+        QString text = token.toString();
+
+        if (token.type() == ParserTokenType_NUMBER)
+        {
+            m_position++;
+
+            bool ok = false;
+            double value = text.toDouble(&ok);
+            if (!ok)
+                throw ExpressionCompilerException();
+
+            emitInstruction(ExpressionOpcode_Constant, 1, value);
+            return !(text.contains(".") || text.contains("e") || text.contains("E"));
+        }
+        else if (token.type() == ParserTokenType_VARIABLE)
+        {
+            m_position++;
+
+            if (text == "pi")
+                emitInstruction(ExpressionOpcode_Constant, 1, M_PI);
+            else if (text == "e")
+                emitInstruction(ExpressionOpcode_Constant, 1, M_E);
+            else if (text == "time")
+                emitVariable(ExpressionVariable_Time);
+            else if (text == "x")
+                emitVariable(ExpressionVariable_X);
+            else if (text == "y")
+                emitVariable(ExpressionVariable_Y);
+            else if (text == "r")
+                emitVariable(ExpressionVariable_R);
+            else if (text == "z")
+                emitVariable(ExpressionVariable_Z);
+            else
+                throw ExpressionCompilerException(); // user variable defined in Python
+
+            return false;
+        }
+        else if (token.type() == ParserTokenType_FUNCTION)
+        {
+            m_position++;
+            return parseFunction(text);
+        }
+        else if (isOperator("("))
+        {
+            m_position++;
+            bool isInteger = parseComparison();
+            expect(")");
+
+            return isInteger;
+        }
+
+        throw ExpressionCompilerException();
+    }
+
+    bool parseFunction(const QString &name)
+    {
+        expect("(");
+
+        // arguments
+        int argc = 0;
+        bool isInteger = true;
+        if (!isOperator(")"))
+        {
+            isInteger = parseComparison() && isInteger;
+            argc++;
+
+            while (isOperator(","))
+            {
+                m_position++;
+                isInteger = parseComparison() && isInteger;
+                argc++;
+            }
+        }
+        expect(")");
+
+        if ((name == "min" || name == "max") && argc >= 2)
+        {
+            emitInstruction((name == "min") ? ExpressionOpcode_Minimum : ExpressionOpcode_Maximum, 1 - argc, 0.0, argc);
+            return isInteger;
+        }
+
+        for (int i = 0; expressionFunctions[i].name; i++)
+        {
+            if (name == expressionFunctions[i].name && argc == expressionFunctions[i].argc)
+            {
+                if (argc == 1)
+                    emitInstruction(ExpressionOpcode_Function1, 0, 0.0, 0, expressionFunctions[i].function1, NULL);
+                else
+                    emitInstruction(ExpressionOpcode_Function2, -1, 0.0, 0, NULL, expressionFunctions[i].function2);
+
+                return isInteger && expressionFunctions[i].isIntegerPreserving;
+            }
+        }
+
+        // unknown function or user function defined in Python
+        throw ExpressionCompilerException();
+    }
+
+    void emitVariable(ExpressionVariable variable)
+    {
+        emitInstruction(ExpressionOpcode_Variable, 1, 0.0, variable);
+        m_expression->m_variables |= (1 << variable);
+    }
+};
+
+// ************************************************************************************************
+
+CompiledExpression::CompiledExpression() : m_isCompiled(false), m_variables(0)
+{
+}
+
+void CompiledExpression::clear()
+{
+    m_program.clear();
+    m_isCompiled = false;
+    m_variables = 0;
+}
+
+bool CompiledExpression::compile(const QString &expression)
+{
+    LexicalAnalyser lex;
+
+    try
+    {
+        lex.setExpression(expression);
+    }
+    catch (ParserException &e)
+    {
+        clear();
+        return false;
+    }
+
+    return compile(lex.tokens());
+}
+
+bool CompiledExpression::compile(const QList<Token> &tokens)
+{
+    clear();
+
+    try
+    {
+        ExpressionCompiler compiler(this, tokens);
+        compiler.compile();
+
+        m_isCompiled = true;
+    }
+    catch (ExpressionCompilerException &e)
+    {
+        clear();
+    }
+
+    return m_isCompiled;
+}
+
+bool CompiledExpression::evaluate(const double *variables, double &result) const
+{
+    assert(m_isCompiled);
+
+    double stack[MAX_STACK_SIZE];
+    int top = -1;
+
+    for (std::vector<Instruction>::const_iterator it = m_program.begin(); it != m_program.end(); ++it)
+    {
+        const Instruction &instruction = *it;
+
+        switch (instruction.opcode)
+        {
+        case ExpressionOpcode_Constant:
+            stack[++top] = instruction.value;
+            break;
+        case ExpressionOpcode_Variable:
+            stack[++top] = variables[instruction.index];
+            break;
+        case ExpressionOpcode_Add:
+            top--;
+            stack[top] += stack[top + 1];
+            break;
+        case ExpressionOpcode_Subtract:
+            top--;
+            stack[top] -= stack[top + 1];
+            break;
+        case ExpressionOpcode_Multiply:
+            top--;
+            stack[top] *= stack[top + 1];
+            break;
+        case ExpressionOpcode_Divide:
+            top--;
+            // ZeroDivisionError in Python
+            if (stack[top + 1] == 0.0)
+                return false;
+            stack[top] /= stack[top + 1];
+            break;
+        case ExpressionOpcode_Power:
+            top--;
+            stack[top] = pow(stack[top], stack[top + 1]);
+            if (!std::isfinite(stack[top]))
+                return false;
+            break;
+        case ExpressionOpcode_Negate:
+            stack[top] = -stack[top];
+            break;
+        case ExpressionOpcode_Less:
+            top--;
+            stack[top] = (stack[top] < stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case ExpressionOpcode_Greater:
+            top--;
+            stack[top] = (stack[top] > stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case ExpressionOpcode_LessEqual:
+            top--;
+            stack[top] = (stack[top] <= stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case ExpressionOpcode_GreaterEqual:
+            top--;
+            stack[top] = (stack[top] >= stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case ExpressionOpcode_Equal:
+            top--;
+            stack[top] = (stack[top] == stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case ExpressionOpcode_NotEqual:
+            top--;
+            stack[top] = (stack[top] != stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case ExpressionOpcode_Function1:
+            stack[top] = instruction.function1(stack[top]);
+            // math domain error in Python
+            if (!std::isfinite(stack[top]))
+                return false;
+            break;
+        case ExpressionOpcode_Function2:
+            top--;
+            stack[top] = instruction.function2(stack[top], stack[top + 1]);
+            if (!std::isfinite(stack[top]))
+                return false;
+            break;
+        case ExpressionOpcode_Minimum:
+            top -= instruction.index - 1;
+            for (int i = 1; i < instruction.index; i++)
+                stack[top] = qMin(stack[top], stack[top + i]);
+            break;
+        case ExpressionOpcode_Maximum:
+            top -= instruction.index - 1;
+            for (int i = 1; i < instruction.index; i++)
+                stack[top] = qMax(stack[top], stack[top + i]);
+            break;
+        default:
+            assert(0);
+        }
+    }
+
+    assert(top == 0);
+    result = stack[0];
+
+    return std::isfinite(result);
+}
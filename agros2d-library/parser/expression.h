@@ -0,0 +1,96 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include "lex.h"
+
+enum ExpressionVariable
+{
+    ExpressionVariable_Time = 0,
+    ExpressionVariable_X = 1,
+    ExpressionVariable_Y = 2,
+    ExpressionVariable_R = 3,
+    ExpressionVariable_Z = 4,
+    ExpressionVariable_Count = 5
+};
+
+enum ExpressionOpcode
+{
+    ExpressionOpcode_Constant,
+    ExpressionOpcode_Variable,
+    ExpressionOpcode_Add,
+    ExpressionOpcode_Subtract,
+    ExpressionOpcode_Multiply,
+    ExpressionOpcode_Divide,
+    ExpressionOpcode_Power,
+    ExpressionOpcode_Negate,
+    ExpressionOpcode_Less,
+    ExpressionOpcode_Greater,
+    ExpressionOpcode_LessEqual,
+    ExpressionOpcode_GreaterEqual,
+    ExpressionOpcode_Equal,
+    ExpressionOpcode_NotEqual,
+    ExpressionOpcode_Function1,
+    ExpressionOpcode_Function2,
+    ExpressionOpcode_Minimum,
+    ExpressionOpcode_Maximum
+};
+
+// expression compiled from the token stream of LexicalAnalyser into a postfix program
+// supports arithmetic, comparisons, math constants and functions (Python math module semantics)
+// and variables time, x, y, r, z; anything else is reported as not compiled and has to be evaluated by Python
+class AGROS_LIBRARY_API CompiledExpression
+{
+public:
+    CompiledExpression();
+
+    bool compile(const QString &expression);
+    bool compile(const QList<Token> &tokens);
+    void clear();
+
+    inline bool isCompiled() const { return m_isCompiled; }
+    inline bool isConstant() const { return m_isCompiled && m_variables == 0; }
+    inline bool dependsOn(ExpressionVariable variable) const { return (m_variables & (1 << variable)) != 0; }
+
+    // variables are indexed by ExpressionVariable, returns false for non-finite result
+    bool evaluate(const double *variables, double &result) const;
+
+    // maximal depth of evaluation stack (evaluated without heap allocation)
+    static const int MAX_STACK_SIZE = 64;
+
+private:
+    struct Instruction
+    {
+        ExpressionOpcode opcode;
+        double value;
+        int index;
+        double (*function1)(double);
+        double (*function2)(double, double);
+    };
+
+    std::vector<Instruction> m_program;
+    bool m_isCompiled;
+    int m_variables;
+
+    friend class ExpressionCompiler;
+};
+
+#endif // EXPRESSION_H
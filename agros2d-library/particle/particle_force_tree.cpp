@@ -0,0 +1,232 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "particle_force_tree.h"
+
+// maximal number of particles in leaf
+const int PARTICLE_FORCE_TREE_LEAF_SIZE = 8;
+// coincident particles are not split further
+const int PARTICLE_FORCE_TREE_MAX_DEPTH = 32;
+
+ParticleForceTree::ParticleForceTree()
+{
+}
+
+void ParticleForceTree::clear()
+{
+    m_positions.clear();
+    m_velocities.clear();
+    m_charges.clear();
+
+    m_nodes.clear();
+    m_order.clear();
+    m_rank.clear();
+}
+
+void ParticleForceTree::build(const QVector<Point3> &positions, const QVector<Point3> &velocities, const QVector<double> &charges)
+{
+    assert(positions.size() == velocities.size());
+    assert(positions.size() == charges.size());
+
+    clear();
+
+    if (positions.isEmpty())
+        return;
+
+    m_positions = positions;
+    m_velocities = velocities;
+    m_charges = charges;
+
+    // bounding cube
+    Point3 min( numeric_limits<double>::max(),  numeric_limits<double>::max(),  numeric_limits<double>::max());
+    Point3 max(-numeric_limits<double>::max(), -numeric_limits<double>::max(), -numeric_limits<double>::max());
+
+    m_order.resize(positions.size());
+    for (int i = 0; i < positions.size(); i++)
+    {
+        m_order[i] = i;
+
+        min = Point3(qMin(min.x, positions[i].x), qMin(min.y, positions[i].y), qMin(min.z, positions[i].z));
+        max = Point3(qMax(max.x, positions[i].x), qMax(max.y, positions[i].y), qMax(max.z, positions[i].z));
+    }
+
+    double size = qMax(qMax(max.x - min.x, max.y - min.y), max.z - min.z);
+    if (size < EPS_ZERO)
+        size = EPS_ZERO;
+
+    m_nodes.reserve(2 * positions.size() / PARTICLE_FORCE_TREE_LEAF_SIZE + 1);
+    buildNode((min + max) / 2.0, size, 0, positions.size(), 0);
+
+    m_rank.resize(positions.size());
+    for (int i = 0; i < m_order.size(); i++)
+        m_rank[m_order[i]] = i;
+}
+
+int ParticleForceTree::buildNode(const Point3 &center, double size, int begin, int end, int depth)
+{
+    int index = m_nodes.size();
+    m_nodes.append(Node());
+
+    Node node;
+    node.center = center;
+    node.size = size;
+    node.begin = begin;
+    node.end = end;
+    node.isLeaf = (end - begin <= PARTICLE_FORCE_TREE_LEAF_SIZE) || (depth >= PARTICLE_FORCE_TREE_MAX_DEPTH);
+    for (int k = 0; k < 8; k++)
+        node.children[k] = -1;
+
+    // aggregated particles
+    node.charge = 0.0;
+    double weight = 0.0;
+    for (int i = begin; i < end; i++)
+    {
+        int particle = m_order[i];
+        double w = fabs(m_charges[particle]);
+
+        node.charge += m_charges[particle];
+        node.chargeCenter = node.chargeCenter + m_positions[particle] * w;
+        node.velocity = node.velocity + m_velocities[particle] * w;
+        weight += w;
+    }
+
+    if (weight > 0.0)
+    {
+        node.chargeCenter = node.chargeCenter / weight;
+        node.velocity = node.velocity / weight;
+    }
+    else
+    {
+        node.chargeCenter = center;
+    }
+
+    if (!node.isLeaf)
+    {
+        // sort particles by octants
+        QVector<int> octants(end - begin);
+        int count[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+        for (int i = begin; i < end; i++)
+        {
+            const Point3 &position = m_positions[m_order[i]];
+            int octant = ((position.x > center.x) ? 1 : 0) + ((position.y > center.y) ? 2 : 0) + ((position.z > center.z) ? 4 : 0);
+
+            octants[i - begin] = octant;
+            count[octant]++;
+        }
+
+        int first[8];
+        first[0] = begin;
+        for (int k = 1; k < 8; k++)
+            first[k] = first[k - 1] + count[k - 1];
+
+        QVector<int> order(end - begin);
+        int next[8];
+        for (int k = 0; k < 8; k++)
+            next[k] = first[k] - begin;
+        for (int i = begin; i < end; i++)
+            order[next[octants[i - begin]]++] = m_order[i];
+        for (int i = begin; i < end; i++)
+            m_order[i] = order[i - begin];
+
+        for (int k = 0; k < 8; k++)
+        {
+            if (count[k] == 0)
+                continue;
+
+            Point3 childCenter(center.x + ((k & 1) ? 0.25 : -0.25) * size,
+                               center.y + ((k & 2) ? 0.25 : -0.25) * size,
+                               center.z + ((k & 4) ? 0.25 : -0.25) * size);
+
+            node.children[k] = buildNode(childCenter, size / 2.0, first[k], first[k] + count[k], depth + 1);
+        }
+    }
+
+    m_nodes[index] = node;
+
+    return index;
+}
+
+void ParticleForceTree::evaluate(const Point3 &position, const Point3 &velocity, int particleIndex, double theta,
+                                 bool electric, bool magnetic, Point3 &electricSum, Point3 &magneticSum) const
+{
+    electricSum = Point3();
+    magneticSum = Point3();
+
+    if (m_nodes.isEmpty())
+        return;
+
+    int rank = (particleIndex >= 0 && particleIndex < m_rank.size()) ? m_rank[particleIndex] : -1;
+
+    QVarLengthArray<int, 256> stack;
+    stack.append(0);
+    while (!stack.isEmpty())
+    {
+        const Node &node = m_nodes[stack.last()];
+        stack.removeLast();
+
+        // cell with the particle is always opened
+        bool containsParticle = (rank >= node.begin && rank < node.end);
+
+        Point3 difference = position - node.chargeCenter;
+        double distance = difference.magnitude();
+
+        if (!containsParticle && distance > 0.0 && node.size < theta * distance)
+        {
+            // far cell
+            Point3 r0 = difference / distance;
+            if (electric)
+                electricSum = electricSum + r0 * (node.charge / (distance * distance));
+            if (magnetic)
+            {
+                Point3 v0 = velocity - node.velocity;
+                magneticSum = magneticSum + (v0 % v0 % r0) * (node.charge / (distance * distance));
+            }
+        }
+        else if (node.isLeaf)
+        {
+            // direct sum
+            for (int i = node.begin; i < node.end; i++)
+            {
+                int particle = m_order[i];
+                if (particle == particleIndex)
+                    continue;
+
+                Point3 differenceParticle = position - m_positions[particle];
+                double distanceParticle = differenceParticle.magnitude();
+                if (distanceParticle > 0.0)
+                {
+                    Point3 r0 = differenceParticle / distanceParticle;
+                    if (electric)
+                        electricSum = electricSum + r0 * (m_charges[particle] / (distanceParticle * distanceParticle));
+                    if (magnetic)
+                    {
+                        Point3 v0 = velocity - m_velocities[particle];
+                        magneticSum = magneticSum + (v0 % v0 % r0) * (m_charges[particle] / (distanceParticle * distanceParticle));
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (int k = 0; k < 8; k++)
+                if (node.children[k] != -1)
+                    stack.append(node.children[k]);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef PARTICLE_FORCE_TREE_H
+#define PARTICLE_FORCE_TREE_H
+
+#include "util.h"
+#include "util/point.h"
+
+// octree over particles for Barnes-Hut approximation of particle to particle forces
+// cell seen from the point under angle smaller than opening angle (size / distance < theta) is replaced
+// by its total charge placed in the center of charge (moving with the mean velocity), theta = 0 gives exact sums
+class ParticleForceTree
+{
+public:
+    ParticleForceTree();
+
+    void clear();
+    // positions in cartesian coordinates
+    void build(const QVector<Point3> &positions, const QVector<Point3> &velocities, const QVector<double> &charges);
+
+    inline bool isEmpty() const { return m_nodes.isEmpty(); }
+
+    // sums over all particles except particleIndex (without constants and charge of the particle)
+    // electric: q_j * r0 / d^2, magnetic: q_j * (v0 % v0 % r0) / d^2, where r0 = (p - p_j) / d, v0 = v - v_j
+    void evaluate(const Point3 &position, const Point3 &velocity, int particleIndex, double theta,
+                  bool electric, bool magnetic, Point3 &electricSum, Point3 &magneticSum) const;
+
+private:
+    struct Node
+    {
+        Point3 center;
+        double size;
+
+        // aggregated particles (center and velocity weighted by absolute values of charges)
+        double charge;
+        Point3 chargeCenter;
+        Point3 velocity;
+
+        // range in m_order
+        int begin;
+        int end;
+
+        // leaf has no children, empty octants are -1
+        bool isLeaf;
+        int children[8];
+    };
+
+    QVector<Point3> m_positions;
+    QVector<Point3> m_velocities;
+    QVector<double> m_charges;
+
+    QVector<Node> m_nodes;
+    // particles ordered by cells and position of particle in the order
+    QVector<int> m_order;
+    QVector<int> m_rank;
+
+    int buildNode(const Point3 &center, double size, int begin, int end, int depth);
+};
+
+#endif // PARTICLE_FORCE_TREE_H
@@ -39,6 +39,49 @@
 #include "hermes2d/field.h"
 #include "hermes2d/solutionstore.h"
 #include "hermes2d/problem_config.h"
+#include "hermes2d/module.h"
+#include "hermes2d/element_locator.h"
+
+// worker of particle tracing, particles are taken one by one from the shared counter
+class ParticleTracingRunnable : public QRunnable
+{
+public:
+    ParticleTracingRunnable(ParticleTracing *particleTracing, void (ParticleTracing::*job)(ParticleTracingWorkspace &, int),
+                            ParticleTracingWorkspace *workspace, const QList<int> &particles, QAtomicInt *next)
+        : m_particleTracing(particleTracing), m_job(job), m_workspace(workspace), m_particles(particles), m_next(next) {}
+
+    void run()
+    {
+        try
+        {
+            int index;
+            while ((index = m_next->fetchAndAddOrdered(1)) < m_particles.count())
+                (m_particleTracing->*m_job)(*m_workspace, m_particles.at(index));
+        }
+        catch (Hermes::Exceptions::Exception &e)
+        {
+            m_error = QString::fromStdString(e.info());
+        }
+        catch (AgrosException &e)
+        {
+            m_error = e.toString();
+        }
+        catch (...)
+        {
+            m_error = QObject::tr("An unknown exception occurred in particle tracing");
+        }
+    }
+
+    inline QString error() const { return m_error; }
+
+private:
+    ParticleTracing *m_particleTracing;
+    void (ParticleTracing::*m_job)(ParticleTracingWorkspace &, int);
+    ParticleTracingWorkspace *m_workspace;
+    QList<int> m_particles;
+    QAtomicInt *m_next;
+    QString m_error;
+};
 
 ParticleTracing::ParticleTracing(QObject *parent)
     : QObject(parent)
@@ -56,8 +99,10 @@ ParticleTracing::ParticleTracing(QObject *parent)
         FieldSolutionID fsid(fieldInfo, timeStep, adaptivityStep, solutionMode);
         Hermes::Hermes2D::MeshFunctionSharedPtr<double> sln = Agros2D::solutionStore()->multiArray(fsid).solutions().at(0);
 
-        m_solutionIDs[fieldInfo] = FieldSolutionID(fieldInfo, timeStep, adaptivityStep, solutionMode);
-        m_meshes[fieldInfo] = sln->get_mesh();
+        m_fieldInfos.append(fieldInfo);
+        m_solutionIDs.append(fsid);
+        m_locators.append(QSharedPointer<ElementLocator>(new ElementLocator(sln->get_mesh(), fieldInfo->minimalArcRadius())));
+        m_materials.append(fieldInfo->hermesMarkerMaterials());
     }
 }
 
@@ -68,68 +113,130 @@ ParticleTracing::~ParticleTracing()
 void ParticleTracing::clear()
 {
     // clear lists
-    for (int i = 0; m_positionsList.size(); i++)
-        m_positionsList[i].clear();
     m_positionsList.clear();
-    for (int i = 0; m_velocitiesList.size(); i++)
-        m_velocitiesList[i].clear();
     m_velocitiesList.clear();
-    for (int i = 0; m_timesList.size(); i++)
-        m_timesList[i].clear();
     m_timesList.clear();
+    m_states.clear();
+    m_storages.clear();
+    m_forceTree.clear();
 
     m_velocityMin =  numeric_limits<double>::max();
     m_velocityMax = -numeric_limits<double>::max();
 }
 
-// input position, velocity: planar x, y, z, axi r, z, phi
-// ouput x, y, z
-Point3 ParticleTracing::force(int particleIndex,
-                              Point3 position,
-                              Point3 velocity)
+void ParticleTracing::readSettings()
 {
-    Point3 totalFieldForce;
-    foreach (FieldInfo* fieldInfo, Agros2D::problem()->fieldInfos())
+    ProblemSetting *setting = Agros2D::problem()->setting();
+
+    m_coordinateType = Agros2D::problem()->config()->coordinateType();
+    m_includeRelativisticCorrection = setting->value(ProblemSetting::View_ParticleIncludeRelativisticCorrection).toBool();
+    m_p2pElectricForce = setting->value(ProblemSetting::View_ParticleP2PElectricForce).toBool();
+    m_p2pMagneticForce = setting->value(ProblemSetting::View_ParticleP2PMagneticForce).toBool();
+    m_p2pOpeningAngle = setting->value(ProblemSetting::View_ParticleP2POpeningAngle).toDouble();
+    m_customForce = Point3(setting->value(ProblemSetting::View_ParticleCustomForceX).toDouble(),
+                           setting->value(ProblemSetting::View_ParticleCustomForceY).toDouble(),
+                           setting->value(ProblemSetting::View_ParticleCustomForceZ).toDouble());
+    m_dragFactor = 0.5 * setting->value(ProblemSetting::View_ParticleDragDensity).toDouble()
+            * setting->value(ProblemSetting::View_ParticleDragCoefficient).toDouble()
+            * setting->value(ProblemSetting::View_ParticleDragReferenceArea).toDouble();
+    m_maximumNumberOfSteps = setting->value(ProblemSetting::View_ParticleMaximumNumberOfSteps).toInt();
+    m_coefficientOfRestitution = setting->value(ProblemSetting::View_ParticleCoefficientOfRestitution).toDouble();
+    m_reflectOnDifferentMaterial = setting->value(ProblemSetting::View_ParticleReflectOnDifferentMaterial).toBool();
+    m_reflectOnBoundary = setting->value(ProblemSetting::View_ParticleReflectOnBoundary).toBool();
+    m_butcherTableType = (Hermes::ButcherTableType) setting->value(ProblemSetting::View_ParticleButcherTableType).toInt();
+
+    RectPoint bound = Agros2D::scene()->boundingBox();
+
+    m_maximumStep = (setting->value(ProblemSetting::View_ParticleMaximumStep).toDouble() > 0.0)
+            ? setting->value(ProblemSetting::View_ParticleMaximumStep).toDouble() :
+              min(bound.width(), bound.height()) / 80.0;
+    m_maximumRelativeError = (setting->value(ProblemSetting::View_ParticleMaximumRelativeError).toDouble() > 0.0)
+            ? setting->value(ProblemSetting::View_ParticleMaximumRelativeError).toDouble() : 1e-6;
+
+    // impact or reflection on edges
+    m_edges = Agros2D::scene()->edges->items();
+    m_edgeIndex.build(QList<SceneNode *>(), m_edges);
+    m_edgeImpact.resize(m_edges.count());
+    for (int i = 0; i < m_edges.count(); i++)
     {
-        if (!fieldInfo->plugin()->hasForce(fieldInfo))
-            continue;
+        SceneEdge *edge = m_edges.at(i);
 
-        Point3 fieldForce;
+        bool impact = false;
+        foreach (FieldInfo* fieldInfo, Agros2D::problem()->fieldInfos())
+        {
+            if ((m_coefficientOfRestitution < EPS_ZERO) || // no reflection
+                    (edge->marker(fieldInfo) == Agros2D::scene()->boundaries->getNone(fieldInfo)
+                     && !m_reflectOnDifferentMaterial) || // inner edge
+                    (edge->marker(fieldInfo) != Agros2D::scene()->boundaries->getNone(fieldInfo)
+                     && !m_reflectOnBoundary)) // boundary
+                impact = true;
+        }
 
-        bool elementIsValid = false;
-        Hermes::Hermes2D::Element *activeElement = NULL;
+        m_edgeImpact[i] = impact;
+    }
+}
 
-        // active element for current field
-        if (m_activeElement.contains(fieldInfo))
-            activeElement = m_activeElement[fieldInfo];
+ParticleTracingWorkspace ParticleTracing::createWorkspace(bool cloneSolutions) const
+{
+    ParticleTracingWorkspace workspace;
 
-        if (activeElement)
+    for (int i = 0; i < m_fieldInfos.count(); i++)
+    {
+        MultiArray<double> ma = Agros2D::solutionStore()->multiArray(m_solutionIDs.at(i));
+
+        if (cloneSolutions)
         {
-            double x_reference;
-            double y_reference;
-            elementIsValid = Hermes::Hermes2D::RefMap::is_element_on_physical_coordinates(activeElement,
-                                                                                          position.x, position.y, &x_reference, &y_reference);
-        }
+            Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > solutions;
+            for (int k = 0; k < ma.solutions().size(); k++)
+                solutions.push_back(ma.solutions().at(k)->clone());
 
-        if (!elementIsValid)
+            workspace.solutions.append(solutions);
+        }
+        else
         {
-            m_activeElement[fieldInfo] = Hermes::Hermes2D::RefMap::element_on_physical_coordinates(true, m_meshes[fieldInfo],
-                                                                                                   position.x, position.y);
+            workspace.solutions.append(ma.solutions());
         }
+    }
+
+    workspace.butcher = QSharedPointer<Hermes::ButcherTable>(new Hermes::ButcherTable(m_butcherTableType));
+
+    return workspace;
+}
+
+// input position, velocity: planar x, y, z, axi r, z, phi
+// ouput x, y, z
+Point3 ParticleTracing::force(ParticleTracingWorkspace &workspace,
+                              int particleIndex,
+                              double time,
+                              Point3 position,
+                              Point3 velocity)
+{
+    ParticleState &state = *m_storages.at(particleIndex).state;
+
+    Point3 totalFieldForce;
+    for (int fieldIndex = 0; fieldIndex < m_fieldInfos.count(); fieldIndex++)
+    {
+        FieldInfo *fieldInfo = m_fieldInfos.at(fieldIndex);
+
+        Point3 fieldForce;
+
+        // active element for current field (element of previous position is tested first)
+        Hermes::Hermes2D::Element *activeElement = m_locators.at(fieldIndex)->element(position.x, position.y,
+                                                                                       state.activeElement.at(fieldIndex));
+        state.activeElement[fieldIndex] = activeElement;
 
         if (activeElement)
         {
             // find material
-            SceneLabel *label = Agros2D::scene()->labels->at(atoi(fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(activeElement->marker).marker.c_str()));
-            SceneMaterial* material = label->marker(fieldInfo);
+            SceneMaterial* material = m_materials.at(fieldIndex).value(activeElement->marker);
 
-            assert(!material->isNone());
+            assert(material && !material->isNone());
 
             try
             {
-                fieldForce = fieldInfo->plugin()->force(fieldInfo, m_solutionIDs[fieldInfo].timeStep, m_solutionIDs[fieldInfo].adaptivityStep, m_solutionIDs[fieldInfo].solutionMode,
+                fieldForce = fieldInfo->plugin()->force(fieldInfo, m_solutionIDs.at(fieldIndex).timeStep, workspace.solutions.at(fieldIndex),
                                                         activeElement, material, position, velocity)
-                        * m_particleChargesList[particleIndex];
+                        * m_particleChargesList.at(particleIndex);
             }
             catch (AgrosException e)
             {
@@ -140,95 +247,63 @@ Point3 ParticleTracing::force(int particleIndex,
         totalFieldForce = totalFieldForce + fieldForce;
     }
 
-    // particle to particle force
+    // particle to particle force (cartesian coordinates)
     Point3 forceP2PElectric;
     Point3 forceP2PMagnetic;
-    if (Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleP2PElectricForce).toBool() ||
-            Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleP2PMagneticForce).toBool())
+    if (m_p2pElectricForce || m_p2pMagneticForce)
     {
-        for (int i = 0; i < m_positionsList.size(); i++)
+        Point3 positionCartesian = cartesian(position);
+        Point3 velocityCartesian = cartesianVelocity(position, (m_coordinateType == CoordinateType_Planar) ?
+                                                         velocity : Point3(velocity.x, velocity.y, position.x * velocity.z));
+
+        Point3 electricSum;
+        Point3 magneticSum;
+        if (m_p2pOpeningAngle > 0.0)
         {
-            if (particleIndex == i)
-                continue;
+            // tree code (other particles at trajectory levels of the round time)
+            m_forceTree.evaluate(positionCartesian, velocityCartesian, particleIndex, m_p2pOpeningAngle,
+                                 m_p2pElectricForce, m_p2pMagneticForce, electricSum, magneticSum);
 
-            int timeLevel = timeToLevel(i, m_timesList[particleIndex].last());
-            Point3 particlePosition = m_positionsList[i].at(timeLevel);
-            Point3 particleVelocity = m_velocitiesList[i].at(timeLevel);
+            // particles with different trajectory level at the time of the particle are replaced (same levels as exact computation)
+            for (int k = 0; k < m_forceTreeChanges.size() && m_forceTreeChanges.at(k).first <= time; k++)
+            {
+                int i = m_forceTreeChanges.at(k).second;
+                if (particleIndex == i)
+                    continue;
 
-            double distance = 0.0;
-            if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
-                distance = Point3(position.x - particlePosition.x,
-                                  position.y - particlePosition.y,
-                                  position.z - particlePosition.z).magnitude();
-            else
-                distance = Point3(position.x * cos(position.z) - particlePosition.x * cos(particlePosition.z),
-                                  position.y - particlePosition.y,
-                                  position.x * sin(position.z) - particlePosition.x * sin(particlePosition.z)).magnitude();
+                int timeLevel = timeToLevel(i, time);
+                if (timeLevel == m_forceTreeLevels.at(i))
+                    continue;
 
-            if (distance > 0)
+                addParticleForce(positionCartesian, velocityCartesian, i, m_forceTreeLevels.at(i), -1.0, electricSum, magneticSum);
+                addParticleForce(positionCartesian, velocityCartesian, i, timeLevel, 1.0, electricSum, magneticSum);
+            }
+        }
+        else
+        {
+            for (int i = 0; i < m_positionsList.size(); i++)
             {
-                if (Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleP2PElectricForce).toBool())
-                {
-                    if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
-                        forceP2PElectric = forceP2PElectric + Point3(
-                                    (position.x - particlePosition.x) / distance,
-                                    (position.y - particlePosition.y) / distance,
-                                    (position.z - particlePosition.z) / distance)
-                                * (m_particleChargesList[particleIndex] * m_particleChargesList[i] / (4 * M_PI * EPS0 * distance * distance));
-                    else
-                        forceP2PElectric = forceP2PElectric + Point3(
-                                    (position.x * cos(position.z) - particlePosition.x * cos(particlePosition.z)) / distance,
-                                    (position.y - particlePosition.y) / distance,
-                                    (position.x * sin(position.z) - particlePosition.x * sin(particlePosition.z)) / distance)
-                                * (m_particleChargesList[particleIndex] * m_particleChargesList[i] / (4 * M_PI * EPS0 * distance * distance));
-                }
-                if (Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleP2PMagneticForce).toBool())
-                {
-                    Point3 r0, v0;
-                    if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
-                    {
-                        r0 = Point3((position.x - particlePosition.x) / distance,
-                                    (position.y - particlePosition.y) / distance,
-                                    (position.z - particlePosition.z) / distance);
-                        v0 = Point3(velocity.x - particleVelocity.x,
-                                    velocity.y - particleVelocity.y,
-                                    velocity.z - particleVelocity.z);
-                    }
-                    else
-                    {
-                        r0 = Point3((position.x * cos(position.z) - particlePosition.x * cos(particlePosition.z)) / distance,
-                                    (position.y - particlePosition.y) / distance,
-                                    (position.x * sin(position.z) - particlePosition.x * sin(particlePosition.z)) / distance);
-                        // TODO: fix velocity
-                        assert(0);
-                        v0 = Point3(velocity.x * cos(position.z) - particleVelocity.x * cos(particlePosition.z),
-                                    velocity.y - particleVelocity.y,
-                                    velocity.x * sin(position.z) - particleVelocity.x * sin(particlePosition.z));
-                    }
-
-                    forceP2PMagnetic = forceP2PMagnetic + (v0 % v0 % r0)
-                            * (m_particleChargesList[particleIndex] * m_particleChargesList[i] * MU0 / (4 * M_PI * distance * distance));
+                if (particleIndex == i)
+                    continue;
 
-                }
+                addParticleForce(positionCartesian, velocityCartesian, i, timeToLevel(i, time), 1.0, electricSum, magneticSum);
             }
         }
+
+        forceP2PElectric = cylindrical(position, electricSum) * (m_particleChargesList.at(particleIndex) / (4 * M_PI * EPS0));
+        forceP2PMagnetic = cylindrical(position, magneticSum) * (m_particleChargesList.at(particleIndex) * MU0 / (4 * M_PI));
     }
 
     // custom force
-    Point3 forceCustom = Point3(Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCustomForceX).toDouble(),
-                                Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCustomForceY).toDouble(),
-                                Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCustomForceZ).toDouble());
+    Point3 forceCustom = m_customForce;
 
     // Drag force
-    Point3 velocityReal = (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar) ?
+    Point3 velocityReal = (m_coordinateType == CoordinateType_Planar) ?
                 velocity : Point3(velocity.x, velocity.y, position.x * velocity.z);
     Point3 forceDrag;
     if (velocityReal.magnitude() > 0.0)
         forceDrag = velocityReal.normalizePoint() *
-                - 0.5 * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleDragDensity).toDouble()
-                * velocityReal.magnitude() * velocityReal.magnitude()
-                * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleDragCoefficient).toDouble()
-                * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleDragReferenceArea).toDouble();
+                - m_dragFactor * velocityReal.magnitude() * velocityReal.magnitude();
 
     // Total force
     Point3 totalForce = totalFieldForce + forceDrag + forceCustom + forceP2PElectric + forceP2PMagnetic;
@@ -236,7 +311,9 @@ Point3 ParticleTracing::force(int particleIndex,
     return totalForce;
 }
 
-bool ParticleTracing::newtonEquations(int particleIndex,
+bool ParticleTracing::newtonEquations(ParticleTracingWorkspace &workspace,
+                                      int particleIndex,
+                                      double time,
                                       double step,
                                       Point3 position,
                                       Point3 velocity,
@@ -244,19 +321,19 @@ bool ParticleTracing::newtonEquations(int particleIndex,
                                       Point3 *newvelocity)
 {
     // relativistic correction
-    double mass = m_particleMassesList[particleIndex];
-    if (Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleIncludeRelativisticCorrection).toBool())
+    double mass = m_particleMassesList.at(particleIndex);
+    if (m_includeRelativisticCorrection)
     {
-        Point3 velocityReal = (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar) ?
+        Point3 velocityReal = (m_coordinateType == CoordinateType_Planar) ?
                     velocity : Point3(velocity.x, velocity.y, position.x * velocity.z);
 
         mass = mass / (sqrt(1.0 - (velocityReal.magnitude() * velocityReal.magnitude()) / (SPEEDOFLIGHT * SPEEDOFLIGHT)));
     }
 
     // Total acceleration
-    Point3 totalAccel = force(particleIndex, position, velocity) / mass;
+    Point3 totalAccel = force(workspace, particleIndex, time, position, velocity) / mass;
 
-    if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
+    if (m_coordinateType == CoordinateType_Planar)
     {
         // position
         *newposition = velocity * step;
@@ -278,18 +355,387 @@ bool ParticleTracing::newtonEquations(int particleIndex,
     return true;
 }
 
-int ParticleTracing::timeToLevel(int particleIndex, double time)
+int ParticleTracing::timeToLevel(int particleIndex, double time) const
 {
-    if (m_timesList[particleIndex].size() == 1)
+    const QList<double> &times = m_timesList.at(particleIndex);
+
+    if (times.size() == 1)
         return 0;
-    else if (time >= m_timesList[particleIndex].last())
-        return m_timesList[particleIndex].size() - 1;
+    else if (time >= times.last())
+        return times.size() - 1;
+
+    // first level with t_i <= time <= t_i+1 (times are sorted)
+    int level = qLowerBound(times.begin(), times.end(), time) - times.begin();
+    return qMax(0, level - 1);
+}
+
+void ParticleTracing::addParticleForce(const Point3 &position, const Point3 &velocity, int particleIndex, int timeLevel, double sign,
+                                       Point3 &electricSum, Point3 &magneticSum) const
+{
+    const Point3 &particlePosition = m_positionsList.at(particleIndex).at(timeLevel);
+
+    Point3 difference = position - cartesian(particlePosition);
+    double distance = difference.magnitude();
+    if (distance > 0.0)
+    {
+        Point3 r0 = difference / distance;
+        double factor = sign * m_particleChargesList.at(particleIndex) / (distance * distance);
+
+        if (m_p2pElectricForce)
+            electricSum = electricSum + r0 * factor;
+        if (m_p2pMagneticForce)
+        {
+            Point3 v0 = velocity - cartesianVelocity(particlePosition, m_velocitiesList.at(particleIndex).at(timeLevel));
+            magneticSum = magneticSum + (v0 % v0 % r0) * factor;
+        }
+    }
+}
+
+void ParticleTracing::buildForceTree(double time)
+{
+    int numberOfParticles = m_positionsList.size();
+
+    QVector<Point3> positions(numberOfParticles);
+    QVector<Point3> velocities(numberOfParticles);
+    QVector<double> charges(numberOfParticles);
+
+    m_forceTreeLevels.resize(numberOfParticles);
+    m_forceTreeChanges.clear();
+    for (int i = 0; i < numberOfParticles; i++)
+    {
+        int timeLevel = timeToLevel(i, time);
+        const Point3 &position = m_positionsList.at(i).at(timeLevel);
+
+        positions[i] = cartesian(position);
+        velocities[i] = cartesianVelocity(position, m_velocitiesList.at(i).at(timeLevel));
+        charges[i] = m_particleChargesList.at(i);
+
+        // level at later times can differ only from the first time of trajectory not before the time of the tree
+        m_forceTreeLevels[i] = timeLevel;
+
+        const QList<double> &times = m_timesList.at(i);
+        QList<double>::const_iterator next = qLowerBound(times.begin(), times.end(), time);
+        if (next != times.end())
+            m_forceTreeChanges.append(QPair<double, int>(*next, i));
+    }
+    qSort(m_forceTreeChanges);
+
+    m_forceTree.build(positions, velocities, charges);
+}
+
+bool ParticleTracing::checkStop(int particleIndex)
+{
+    ParticleState &state = *m_storages.at(particleIndex).state;
+
+    // stop on number of steps
+    if (state.numberOfSteps > m_maximumNumberOfSteps - 1)
+        state.stop = true;
+
+    // stop on time steps
+    if (state.timeStep < EPS_ZERO / 100.0)
+        state.stop = true;
+
+    return state.stop;
+}
+
+void ParticleTracing::computeStep(ParticleTracingWorkspace &workspace, int particleIndex)
+{
+    ParticleState &state = *m_storages.at(particleIndex).state;
+    Hermes::ButcherTable &butcher = *workspace.butcher;
+
+    double relErrorMin = 1e-3;
+
+    // increase number of steps
+    state.numberOfSteps++;
+
+    // initial position and velocity
+    const ParticleStorage &storage = m_storages.at(particleIndex);
+    double time = storage.times->last();
+    Point3 position = storage.positions->last();
+    Point3 velocity = storage.velocities->last();
+    if (m_coordinateType == CoordinateType_Axisymmetric)
+        velocity.z = velocity.z / position.x; // v_phi = omega * r
+    double currentTimeStep = state.timeStep;
+    // qDebug() << currentTimeStep;
+
+    // Runge-Kutta steps
+    Point3 newPositionH;
+    Point3 newVelocityH;
+
+    // Butcher tableu
+    QVector<Point3> kp(butcher.get_size());
+    QVector<Point3> kv(butcher.get_size());
+
+    int maxStepsRKF = 0;
+    while (!state.stop && maxStepsRKF < 100)
+    {
+        maxStepsRKF++;
+
+        bool butcherOK = true;
+
+        for (int k = 0; k < butcher.get_size(); k++)
+        {
+            Point3 pos = position;
+            Point3 vel = velocity;
+
+            for (int l = 0; l < butcher.get_size(); l++)
+            {
+                if (l < k)
+                {
+                    pos = pos + kp[l] * butcher.get_A(k, l);
+                    vel = vel + kv[l] * butcher.get_A(k, l);
+                }
+            }
+
+            if (m_includeRelativisticCorrection
+                    && ((m_coordinateType == CoordinateType_Planar
+                         ? vel.magnitude() : Point3(vel.x, vel.y, pos.x * vel.z).magnitude()) > SPEEDOFLIGHT))
+            {
+                // decrease time step
+                butcherOK = false;
+                break;
+            }
+
+            newtonEquations(workspace, particleIndex, time, currentTimeStep, pos, vel, &kp[k], &kv[k]);
+        }
+
+        if (butcherOK)
+        {
+            // low order
+            Point3 newPositionL = position;
+            Point3 newVelocityL = velocity;
+            for (int k = 0; k < butcher.get_size() - 1; k++)
+            {
+                newPositionL = newPositionL + kp[k] * butcher.get_B2(k);
+                newVelocityL = newVelocityL + kv[k] * butcher.get_B2(k);
+            }
+
+            // high order
+            newPositionH = position;
+            newVelocityH = velocity;
+            for (int k = 0; k < butcher.get_size(); k++)
+            {
+                newPositionH = newPositionH + kp[k] * butcher.get_B(k);
+                newVelocityH = newVelocityH + kv[k] * butcher.get_B(k);
+            }
+
+            // optimal step estimation
+            double absErrorPos = fabs(newPositionH.magnitude() - newPositionL.magnitude());
+            double relErrorPos = fabs(absErrorPos / newPositionH.magnitude());
+            double absErrorVel = fabs(newVelocityH.magnitude() - newVelocityL.magnitude());
+            double relErrorVel = fabs(absErrorVel / newVelocityH.magnitude());
+            double currentStepLength = ((m_coordinateType == CoordinateType_Planar) ?
+                                            (position - newPositionH).magnitude() :
+                                            (Point3(position.x * cos(position.z), position.x * sin(position.z), position.y)
+                                             - Point3(newPositionH.x * cos(newPositionH.z), newPositionH.x * sin(newPositionH.z), newPositionH.y)).magnitude());
+            double currentStepVelocity = ((m_coordinateType == CoordinateType_Planar) ?
+                                              (velocity - newVelocityH).magnitude() :
+                                              (Point3(velocity.x, velocity.y, position.x * velocity.z) - Point3(newVelocityH.x, newVelocityH.y, newPositionH.x * newVelocityH.z)).magnitude());
+
+            // nearly zero step
+            // qDebug() << "currentTimeStep" << currentTimeStep << "currentStepLength" << currentStepLength << "currentStepVelocity" << currentStepVelocity << "absErrorPos" << absErrorPos << "relErrorPos" << relErrorPos << "absErrorVel" << absErrorVel << "relErrorVel" << relErrorVel;
+            if (currentStepLength < EPS_ZERO && currentStepVelocity < EPS_ZERO)
+            {
+                qDebug() << QString("Particle %1: time step is too short - refused.").arg(particleIndex);
+                currentTimeStep *= 3.0;
+                continue;
+            }
+
+            // minimum step
+            if ((currentStepLength > m_maximumStep) || (relErrorVel > m_maximumRelativeError && relErrorPos > m_maximumRelativeError))
+            {
+                // decrease step
+                qDebug() << QString("Particle %1: time step is too long or relative error was exceeded - refused.").arg(particleIndex);
+                currentTimeStep /= 2.0;
+                continue;
+            }
+            // relative tolerance
+            else if ((relErrorVel < relErrorMin && relErrorPos < relErrorMin))
+            {
+                // increase next step
+                qDebug() << QString("Particle %1: time step increased.").arg(particleIndex);
+                double optStep = 0.8 * currentTimeStep * pow((relErrorMin / relErrorPos), 0.25);
+                if (relErrorPos > 0 && optStep > currentTimeStep)
+                    state.timeStep = optStep;
+                else
+                    state.timeStep = 1.2 * currentTimeStep;
+                break;
+            }
+            else
+            {
+                // store current time step
+                state.timeStep = currentTimeStep;
+                break;
+            }
+        }
+        else
+        {
+            if (currentTimeStep < EPS_ZERO / 100.0)
+            {
+                // store current time step
+                state.timeStep = currentTimeStep;
+                // stop computation
+                break;
+            }
+            else
+            {
+                // decrease step
+                qDebug() << QString("Particle %1: the speed of light was exceeded - refused.").arg(particleIndex);
+                currentTimeStep /= 2.0;
+                continue;
+            }
+        }
+    }
+
+    // check crossing (edges close to the step)
+    RectPoint stepBox(Point(qMin(position.x, newPositionH.x) - EPS_ZERO, qMin(position.y, newPositionH.y) - EPS_ZERO),
+                      Point(qMax(position.x, newPositionH.x) + EPS_ZERO, qMax(position.y, newPositionH.y) + EPS_ZERO));
+
+    // find the closest intersection
+    Point intersect;
+    SceneEdge *crossingEdge = NULL;
+    bool crossingEdgeImpact = false;
+    double distance = numeric_limits<double>::max();
+    m_edgeIndex.edges(stepBox, workspace.edges);
+    for (int i = 0; i < workspace.edges.size(); i++)
+    {
+        int edgeIndex = workspace.edges.at(i);
+        SceneEdge *edge = m_edges.at(edgeIndex);
+
+        QList<Point> incts = intersection(Point(position.x, position.y), Point(newPositionH.x, newPositionH.y),
+                                          Point(), 0.0, 0.0,
+                                          edge->nodeStart()->point(), edge->nodeEnd()->point(),
+                                          edge->center(), edge->radius(), edge->angle());
+
+        foreach (Point p, incts)
+            if ((p - Point(position.x, position.y)).magnitude() < distance)
+            {
+                distance = (p - Point(position.x, position.y)).magnitude();
+
+                crossingEdge = edge;
+                crossingEdgeImpact = m_edgeImpact.at(edgeIndex);
+                intersect = p;
+            }
+    }
+
+    if (crossingEdge && distance > EPS_ZERO)
+    {
+        // current step ration
+        if (crossingEdgeImpact)
+        {
+            newPositionH.x = intersect.x;
+            newPositionH.y = intersect.y;
+
+            // qDebug() << particleIndex << "impact";
+            state.stop = true;
+        }
+        else
+        {
+            // input vector moved to the origin
+            Point vectin = Point(newPositionH.x, newPositionH.y) - intersect;
+
+            // tangent vector
+            Point tangent;
+            if (crossingEdge->isStraight())
+                tangent = (crossingEdge->nodeStart()->point() - crossingEdge->nodeEnd()->point()).normalizePoint();
+            else
+                tangent = Point((intersect.y - crossingEdge->center().y), -(intersect.x - crossingEdge->center().x)).normalizePoint();
+
+            Point idealReflectedPosition(intersect.x + (((tangent.x * tangent.x) - (tangent.y * tangent.y)) * vectin.x + 2.0*tangent.x*tangent.y * vectin.y),
+                                         intersect.y + (2.0*tangent.x*tangent.y * vectin.x + ((tangent.y * tangent.y) - (tangent.x * tangent.x)) * vectin.y));
+
+            double ratio = (Point(position.x, position.y) - intersect).magnitude()
+                    / (Point(newPositionH.x, newPositionH.y) - Point(position.x, position.y)).magnitude();
+
+            // output vector
+            Point vectout = (idealReflectedPosition - intersect).normalizePoint();
+
+            // stop computation (impact distance is very very small)
+            if ((fabs(distance / 100.0 * vectout.x) < EPS_ZERO) && (fabs(distance / 100.0 * vectout.y) < EPS_ZERO))
+                state.stop = true;
+
+            // output point
+            newPositionH.x = intersect.x + distance / 100.0 * vectout.x;
+            newPositionH.y = intersect.y + distance / 100.0 * vectout.y;
+
+            // velocity in the direction of output vector
+            Point3 oldv = newVelocityH;
+            newVelocityH.x = vectout.x * Point(oldv.x, oldv.y).magnitude() * m_coefficientOfRestitution;
+            newVelocityH.y = vectout.y * Point(oldv.x, oldv.y).magnitude() * m_coefficientOfRestitution;
+
+            // set new timestep
+            currentTimeStep = currentTimeStep * ratio;
+            state.timeStep = currentTimeStep;
+        }
+    }
+
+    // new values
+    state.time = time + currentTimeStep;
+    state.position = newPositionH;
+
+    // velocities in planar and axisymmetric arrangement
+    if (m_coordinateType == CoordinateType_Planar)
+        state.velocity = newVelocityH;
     else
-        for (int i = 0; i < m_timesList[particleIndex].size() - 1; i++)
-            if ((m_timesList[particleIndex].at(i) <= time) && (time <= m_timesList[particleIndex].at(i+1)))
-                return i;
+        state.velocity = Point3(newVelocityH.x, newVelocityH.y, newPositionH.x * newVelocityH.z); // v_phi = omega * r
+}
+
+void ParticleTracing::appendStep(int particleIndex)
+{
+    const ParticleStorage &storage = m_storages.at(particleIndex);
+
+    // add to the lists
+    storage.times->append(storage.state->time);
+    storage.positions->append(storage.state->position);
+    storage.velocities->append(storage.state->velocity);
+}
+
+void ParticleTracing::traceParticle(ParticleTracingWorkspace &workspace, int particleIndex)
+{
+    while (!checkStop(particleIndex))
+    {
+        computeStep(workspace, particleIndex);
+        appendStep(particleIndex);
+    }
+}
+
+void ParticleTracing::runParallel(QThreadPool &pool, QList<ParticleTracingWorkspace> &workspaces, const QList<int> &particles,
+                                  void (ParticleTracing::*job)(ParticleTracingWorkspace &, int))
+{
+    int numberOfWorkers = qMin(workspaces.count(), particles.count());
+
+    // without threads
+    if (numberOfWorkers <= 1)
+    {
+        foreach (int particleIndex, particles)
+            (this->*job)(workspaces[0], particleIndex);
+
+        return;
+    }
+
+    QAtomicInt next(0);
+
+    QList<ParticleTracingRunnable *> runnables;
+    for (int i = 0; i < numberOfWorkers; i++)
+    {
+        ParticleTracingRunnable *runnable = new ParticleTracingRunnable(this, job, &workspaces[i], particles, &next);
+        runnable->setAutoDelete(false);
+        runnables.append(runnable);
+
+        pool.start(runnable);
+    }
+    pool.waitForDone();
+
+    QString error;
+    foreach (ParticleTracingRunnable *runnable, runnables)
+    {
+        if (error.isEmpty())
+            error = runnable->error();
+        delete runnable;
+    }
 
-    assert(0);
+    if (!error.isEmpty())
+        throw AgrosException(error);
 }
 
 void ParticleTracing::computeTrajectoryParticles(const QList<Point3> initialPositions, const QList<Point3> initialVelocities,
@@ -303,28 +749,18 @@ void ParticleTracing::computeTrajectoryParticles(const QList<Point3> initialPosi
     m_particleChargesList = particleCharges;
     m_particleMassesList = particleMasses;
 
-    Hermes::ButcherTable butcher((Hermes::ButcherTableType) Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleButcherTableType).toInt());
-
     clear();
+    readSettings();
 
     int numberOfParticles = Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleNumberOfParticles).toInt();
 
     QTime timePart;
     timePart.start();
 
-    RectPoint bound = Agros2D::scene()->boundingBox();
-
-    double maxStep = (Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMaximumStep).toDouble() > 0.0)
-            ? Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMaximumStep).toDouble() :
-              min(bound.width(), bound.height()) / 80.0;
-    double relErrorMax = (Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMaximumRelativeError).toDouble() > 0.0)
-            ? Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMaximumRelativeError).toDouble() : 1e-6;
-    double relErrorMin = 1e-3;
-
-    // given velocity
-    QList<bool> stopComputation;
-    QList<int> numberOfSteps;
-    QList<double> timeStep;
+    // time dependent materials (not updated during force evaluation)
+    for (int i = 0; i < m_fieldInfos.count(); i++)
+        if (m_fieldInfos.at(i)->analysisType() == AnalysisType_Transient)
+            Module::updateTimeFunctions(Agros2D::solutionStore()->timeLevels(m_fieldInfos.at(i)).at(m_solutionIDs.at(i).timeStep));
 
     // initial positions
     for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
@@ -338,307 +774,110 @@ void ParticleTracing::computeTrajectoryParticles(const QList<Point3> initialPosi
         m_velocitiesList[particleIndex].append(initialVelocities[particleIndex]);
         m_timesList[particleIndex].append(0);
 
-        stopComputation.append(false);
-        numberOfSteps.append(0);
-
         // timeStep.append(initialVelocities[particleIndex].magnitude() > 0
         //                 ? qMax(bound.width(), bound.height()) / initialVelocities[particleIndex].magnitude() / 10 : 1e-11);
-        timeStep.append(1e-11);
+        m_states.append(ParticleState(m_fieldInfos.count()));
     }
 
-    bool globalStopComputation = false;
-    while (!globalStopComputation)
+    // storage of particles (containers are detached here, workers do not touch the outer containers)
+    for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
     {
-        double syncTime = 0.0;
-        int syncParticle = -1;
-        for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
-            if (m_timesList[particleIndex].last() > syncTime)
-            {
-                syncTime = m_timesList[particleIndex].last();
-                syncParticle = particleIndex;
-            }
-
-        double timeStp = 0.0;
-        if (syncParticle == -1)
-        for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
-            if (timeStep[particleIndex] > timeStp)
-            {
-                timeStp = timeStep[particleIndex];
-                syncParticle = particleIndex;
-            }
+        ParticleStorage storage;
+        storage.state = m_states.data() + particleIndex;
+        storage.times = &m_timesList[particleIndex];
+        storage.positions = &m_positionsList[particleIndex];
+        storage.velocities = &m_velocitiesList[particleIndex];
 
-        for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
-        {
-            // stop on number of steps
-            if (numberOfSteps[particleIndex] > Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMaximumNumberOfSteps).toInt() - 1)
-                stopComputation[particleIndex] = true;
-
-            // stop on time steps
-            if (timeStep[particleIndex] < EPS_ZERO / 100.0)
-                stopComputation[particleIndex] = true;
-
-            if (stopComputation[particleIndex])
-                continue;
-
-            // sync
-            if (!stopComputation[particleIndex] && particleIndex == syncParticle)
-            {
-                bool otherParticlesIsRunning = false;
-                for (int particleIndexOther = 0; particleIndexOther < numberOfParticles; particleIndexOther++)
-                    if (particleIndex != particleIndexOther && !stopComputation[particleIndexOther])
-                        otherParticlesIsRunning = true;
-
-                if (otherParticlesIsRunning)
-                    continue;
-            }
-
-            // increase number of steps
-            numberOfSteps[particleIndex]++;
-
-            // initial position and velocity
-            Point3 position = m_positionsList[particleIndex].last();
-            Point3 velocity = m_velocitiesList[particleIndex].last();
-            if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Axisymmetric)
-                velocity.z = velocity.z / position.x; // v_phi = omega * r
-            double currentTimeStep = timeStep[particleIndex];
-            // qDebug() << currentTimeStep;
+        m_storages.append(storage);
+    }
 
-            // Runge-Kutta steps
-            Point3 newPositionH;
-            Point3 newVelocityH;
+    // workspaces of threads (first worker uses solutions from the solution store)
+    int numberOfThreads = qBound(1, Agros2D::configComputer()->value(Config::Config_NumberOfThreads).toInt(), qMax(1, numberOfParticles));
 
-            // Butcher tableu
-            QVector<Point3> kp(butcher.get_size());
-            QVector<Point3> kv(butcher.get_size());
+    QList<ParticleTracingWorkspace> workspaces;
+    for (int i = 0; i < numberOfThreads; i++)
+        workspaces.append(createWorkspace(i > 0));
 
-            int maxStepsRKF = 0;
-            while (!stopComputation[particleIndex] && maxStepsRKF < 100)
-            {
-                bool butcherOK = true;
+    QThreadPool pool;
+    pool.setMaxThreadCount(numberOfThreads);
 
-                for (int k = 0; k < butcher.get_size(); k++)
-                {
-                    Point3 pos = position;
-                    Point3 vel = velocity;
-
-                    for (int l = 0; l < butcher.get_size(); l++)
-                    {
-                        if (l < k)
-                        {
-                            pos = pos + kp[l] * butcher.get_A(k, l);
-                            vel = vel + kv[l] * butcher.get_A(k, l);
-                        }
-                    }
-
-                    if ((Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleIncludeRelativisticCorrection).toBool())
-                            && ((Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar
-                                 ? vel.magnitude() : Point3(vel.x, vel.y, pos.x * vel.z).magnitude()) > SPEEDOFLIGHT))
-                    {
-                        // decrease time step
-                        butcherOK = false;
-                        break;
-                    }
-
-                    newtonEquations(particleIndex, currentTimeStep, pos, vel, &kp[k], &kv[k]);
-                }
+    if (!m_p2pElectricForce && !m_p2pMagneticForce)
+    {
+        // independent particles are traced to the end by one worker
+        QList<int> particles;
+        for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
+            particles.append(particleIndex);
 
-                if (butcherOK)
-                {
-                    // low order
-                    Point3 newPositionL = position;
-                    Point3 newVelocityL = velocity;
-                    for (int k = 0; k < butcher.get_size() - 1; k++)
-                    {
-                        newPositionL = newPositionL + kp[k] * butcher.get_B2(k);
-                        newVelocityL = newVelocityL + kv[k] * butcher.get_B2(k);
-                    }
-
-                    // high order
-                    newPositionH = position;
-                    newVelocityH = velocity;
-                    for (int k = 0; k < butcher.get_size(); k++)
-                    {
-                        newPositionH = newPositionH + kp[k] * butcher.get_B(k);
-                        newVelocityH = newVelocityH + kv[k] * butcher.get_B(k);
-                    }
-
-                    // optimal step estimation
-                    double absErrorPos = fabs(newPositionH.magnitude() - newPositionL.magnitude());
-                    double relErrorPos = fabs(absErrorPos / newPositionH.magnitude());
-                    double absErrorVel = fabs(newVelocityH.magnitude() - newVelocityL.magnitude());
-                    double relErrorVel = fabs(absErrorVel / newVelocityH.magnitude());
-                    double currentStepLength = ((Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar) ?
-                                                    (position - newPositionH).magnitude() :
-                                                    (Point3(position.x * cos(position.z), position.x * sin(position.z), position.y)
-                                                     - Point3(newPositionH.x * cos(newPositionH.z), newPositionH.x * sin(newPositionH.z), newPositionH.y)).magnitude());
-                    double currentStepVelocity = ((Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar) ?
-                                                      (velocity - newVelocityH).magnitude() :
-                                                      (Point3(velocity.x, velocity.y, position.x * velocity.z) - Point3(newVelocityH.x, newVelocityH.y, newPositionH.x * newVelocityH.z)).magnitude());
-
-                    // nearly zero step
-                    // qDebug() << "currentTimeStep" << currentTimeStep << "currentStepLength" << currentStepLength << "currentStepVelocity" << currentStepVelocity << "absErrorPos" << absErrorPos << "relErrorPos" << relErrorPos << "absErrorVel" << absErrorVel << "relErrorVel" << relErrorVel;
-                    if (currentStepLength < EPS_ZERO && currentStepVelocity < EPS_ZERO)
-                    {
-                        qDebug() << QString("Particle %1: time step is too short - refused.").arg(particleIndex);
-                        currentTimeStep *= 3.0;
-                        continue;
-                    }
-
-                    // minimum step
-                    if ((currentStepLength > maxStep) || (relErrorVel > relErrorMax && relErrorPos > relErrorMax))
-                    {
-                        // decrease step
-                        qDebug() << QString("Particle %1: time step is too long or relative error was exceeded - refused.").arg(particleIndex);
-                        currentTimeStep /= 2.0;
-                        continue;
-                    }
-                    // relative tolerance
-                    else if ((relErrorVel < relErrorMin && relErrorPos < relErrorMin))
-                    {
-                        // increase next step
-                        qDebug() << QString("Particle %1: time step increased.").arg(particleIndex);
-                        double optStep = 0.8 * currentTimeStep * pow((relErrorMin / relErrorPos), 0.25);
-                        if (relErrorPos > 0 && optStep > currentTimeStep)
-                            timeStep[particleIndex] = optStep;
-                        else
-                            timeStep[particleIndex] = 1.2 * currentTimeStep;
-                        break;
-                    }
-                    else
-                    {
-                        // store current time step
-                        timeStep[particleIndex] = currentTimeStep;
-                        break;
-                    }
-                }
-                else
+        runParallel(pool, workspaces, particles, &ParticleTracing::traceParticle);
+    }
+    else
+    {
+        // particle to particle forces, steps of all particles in one round are computed in parallel
+        // from the trajectories at the beginning of the round and appended after the round
+        bool globalStopComputation = false;
+        while (!globalStopComputation)
+        {
+            double syncTime = 0.0;
+            int syncParticle = -1;
+            for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
+                if (m_timesList.at(particleIndex).last() > syncTime)
                 {
-                    if (currentTimeStep < EPS_ZERO / 100.0)
-                    {
-                        // store current time step
-                        timeStep[particleIndex] = currentTimeStep;
-                        // stop computation
-                        break;
-                    }
-                    else
-                    {
-                        // decrease step
-                        qDebug() << QString("Particle %1: the speed of light was exceeded - refused.").arg(particleIndex);
-                        currentTimeStep /= 2.0;
-                        continue;
-                    }
+                    syncTime = m_timesList.at(particleIndex).last();
+                    syncParticle = particleIndex;
                 }
-            }
-
-            // check crossing
-            QMap<SceneEdge *, Point> intersections;
-            foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
-            {
-                QList<Point> incts = intersection(Point(position.x, position.y), Point(newPositionH.x, newPositionH.y),
-                                                  Point(), 0.0, 0.0,
-                                                  edge->nodeStart()->point(), edge->nodeEnd()->point(),
-                                                  edge->center(), edge->radius(), edge->angle());
-
-                if (incts.length() > 0)
-                    foreach (Point p, incts)
-                        intersections.insert(edge, p);
-            }
 
-            // find the closest intersection
-            Point intersect;
-            SceneEdge *crossingEdge = NULL;
-            double distance = numeric_limits<double>::max();
-            for (QMap<SceneEdge *, Point>::const_iterator it = intersections.begin(); it != intersections.end(); ++it)
-                if ((it.value() - Point(position.x, position.y)).magnitude() < distance)
+            double timeStp = 0.0;
+            if (syncParticle == -1)
+            for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
+                if (m_states.at(particleIndex).timeStep > timeStp)
                 {
-                    distance = (it.value() - Point(position.x, position.y)).magnitude();
-
-                    crossingEdge = it.key();
-                    intersect = it.value();
+                    timeStp = m_states.at(particleIndex).timeStep;
+                    syncParticle = particleIndex;
                 }
 
-            if (crossingEdge && distance > EPS_ZERO)
+            QList<int> particles;
+            for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
             {
-                bool impact = false;
-                foreach (FieldInfo* fieldInfo, Agros2D::problem()->fieldInfos())
-                {
-                    if ((Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCoefficientOfRestitution).toDouble() < EPS_ZERO) || // no reflection
-                            (crossingEdge->marker(fieldInfo) == Agros2D::scene()->boundaries->getNone(fieldInfo)
-                             && !Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleReflectOnDifferentMaterial).toBool()) || // inner edge
-                            (crossingEdge->marker(fieldInfo) != Agros2D::scene()->boundaries->getNone(fieldInfo)
-                             && !Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleReflectOnBoundary).toBool())) // boundary
-                        impact = true;
-                }
+                if (checkStop(particleIndex))
+                    continue;
 
-                // current step ration
-                if (impact)
+                // sync
+                if (particleIndex == syncParticle)
                 {
-                    newPositionH.x = intersect.x;
-                    newPositionH.y = intersect.y;
+                    bool otherParticlesIsRunning = false;
+                    for (int particleIndexOther = 0; particleIndexOther < numberOfParticles; particleIndexOther++)
+                        if (particleIndex != particleIndexOther && !m_states.at(particleIndexOther).stop)
+                            otherParticlesIsRunning = true;
 
-                    // qDebug() << particleIndex << "impact";
-                    stopComputation[particleIndex] = true;
+                    if (otherParticlesIsRunning)
+                        continue;
                 }
-                else
-                {
-                    // input vector moved to the origin
-                    Point vectin = Point(newPositionH.x, newPositionH.y) - intersect;
-
-                    // tangent vector
-                    Point tangent;
-                    if (crossingEdge->isStraight())
-                        tangent = (crossingEdge->nodeStart()->point() - crossingEdge->nodeEnd()->point()).normalizePoint();
-                    else
-                        tangent = Point((intersect.y - crossingEdge->center().y), -(intersect.x - crossingEdge->center().x)).normalizePoint();
-
-                    Point idealReflectedPosition(intersect.x + (((tangent.x * tangent.x) - (tangent.y * tangent.y)) * vectin.x + 2.0*tangent.x*tangent.y * vectin.y),
-                                                 intersect.y + (2.0*tangent.x*tangent.y * vectin.x + ((tangent.y * tangent.y) - (tangent.x * tangent.x)) * vectin.y));
-
-                    double ratio = (Point(position.x, position.y) - intersect).magnitude()
-                            / (Point(newPositionH.x, newPositionH.y) - Point(position.x, position.y)).magnitude();
 
-                    // output vector
-                    Point vectout = (idealReflectedPosition - intersect).normalizePoint();
-
-                    // stop computation (impact distance is very very small)
-                    if ((fabs(distance / 100.0 * vectout.x) < EPS_ZERO) && (fabs(distance / 100.0 * vectout.y) < EPS_ZERO))
-                        stopComputation[particleIndex] = true;
-
-                    // output point
-                    newPositionH.x = intersect.x + distance / 100.0 * vectout.x;
-                    newPositionH.y = intersect.y + distance / 100.0 * vectout.y;
+                particles.append(particleIndex);
+            }
 
-                    // velocity in the direction of output vector
-                    Point3 oldv = newVelocityH;
-                    newVelocityH.x = vectout.x * Point(oldv.x, oldv.y).magnitude() * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCoefficientOfRestitution).toDouble();
-                    newVelocityH.y = vectout.y * Point(oldv.x, oldv.y).magnitude() * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCoefficientOfRestitution).toDouble();
+            // tree code: other particles at the time of the particle most behind,
+            // particles ahead are corrected to the levels of exact computation in force()
+            if (m_p2pOpeningAngle > 0.0 && !particles.isEmpty())
+            {
+                double roundTime = numeric_limits<double>::max();
+                foreach (int particleIndex, particles)
+                    roundTime = qMin(roundTime, m_timesList.at(particleIndex).last());
 
-                    // set new timestep
-                    currentTimeStep = currentTimeStep * ratio;
-                    timeStep[particleIndex] = currentTimeStep;
-                }
+                buildForceTree(roundTime);
             }
 
-            // new values
-            velocity = newVelocityH;
-            position = newPositionH;
+            runParallel(pool, workspaces, particles, &ParticleTracing::computeStep);
 
-            // add to the lists
-            m_timesList[particleIndex].append(m_timesList[particleIndex].last() + currentTimeStep);
-            m_positionsList[particleIndex].append(position);
+            foreach (int particleIndex, particles)
+                appendStep(particleIndex);
 
-            // velocities in planar and axisymmetric arrangement
-            if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
-                m_velocitiesList[particleIndex].append(velocity);
-            else
-                m_velocitiesList[particleIndex].append(Point3(velocity.x, velocity.y, position.x * velocity.z)); // v_phi = omega * r
+            // global stop
+            bool stop = true;
+            for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
+                stop = stop && m_states.at(particleIndex).stop;
+            globalStopComputation = stop;
         }
-
-        // global stop
-        bool stop = true;
-        for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
-            stop = stop && stopComputation[particleIndex];
-        globalStopComputation = stop;
     }
 
     // velocity min and max value
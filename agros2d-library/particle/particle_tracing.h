@@ -28,8 +28,23 @@
 
 #include "hermes2d/solutiontypes.h"
 
+#include "particle_force_tree.h"
+#include "scenegeometryindex.h"
+
 class FieldInfo;
 class SceneMaterial;
+class SceneEdge;
+class ElementLocator;
+
+// evaluation state of one worker thread (Hermes solutions are not reentrant, every worker uses own copies)
+struct ParticleTracingWorkspace
+{
+    // solutions of fields with force (in order of ParticleTracing fields)
+    QList<Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > > solutions;
+    QSharedPointer<Hermes::ButcherTable> butcher;
+    // edges close to the step (buffer reused by all steps)
+    QVector<int> edges;
+};
 
 class ParticleTracing : public QObject
 {
@@ -52,6 +67,25 @@ public:
     inline double velocityMax() const { return m_velocityMax; }
 
 private:
+    // state of particle during computation (touched only by the thread computing the particle)
+    struct ParticleState
+    {
+        ParticleState(int numberOfFields = 0)
+            : timeStep(1e-11), numberOfSteps(0), stop(false), activeElement(numberOfFields, NULL), time(0.0) {}
+
+        double timeStep;
+        int numberOfSteps;
+        bool stop;
+
+        // element with the last position (hint for element search)
+        QVector<Hermes::Hermes2D::Element *> activeElement;
+
+        // computed step (not yet in the trajectory)
+        Point3 position;
+        Point3 velocity;
+        double time;
+    };
+
     // input
     QList<double> m_particleChargesList;
     QList<double> m_particleMassesList;
@@ -64,20 +98,108 @@ private:
     double m_velocityMin;
     double m_velocityMax;
 
-    QMap<FieldInfo *, FieldSolutionID> m_solutionIDs;
-    QMap<FieldInfo *, Hermes::Hermes2D::MeshSharedPtr> m_meshes;
-    QMap<FieldInfo *, Hermes::Hermes2D::Element *> m_activeElement;
-
-    Point3 force(int particleIndex, Point3 position, Point3 velocity);
-
-    bool newtonEquations(int particleIndex,
+    // fields with force
+    QList<FieldInfo *> m_fieldInfos;
+    QList<FieldSolutionID> m_solutionIDs;
+    QList<QSharedPointer<ElementLocator> > m_locators;
+    QList<QVector<SceneMaterial *> > m_materials;
+
+    QVector<ParticleState> m_states;
+
+    // particle data used by worker threads (pointers are taken in the main thread before the workers start)
+    struct ParticleStorage
+    {
+        ParticleState *state;
+        QList<double> *times;
+        QList<Point3> *positions;
+        QList<Point3> *velocities;
+    };
+    QVector<ParticleStorage> m_storages;
+
+    // other particles for particle to particle forces (tree code)
+    ParticleForceTree m_forceTree;
+    // trajectory levels in the tree and first times with possibly different level (sorted)
+    QVector<int> m_forceTreeLevels;
+    QList<QPair<double, int> > m_forceTreeChanges;
+
+    // settings (problem settings are not accessed from worker threads)
+    CoordinateType m_coordinateType;
+    bool m_includeRelativisticCorrection;
+    bool m_p2pElectricForce;
+    bool m_p2pMagneticForce;
+    double m_p2pOpeningAngle;
+    Point3 m_customForce;
+    double m_dragFactor;
+    int m_maximumNumberOfSteps;
+    double m_maximumStep;
+    double m_maximumRelativeError;
+    double m_coefficientOfRestitution;
+    bool m_reflectOnDifferentMaterial;
+    bool m_reflectOnBoundary;
+
+    // edges of geometry (crossing is tested only for edges with bounding box intersecting the step)
+    QList<SceneEdge *> m_edges;
+    QVector<bool> m_edgeImpact;
+    SceneGeometryIndex m_edgeIndex;
+    Hermes::ButcherTableType m_butcherTableType;
+
+    void readSettings();
+    ParticleTracingWorkspace createWorkspace(bool cloneSolutions) const;
+
+    Point3 force(ParticleTracingWorkspace &workspace, int particleIndex, double time, Point3 position, Point3 velocity);
+
+    bool newtonEquations(ParticleTracingWorkspace &workspace,
+                         int particleIndex,
+                         double time,
                          double step,
                          Point3 position,
                          Point3 velocity,
                          Point3 *newposition,
                          Point3 *newvelocity);
 
-    int timeToLevel(int particleIndex, double time);
+    int timeToLevel(int particleIndex, double time) const;
+    void buildForceTree(double time);
+    // adds (sign 1) or removes (sign -1) force of the particle at trajectory level (cartesian, without constants and charge)
+    void addParticleForce(const Point3 &position, const Point3 &velocity, int particleIndex, int timeLevel, double sign,
+                          Point3 &electricSum, Point3 &magneticSum) const;
+
+    // distances for particle to particle forces (axisymmetric r, z, phi to x, z, y)
+    inline Point3 cartesian(const Point3 &position) const
+    {
+        return (m_coordinateType == CoordinateType_Planar) ? position :
+                                                             Point3(position.x * cos(position.z), position.y, position.x * sin(position.z));
+    }
+
+    // velocity (axisymmetric v_r, v_z, v_phi = omega * r) to x, z, y
+    inline Point3 cartesianVelocity(const Point3 &position, const Point3 &velocity) const
+    {
+        return (m_coordinateType == CoordinateType_Planar) ? velocity :
+                                                             Point3(velocity.x * cos(position.z) - velocity.z * sin(position.z),
+                                                                    velocity.y,
+                                                                    velocity.x * sin(position.z) + velocity.z * cos(position.z));
+    }
+
+    // force in x, z, y to axisymmetric r, z, phi components at the position
+    inline Point3 cylindrical(const Point3 &position, const Point3 &vector) const
+    {
+        return (m_coordinateType == CoordinateType_Planar) ? vector :
+                                                             Point3(vector.x * cos(position.z) + vector.z * sin(position.z),
+                                                                    vector.y,
+                                                                    - vector.x * sin(position.z) + vector.z * cos(position.z));
+    }
+
+    // checks stop conditions, returns true for stopped particle
+    bool checkStop(int particleIndex);
+    // one adaptive Runge-Kutta step from the end of the trajectory into the particle state,
+    // trajectories are only read (trajectories of other particles for particle to particle forces)
+    void computeStep(ParticleTracingWorkspace &workspace, int particleIndex);
+    void appendStep(int particleIndex);
+    // traces particle to the end (without particle to particle forces)
+    void traceParticle(ParticleTracingWorkspace &workspace, int particleIndex);
+
+    // job is called for every particle, workers take particles one by one (one workspace per worker)
+    void runParallel(QThreadPool &pool, QList<ParticleTracingWorkspace> &workspaces, const QList<int> &particles,
+                     void (ParticleTracing::*job)(ParticleTracingWorkspace &, int));
 };
 
 
@@ -0,0 +1,91 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "pydatatable.h"
+#include "pythonengine_agros.h"
+
+void PyDataTable::setValues(const vector<double> &keys, const vector<double> &values,
+                            const std::string &interpolation, const std::string &extrapolation,
+                            const std::string &derivativeAtEndpoints, bool uniformResampling)
+{
+    if (keys.size() != values.size())
+        throw invalid_argument(QObject::tr("Size doesn't match (%1 != %2).").arg(keys.size()).arg(values.size()).toStdString());
+
+    if (!dataTableTypeStringKeys().contains(QString::fromStdString(interpolation)))
+        throw invalid_argument(QObject::tr("Invalid parameter '%1'. Valid parameters: %2").arg(QString::fromStdString(interpolation))
+                               .arg(stringListToString(dataTableTypeStringKeys())).toStdString());
+
+    if (extrapolation != "constant" && extrapolation != "linear")
+        throw invalid_argument(QObject::tr("Invalid parameter '%1'. Valid parameters are 'constant' or 'linear'.").arg(QString::fromStdString(extrapolation)).toStdString());
+
+    if (derivativeAtEndpoints != "first" && derivativeAtEndpoints != "second")
+        throw invalid_argument(QObject::tr("Invalid parameter '%1'. Valid parameters are 'first' or 'second'.").arg(QString::fromStdString(derivativeAtEndpoints)).toStdString());
+
+    try
+    {
+        m_table.setValues(keys, values);
+        m_table.setType(dataTableTypeFromStringKey(QString::fromStdString(interpolation)));
+        m_table.setSplineFirstDerivatives(derivativeAtEndpoints == "first");
+        m_table.setExtrapolateConstant(extrapolation == "constant");
+        m_table.setUniformResampling(uniformResampling);
+    }
+    catch (AgrosException e)
+    {
+        m_table.clear();
+        throw invalid_argument(e.toString().toStdString());
+    }
+}
+
+void PyDataTable::checkEmpty() const
+{
+    if (m_table.isEmpty())
+        throw logic_error(QObject::tr("Data table is empty.").toStdString());
+}
+
+double PyDataTable::value(double key) const
+{
+    checkEmpty();
+
+    return m_table.value(key);
+}
+
+double PyDataTable::derivative(double key) const
+{
+    checkEmpty();
+
+    return m_table.derivative(key);
+}
+
+void PyDataTable::values(const vector<double> &keys, vector<double> &values) const
+{
+    checkEmpty();
+
+    values.resize(keys.size());
+    if (!keys.empty())
+        m_table.values(&keys[0], &values[0], (int) keys.size());
+}
+
+void PyDataTable::derivatives(const vector<double> &keys, vector<double> &derivatives) const
+{
+    checkEmpty();
+
+    derivatives.resize(keys.size());
+    if (!keys.empty())
+        m_table.derivatives(&keys[0], &derivatives[0], (int) keys.size());
+}
@@ -0,0 +1,50 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef PYTHONLABDATATABLE_H
+#define PYTHONLABDATATABLE_H
+
+#include "util/global.h"
+#include "datatable.h"
+
+// table of nonlinear material parameter (same interpolation as in materials)
+class PyDataTable
+{
+public:
+    PyDataTable() {}
+    ~PyDataTable() {}
+
+    void setValues(const vector<double> &keys, const vector<double> &values,
+                   const std::string &interpolation, const std::string &extrapolation,
+                   const std::string &derivativeAtEndpoints, bool uniformResampling);
+
+    double value(double key) const;
+    double derivative(double key) const;
+
+    // all keys at once (used by assembling of nonlinear materials)
+    void values(const vector<double> &keys, vector<double> &values) const;
+    void derivatives(const vector<double> &keys, vector<double> &derivatives) const;
+
+private:
+    DataTable m_table;
+
+    void checkEmpty() const;
+};
+
+#endif // PYTHONLABDATATABLE_H
@@ -0,0 +1,45 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "pyexpression.h"
+#include "parser/expression.h"
+
+void PyExpression::setExpression(const std::string &expression)
+{
+    if (expression.empty())
+        throw invalid_argument(QObject::tr("Expression is empty.").toStdString());
+
+    m_value.setText(QString::fromStdString(expression));
+}
+
+bool PyExpression::isCompiled() const
+{
+    CompiledExpression compiledExpression;
+
+    return compiledExpression.compile(m_value.text());
+}
+
+double PyExpression::value(double time, double x, double y) const
+{
+    Value value = m_value;
+    if (!value.evaluateAtTimeAndPoint(time, Point(x, y)))
+        throw logic_error(QObject::tr("Expression '%1' cannot be evaluated.").arg(m_value.text()).toStdString());
+
+    return value.number();
+}
@@ -327,6 +327,7 @@ void PyField::addMaterial(const std::string &name, const map<std::string, double
                 DataTableType dataTableType = DataTableType_PiecewiseLinear;
                 bool splineFirstDerivatives = true;
                 bool extrapolateConstant = true;
+                bool uniformResampling = false;
 
                 if (settings_map.find((*i).first) != settings_map.end())
                 {
@@ -361,6 +362,9 @@ void PyField::addMaterial(const std::string &name, const map<std::string, double
                             else
                                 throw invalid_argument(QObject::tr("Invalid parameter '%1'. Valid parameters are 'first' or 'second'.").arg(QString::fromStdString((*is).second)).toStdString());
                         }
+
+                        if (QString::fromStdString((*is).first) == "uniform_resampling")
+                            uniformResampling = (QString::fromStdString((*is).second) == "true");
                     }
                 }
 
@@ -373,14 +377,14 @@ void PyField::addMaterial(const std::string &name, const map<std::string, double
                         values[variable.id()] = Value((*i).second,
                                                       (lenx > 0) ? nonlin_x.at((*i).first) : vector<double>(),
                                                       (leny > 0) ? nonlin_y.at((*i).first) : vector<double>(),
-                                                      dataTableType, splineFirstDerivatives, extrapolateConstant);
+                                                      dataTableType, splineFirstDerivatives, extrapolateConstant, uniformResampling);
                     }
                     else
                     {
                         values[variable.id()] = Value(QString::fromStdString(expressions.at((*i).first)),
                                                       (lenx > 0) ? nonlin_x.at((*i).first) : vector<double>(),
                                                       (leny > 0) ? nonlin_y.at((*i).first) : vector<double>(),
-                                                      dataTableType, splineFirstDerivatives, extrapolateConstant);
+                                                      dataTableType, splineFirstDerivatives, extrapolateConstant, uniformResampling);
                     }
                 }
                 catch (AgrosException e)
@@ -430,6 +434,7 @@ void PyField::modifyMaterial(const std::string &name, const map<std::string, dou
                 DataTableType dataTableType = DataTableType_PiecewiseLinear;
                 bool splineFirstDerivatives = true;
                 bool extrapolateConstant = true;
+                bool uniformResampling = false;
 
                 if (settings_map.find((*i).first) != settings_map.end())
                 {
@@ -461,6 +466,9 @@ void PyField::modifyMaterial(const std::string &name, const map<std::string, dou
                             else
                                 throw invalid_argument(QObject::tr("Invalid parameter '%1'. Valid parameters are 'first' or 'second'.").arg(QString::fromStdString((*is).second)).toStdString());
                         }
+
+                        if (QString::fromStdString((*is).first) == "uniform_resampling")
+                            uniformResampling = (QString::fromStdString((*is).second) == "true");
                     }
                 }
 
@@ -472,13 +480,15 @@ void PyField::modifyMaterial(const std::string &name, const map<std::string, dou
                     {
                         sceneMaterial->modifyValue(QString::fromStdString((*i).first), Value((*i).second,
                                                                                           (lenx > 0) ? nonlin_x.at((*i).first) : vector<double>(),
-                                                                                          (leny > 0) ? nonlin_y.at((*i).first) : vector<double>()));
+                                                                                          (leny > 0) ? nonlin_y.at((*i).first) : vector<double>(),
+                                                                                          dataTableType, splineFirstDerivatives, extrapolateConstant, uniformResampling));
                     }
                     else
                     {
                         sceneMaterial->modifyValue(QString::fromStdString((*i).first), Value(QString::fromStdString(expressions.at((*i).first)),
                                                                                           (lenx > 0) ? nonlin_x.at((*i).first) : vector<double>(),
-                                                                                          (leny > 0) ? nonlin_y.at((*i).first) : vector<double>()));
+                                                                                          (leny > 0) ? nonlin_y.at((*i).first) : vector<double>(),
+                                                                                          dataTableType, splineFirstDerivatives, extrapolateConstant, uniformResampling));
                     }
                 }
                 catch (AgrosException e)
@@ -548,6 +558,71 @@ void PyField::localValues(double x, double y, int timeStep, int adaptivityStep,
     results = values;
 }
 
+void PyField::localValuesPoints(const vector<double> &x, const vector<double> &y, int timeStep, int adaptivityStep,
+                                const std::string &solutionType, map<std::string, vector<double> > &results) const
+{
+    map<std::string, vector<double> > values;
+
+    if (x.size() != y.size())
+        throw invalid_argument(QObject::tr("Coordinates must have the same length.").toStdString());
+
+    if (Agros2D::problem()->isSolved())
+    {
+        QVector<Point> points(x.size());
+        for (size_t i = 0; i < x.size(); i++)
+            points[i] = Point(x[i], y[i]);
+
+        SolutionMode solutionMode = getSolutionMode(QString::fromStdString(solutionType));
+
+        // set time and adaptivity step if -1 (default parameter - last steps), check steps
+        timeStep = getTimeStep(timeStep, solutionMode);
+        adaptivityStep = getAdaptivityStep(adaptivityStep, timeStep, solutionMode);
+
+        LocalValues *localValues = m_fieldInfo->plugin()->localValues(m_fieldInfo, timeStep, adaptivityStep, solutionMode, points);
+
+        // points outside of the field are NaN
+        double nan = numeric_limits<double>::quiet_NaN();
+        foreach (Module::LocalVariable variable, m_fieldInfo->localPointVariables())
+        {
+            QVector<LocalPointValue> pointValues = localValues->values(variable.id());
+            if (pointValues.isEmpty())
+                continue;
+
+            std::string shortname = variable.shortname().toStdString();
+            if (variable.isScalar())
+            {
+                vector<double> &scalar = values[shortname];
+                scalar.resize(points.size());
+                for (int i = 0; i < points.size(); i++)
+                    scalar[i] = localValues->isFound(i) ? pointValues[i].scalar : nan;
+            }
+            else
+            {
+                vector<double> &magnitude = values[shortname];
+                vector<double> &vectorX = values[shortname + Agros2D::problem()->config()->labelX().toLower().toStdString()];
+                vector<double> &vectorY = values[shortname + Agros2D::problem()->config()->labelY().toLower().toStdString()];
+                magnitude.resize(points.size());
+                vectorX.resize(points.size());
+                vectorY.resize(points.size());
+                for (int i = 0; i < points.size(); i++)
+                {
+                    bool found = localValues->isFound(i);
+                    magnitude[i] = found ? pointValues[i].vector.magnitude() : nan;
+                    vectorX[i] = found ? pointValues[i].vector.x : nan;
+                    vectorY[i] = found ? pointValues[i].vector.y : nan;
+                }
+            }
+        }
+        delete localValues;
+    }
+    else
+    {
+        throw logic_error(QObject::tr("Problem is not solved.").toStdString());
+    }
+
+    results = values;
+}
+
 void PyField::surfaceIntegrals(const vector<int> &edges, int timeStep, int adaptivityStep,
                                const std::string &solutionType, map<std::string, double> &results) const
 {
@@ -759,6 +834,24 @@ void PyField::adaptivityInfo(int timeStep, const std::string &solutionType, vect
     }
 }
 
+void PyField::calculatedTimeSteps(vector<int> &timeSteps) const
+{
+    if (!Agros2D::problem()->isSolved())
+        throw logic_error(QObject::tr("Problem is not solved.").toStdString());
+
+    int numberOfTimeSteps = Agros2D::solutionStore()->timeLevels(m_fieldInfo).count();
+    for (int n = 0; n < numberOfTimeSteps; n++)
+        timeSteps.push_back(Agros2D::solutionStore()->nthCalculatedTimeStep(m_fieldInfo, n));
+}
+
+int PyField::nearestCalculatedTimeStep(int timeStep) const
+{
+    if (!Agros2D::problem()->isSolved())
+        throw logic_error(QObject::tr("Problem is not solved.").toStdString());
+
+    return Agros2D::solutionStore()->nearestTimeStep(m_fieldInfo, getTimeStep(timeStep, SolutionMode_Normal));
+}
+
 SolutionMode PyField::getSolutionMode(const QString &solutionType) const
 {
     if (!solutionTypeStringKeys().contains(solutionType))
@@ -136,6 +136,8 @@ class PyField
         // local values, integrals
         void localValues(double x, double y, int timeStep, int adaptivityStep,
                          const std::string &solutionType, map<std::string, double> &results) const;
+        void localValuesPoints(const vector<double> &x, const vector<double> &y, int timeStep, int adaptivityStep,
+                               const std::string &solutionType, map<std::string, vector<double> > &results) const;
         void surfaceIntegrals(const vector<int> &edges, int timeStep, int adaptivityStep,
                               const std::string &solutionType, map<std::string, double> &results) const;
         void volumeIntegrals(const vector<int> &labels, int timeStep, int adaptivityStep,
@@ -153,6 +155,10 @@ class PyField
         // adaptivity info
         void adaptivityInfo(int timeStep, const std::string &solutionType, vector<double> &error, vector<int> &dofs) const;
 
+        // time steps, in which field was calculated (time steps can be skipped)
+        void calculatedTimeSteps(vector<int> &timeSteps) const;
+        int nearestCalculatedTimeStep(int timeStep) const;
+
         // matrix and RHS
         std::string filenameMatrix(int timeStep, int adaptivityStep) const;
         std::string filenameRHS(int timeStep, int adaptivityStep) const;
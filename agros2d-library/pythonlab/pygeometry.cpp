@@ -585,6 +585,50 @@ void PyGeometry::removeSelection()
         currentPythonEngineAgros()->sceneViewPreprocessor()->refresh();
 }
 
+void PyGeometry::crossings(vector<int> &edges, bool bruteForce) const
+{
+    if (bruteForce)
+    {
+        for (int i = 0; i < Agros2D::scene()->edges->length(); i++)
+            if (Agros2D::scene()->edges->at(i)->isCrossed())
+                edges.push_back(i);
+    }
+    else
+    {
+        Agros2D::scene()->updateGeometryChecks();
+
+        foreach (SceneEdge *edge, Agros2D::scene()->crossings())
+            edges.push_back(Agros2D::scene()->edges->items().indexOf(edge));
+        qSort(edges.begin(), edges.end());
+    }
+}
+
+void PyGeometry::lyingNodes(vector<int> &nodes, bool bruteForce) const
+{
+    if (bruteForce)
+    {
+        for (int i = 0; i < Agros2D::scene()->nodes->length(); i++)
+        {
+            foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
+            {
+                if (edge->isLyingOnNode(Agros2D::scene()->nodes->at(i)))
+                {
+                    nodes.push_back(i);
+                    break;
+                }
+            }
+        }
+    }
+    else
+    {
+        Agros2D::scene()->updateGeometryChecks();
+
+        foreach (SceneNode *node, Agros2D::scene()->lyingEdgeNodes().values().toSet())
+            nodes.push_back(Agros2D::scene()->nodes->items().indexOf(node));
+        qSort(nodes.begin(), nodes.end());
+    }
+}
+
 void PyGeometry::exportVTK(const std::string &fileName) const
 {
     Agros2D::scene()->exportVTKGeometry(QString::fromStdString(fileName));
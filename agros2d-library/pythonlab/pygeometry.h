@@ -75,6 +75,10 @@ class PyGeometry
         void scaleSelection(double x, double y, double scale, bool copy, bool withMarkers);
         void removeSelection();
 
+        // geometry checks (spatial index or very slow brute force), sorted indices
+        void crossings(vector<int> &edges, bool bruteForce) const;
+        void lyingNodes(vector<int> &nodes, bool bruteForce) const;
+
         // vtk
         void exportVTK(const std::string &fileName) const;
 
@@ -241,6 +241,14 @@ void PyParticleTracing::setDragForceCoefficient(double coeff)
     Agros2D::problem()->setting()->setValue(ProblemSetting::View_ParticleDragCoefficient, coeff);
 }
 
+void PyParticleTracing::setInteractionOpeningAngle(double angle)
+{
+    if (angle < 0.0)
+        throw out_of_range(QObject::tr("Opening angle cannot be negative.").toStdString());
+
+    Agros2D::problem()->setting()->setValue(ProblemSetting::View_ParticleP2POpeningAngle, angle);
+}
+
 void PyParticleTracing::setCustomForce(const vector<double> &force)
 {
     if (force.empty())
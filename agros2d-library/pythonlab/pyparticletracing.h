@@ -74,6 +74,8 @@ public:
     void setElectrostaticInteraction(bool interaction) { Agros2D::problem()->setting()->setValue(ProblemSetting::View_ParticleP2PElectricForce, interaction); }
     inline bool getMagneticInteraction() const { return Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleP2PMagneticForce).toBool(); }
     void setMagneticInteraction(bool interaction) { Agros2D::problem()->setting()->setValue(ProblemSetting::View_ParticleP2PMagneticForce, interaction); }
+    inline double getInteractionOpeningAngle() const { return Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleP2POpeningAngle).toDouble(); }
+    void setInteractionOpeningAngle(double angle);
 
     // butcher table
     std::string getButcherTableType() const
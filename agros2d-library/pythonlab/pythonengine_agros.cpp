@@ -541,14 +541,15 @@ QString createPythonFromModel()
                 }
                 else if (value->hasTable() && value->isNumber())
                 {
-                    variables += QString("\"%1\" : { \"value\" : %2, \"x\" : [%3], \"y\" : [%4], \"interpolation\" : \"%5\", \"extrapolation\" : \"%6\", \"derivative_at_endpoints\" : \"%7\" }, ").
+                    variables += QString("\"%1\" : { \"value\" : %2, \"x\" : [%3], \"y\" : [%4], \"interpolation\" : \"%5\", \"extrapolation\" : \"%6\", \"derivative_at_endpoints\" : \"%7\", \"uniform_resampling\" : %8 }, ").
                             arg(variable.id()).
                             arg(value->number()).
                             arg(value->table().toStringX()).
                             arg(value->table().toStringY()).
                             arg(dataTableTypeToStringKey(value->table().type())).
                             arg(value->table().extrapolateConstant() == true ? "constant" : "linear").
-                            arg(value->table().splineFirstDerivatives() == true ? "first" : "second");
+                            arg(value->table().splineFirstDerivatives() == true ? "first" : "second").
+                            arg(value->table().uniformResampling() == true ? "True" : "False");
                 }
                 else if (value->isTimeDependent() || value->isCoordinateDependent())
                 {
@@ -784,10 +785,10 @@ void PyOptions::setNumberOfThreads(int threads)
 
 void PyOptions::setCacheSize(int size)
 {
-    if (size < 2 || size > 50)
-        throw out_of_range(QObject::tr("Cache size is out of range (2 - 50).").toStdString());
+    if (size < 0 || size > 65536)
+        throw out_of_range(QObject::tr("Cache size is out of range (0 - 65536 MB).").toStdString());
 
-    Agros2D::configComputer()->setValue(Config::Config_CacheSize, size);
+    Agros2D::configComputer()->setValue(Config::Config_CacheMemorySize, size);
 }
 
 void PyOptions::setDumpFormat(std::string format)
@@ -134,7 +134,7 @@ struct PyOptions
     void setNumberOfThreads(int threads);
 
     // cache size
-    inline int getCacheSize() const { return Agros2D::configComputer()->value(Config::Config_CacheSize).toInt(); }
+    inline int getCacheSize() const { return Agros2D::configComputer()->value(Config::Config_CacheMemorySize).toInt(); }
     void setCacheSize(int size);
 
     // save matrix and rhs
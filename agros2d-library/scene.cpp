@@ -33,6 +33,7 @@
 #include "sceneedge.h"
 #include "scenelabel.h"
 #include "scenemarkerdialog.h"
+#include "scenegeometryindex.h"
 #include "hermes2d/problem.h"
 #include "hermes2d/plugin_interface.h"
 
@@ -856,11 +857,16 @@ void Scene::doInvalidated()
         label->setPointValue(label->pointValue());
 
     if (currentPythonEngineAgros() && !currentPythonEngineAgros()->isScriptRunning())
-    {
-        findLyingEdgeNodes();
-        findNumberOfConnectedNodeEdges();
-        findCrossings();
-    }
+        updateGeometryChecks();
+}
+
+void Scene::updateGeometryChecks()
+{
+    m_geometryIndex.build(nodes->items(), edges->items());
+
+    findLyingEdgeNodes();
+    findNumberOfConnectedNodeEdges();
+    findCrossings();
 }
 
 void Scene::doNewNode(const Point &point)
@@ -2396,7 +2402,16 @@ void Scene::writeSolutionToFile(const QString &fileName)
     QFileInfo fileInfo(fileName);
     QString solutionFN = QString("%1/%2.sol").arg(fileInfo.absolutePath()).arg(fileInfo.baseName());
     if (QFile(solutionFN).open(QIODevice::WriteOnly))
+    {
+        // wait for solution files written in background
+        Agros2D::solutionStore()->flush();
+
+        // compact run time journal and export runtime.xml
+        if (!Agros2D::solutionStore()->isEmpty())
+            Agros2D::solutionStore()->saveRunTimeDetails();
+
         JlCompress::compressDir(solutionFN, cacheProblemDir());
+    }
     else
         Agros2D::log()->printError(tr("Solver"), tr("Access denied '%1'").arg(solutionFN));
 }
@@ -2442,13 +2457,30 @@ void Scene::checkNodeConnect(SceneNode *node)
     }
 }
 
+// tolerance of geometry checks (relative tolerance of Point::operator==)
+static double geometryTolerance(const Point &point)
+{
+    return qMax(sqrt(EPS_ZERO), 2.0 * POINT_REL_ZERO * qMax(fabs(point.x), fabs(point.y)));
+}
+
 void Scene::checkTwoNodesSameCoordinates()
 {
+    // can be called during script run (index is not updated)
+    m_geometryIndex.build(nodes->items(), edges->items());
+
     for(int nodeIdx1 = 0; nodeIdx1 < nodes->length(); nodeIdx1++)
     {
         SceneNode* node1 = nodes->at(nodeIdx1);
-        for(int nodeIdx2 = 0; nodeIdx2 < nodeIdx1; nodeIdx2++)
+
+        double tolerance = geometryTolerance(node1->point());
+        RectPoint box(Point(node1->point().x - tolerance, node1->point().y - tolerance),
+                      Point(node1->point().x + tolerance, node1->point().y + tolerance));
+
+        foreach (int nodeIdx2, m_geometryIndex.nodes(box))
         {
+            if (nodeIdx2 >= nodeIdx1)
+                break;
+
             SceneNode* node2 = nodes->at(nodeIdx2);
             if(node1->point() == node2->point())
                 throw AgrosGeometryException(QObject::tr("Point %1 and %2 has the same coordinates.").arg(nodeIdx1).arg(nodeIdx2));
@@ -2513,8 +2545,13 @@ void Scene::findLyingEdgeNodes()
 
     foreach (SceneEdge *edge, edges->items())
     {
-        foreach (SceneNode *node, nodes->items())
+        // only nodes close to the edge
+        RectPoint box = SceneGeometryIndex::edgeBoundingBox(edge);
+        box = SceneGeometryIndex::edgeBoundingBox(edge, qMax(geometryTolerance(box.start), geometryTolerance(box.end)));
+
+        foreach (int nodeIdx, m_geometryIndex.nodes(box))
         {
+            SceneNode *node = nodes->at(nodeIdx);
             if (edge->isLyingOnNode(node))
             {
                 m_lyingEdgeNodes.insert(edge, node);
@@ -2528,14 +2565,13 @@ void Scene::findNumberOfConnectedNodeEdges()
     m_numberOfConnectedNodeEdges.clear();
 
     foreach (SceneNode *node, nodes->items())
+        m_numberOfConnectedNodeEdges.insert(node, 0);
+
+    foreach (SceneEdge *edge, edges->items())
     {
-        int connections = 0;
-        foreach (SceneEdge *edge, edges->items())
-        {
-            if (edge->nodeStart() == node || edge->nodeEnd() == node)
-                connections++;
-        }
-        m_numberOfConnectedNodeEdges.insert(node, connections);
+        m_numberOfConnectedNodeEdges[edge->nodeStart()]++;
+        if (edge->nodeEnd() != edge->nodeStart())
+            m_numberOfConnectedNodeEdges[edge->nodeEnd()]++;
     }
 }
 
@@ -2547,8 +2583,15 @@ void Scene::findCrossings()
     {
         SceneEdge *edge = edges->at(i);
 
-        for (int j = i + 1; j < edges->count(); j++)
+        // only edges with overlapping bounding boxes
+        RectPoint box = SceneGeometryIndex::edgeBoundingBox(edge);
+        box = SceneGeometryIndex::edgeBoundingBox(edge, qMax(geometryTolerance(box.start), geometryTolerance(box.end)));
+
+        foreach (int j, m_geometryIndex.edges(box))
         {
+            if (j <= i)
+                continue;
+
             SceneEdge *edgeCheck = edges->at(j);
 
             QList<Point> intersects;
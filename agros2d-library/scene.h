@@ -26,6 +26,8 @@
 
 #include "hermes2d/solutiontypes.h"
 
+#include "scenegeometryindex.h"
+
 struct HermesElectrostatic;
 struct HermesField;
 
@@ -168,6 +170,8 @@ public:
     QMultiMap<SceneEdge *, SceneNode *> lyingEdgeNodes() const { return m_lyingEdgeNodes; }
     QMap<SceneNode *, int> numberOfConnectedNodeEdges() const { return m_numberOfConnectedNodeEdges; }
     QList<SceneEdge *> crossings() const { return m_crossings; }
+    // find lying nodes, number of connected edges and crossings (not updated during script run)
+    void updateGeometryChecks();
 
     inline void invalidate() { emit invalidated(); }
 
@@ -205,6 +209,9 @@ private:
     QMap<SceneNode *, int> m_numberOfConnectedNodeEdges;
     QList<SceneEdge *> m_crossings;
 
+    // spatial index of nodes and edges (geometry checks)
+    SceneGeometryIndex m_geometryIndex;
+
     void createActions();
 
     Point calculateNewPoint(SceneTransformMode mode, Point originalPoint, Point transformationPoint, double angle, double scaleFactor);
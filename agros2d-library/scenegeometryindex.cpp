@@ -0,0 +1,221 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "scenegeometryindex.h"
+
+#include "scenenode.h"
+#include "sceneedge.h"
+
+// maximal number of cells in one direction
+const int GEOMETRY_INDEX_MAX_CELLS = 1024;
+
+SceneGeometryIndex::SceneGeometryIndex() : m_cellSize(1.0), m_nx(0), m_ny(0)
+{
+}
+
+void SceneGeometryIndex::clear()
+{
+    m_nodeCells.clear();
+    m_edgeCells.clear();
+    m_nodePoints.clear();
+    m_edgeBoxes.clear();
+    m_nx = 0;
+    m_ny = 0;
+}
+
+RectPoint SceneGeometryIndex::edgeBoundingBox(const SceneEdge *edge, double tolerance)
+{
+    Point min, max;
+    if (edge->isStraight())
+    {
+        min = Point(qMin(edge->nodeStart()->point().x, edge->nodeEnd()->point().x),
+                    qMin(edge->nodeStart()->point().y, edge->nodeEnd()->point().y));
+        max = Point(qMax(edge->nodeStart()->point().x, edge->nodeEnd()->point().x),
+                    qMax(edge->nodeStart()->point().y, edge->nodeEnd()->point().y));
+    }
+    else
+    {
+        min = Point(edge->center().x - edge->radius(), edge->center().y - edge->radius());
+        max = Point(edge->center().x + edge->radius(), edge->center().y + edge->radius());
+    }
+
+    return RectPoint(Point(min.x - tolerance, min.y - tolerance),
+                     Point(max.x + tolerance, max.y + tolerance));
+}
+
+void SceneGeometryIndex::build(const QList<SceneNode *> &nodes, const QList<SceneEdge *> &edges)
+{
+    clear();
+
+    int count = nodes.count() + edges.count();
+    if (count == 0)
+        return;
+
+    // extent
+    Point min( numeric_limits<double>::max(),  numeric_limits<double>::max());
+    Point max(-numeric_limits<double>::max(), -numeric_limits<double>::max());
+
+    foreach (SceneNode *node, nodes)
+    {
+        min.x = qMin(min.x, node->point().x);
+        min.y = qMin(min.y, node->point().y);
+        max.x = qMax(max.x, node->point().x);
+        max.y = qMax(max.y, node->point().y);
+    }
+
+    QVector<RectPoint> edgeBoxes(edges.count());
+    for (int i = 0; i < edges.count(); i++)
+    {
+        edgeBoxes[i] = edgeBoundingBox(edges.at(i));
+
+        min.x = qMin(min.x, edgeBoxes[i].start.x);
+        min.y = qMin(min.y, edgeBoxes[i].start.y);
+        max.x = qMax(max.x, edgeBoxes[i].end.x);
+        max.y = qMax(max.y, edgeBoxes[i].end.y);
+    }
+
+    // about one entity per cell
+    double width = max.x - min.x;
+    double height = max.y - min.y;
+    double size = qMax(width, height);
+    if (size < EPS_ZERO)
+        size = 1.0;
+
+    double minimalCellSize = size / GEOMETRY_INDEX_MAX_CELLS;
+    double area = qMax(width, minimalCellSize) * qMax(height, minimalCellSize);
+
+    m_min = min;
+    m_cellSize = qMax(sqrt(area / count), minimalCellSize);
+    m_nx = qMin(GEOMETRY_INDEX_MAX_CELLS, (int) (width / m_cellSize) + 1);
+    m_ny = qMin(GEOMETRY_INDEX_MAX_CELLS, (int) (height / m_cellSize) + 1);
+
+    m_nodeCells.resize(m_nx * m_ny);
+    m_edgeCells.resize(m_nx * m_ny);
+
+    m_nodePoints.resize(nodes.count());
+    m_edgeBoxes = edgeBoxes;
+
+    int i0, i1, j0, j1;
+    for (int n = 0; n < nodes.count(); n++)
+    {
+        m_nodePoints[n] = nodes.at(n)->point();
+
+        cellRange(RectPoint(nodes.at(n)->point(), nodes.at(n)->point()), i0, i1, j0, j1);
+        m_nodeCells[j0 * m_nx + i0].append(n);
+    }
+
+    for (int e = 0; e < edges.count(); e++)
+    {
+        cellRange(edgeBoxes.at(e), i0, i1, j0, j1);
+        for (int j = j0; j <= j1; j++)
+            for (int i = i0; i <= i1; i++)
+                m_edgeCells[j * m_nx + i].append(e);
+    }
+}
+
+void SceneGeometryIndex::cellRange(const RectPoint &box, int &i0, int &i1, int &j0, int &j1) const
+{
+    i0 = qBound(0, (int) floor((box.start.x - m_min.x) / m_cellSize), m_nx - 1);
+    i1 = qBound(0, (int) floor((box.end.x - m_min.x) / m_cellSize), m_nx - 1);
+    j0 = qBound(0, (int) floor((box.start.y - m_min.y) / m_cellSize), m_ny - 1);
+    j1 = qBound(0, (int) floor((box.end.y - m_min.y) / m_cellSize), m_ny - 1);
+}
+
+QList<int> SceneGeometryIndex::query(const QVector<QVector<int> > &cells, const RectPoint &box) const
+{
+    QList<int> result;
+    if (m_nx == 0)
+        return result;
+
+    int i0, i1, j0, j1;
+    cellRange(box, i0, i1, j0, j1);
+
+    // edges can be stored in more cells
+    QSet<int> found;
+    for (int j = j0; j <= j1; j++)
+        for (int i = i0; i <= i1; i++)
+            foreach (int index, cells.at(j * m_nx + i))
+                found.insert(index);
+
+    result = found.toList();
+    qSort(result);
+
+    return result;
+}
+
+QList<int> SceneGeometryIndex::nodes(const RectPoint &box) const
+{
+    QList<int> result;
+    foreach (int index, query(m_nodeCells, box))
+    {
+        const Point &point = m_nodePoints.at(index);
+        if ((point.x >= box.start.x) && (point.x <= box.end.x) && (point.y >= box.start.y) && (point.y <= box.end.y))
+            result.append(index);
+    }
+
+    return result;
+}
+
+void SceneGeometryIndex::edges(const RectPoint &box, QVector<int> &result) const
+{
+    // keeps capacity
+    result.resize(0);
+    if (m_nx == 0)
+        return;
+
+    int i0, i1, j0, j1;
+    cellRange(box, i0, i1, j0, j1);
+
+    for (int j = j0; j <= j1; j++)
+    {
+        for (int i = i0; i <= i1; i++)
+        {
+            const QVector<int> &cell = m_edgeCells.at(j * m_nx + i);
+            for (int k = 0; k < cell.size(); k++)
+            {
+                int index = cell.at(k);
+
+                const RectPoint &edgeBox = m_edgeBoxes.at(index);
+                if ((edgeBox.start.x > box.end.x) || (edgeBox.end.x < box.start.x) || (edgeBox.start.y > box.end.y) || (edgeBox.end.y < box.start.y))
+                    continue;
+
+                // edge is stored in more cells, report it from the first common cell only
+                int ei0, ei1, ej0, ej1;
+                cellRange(edgeBox, ei0, ei1, ej0, ej1);
+                if ((i == qMax(i0, ei0)) && (j == qMax(j0, ej0)))
+                    result.append(index);
+            }
+        }
+    }
+
+    qSort(result);
+}
+
+QList<int> SceneGeometryIndex::edges(const RectPoint &box) const
+{
+    QList<int> result;
+    foreach (int index, query(m_edgeCells, box))
+    {
+        const RectPoint &edgeBox = m_edgeBoxes.at(index);
+        if ((edgeBox.start.x <= box.end.x) && (edgeBox.end.x >= box.start.x) && (edgeBox.start.y <= box.end.y) && (edgeBox.end.y >= box.start.y))
+            result.append(index);
+    }
+
+    return result;
+}
@@ -0,0 +1,66 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef SCENEGEOMETRYINDEX_H
+#define SCENEGEOMETRYINDEX_H
+
+#include "util.h"
+
+class SceneNode;
+class SceneEdge;
+
+// uniform grid over nodes and bounding boxes of edges, used by geometry checks
+// (lying nodes, crossings, duplicate nodes) to test only entities close to each other
+class SceneGeometryIndex
+{
+public:
+    SceneGeometryIndex();
+
+    // nodes and edges are moved without notification of containers, index is rebuilt before checks (linear)
+    void build(const QList<SceneNode *> &nodes, const QList<SceneEdge *> &edges);
+    void clear();
+
+    // indices of nodes inside the box (edges with bounding box intersecting the box), sorted
+    QList<int> nodes(const RectPoint &box) const;
+    QList<int> edges(const RectPoint &box) const;
+    // the same, result is filled in place (no allocation when the capacity is sufficient)
+    void edges(const RectPoint &box, QVector<int> &result) const;
+
+    // conservative bounding box (arcs are bounded by the circle)
+    static RectPoint edgeBoundingBox(const SceneEdge *edge, double tolerance = 0.0);
+
+private:
+    Point m_min;
+    double m_cellSize;
+    int m_nx;
+    int m_ny;
+
+    QVector<QVector<int> > m_nodeCells;
+    QVector<QVector<int> > m_edgeCells;
+
+    // exact test of candidates from the cells
+    QVector<Point> m_nodePoints;
+    QVector<RectPoint> m_edgeBoxes;
+
+    void cellRange(const RectPoint &box, int &i0, int &i1, int &j0, int &j1) const;
+    // all items in the cells overlapping the box (superset of the result)
+    QList<int> query(const QVector<QVector<int> > &cells, const RectPoint &box) const;
+};
+
+#endif // SCENEGEOMETRYINDEX_H
@@ -75,7 +75,6 @@ void SceneViewMesh::refresh()
     m_arrayInitialMesh.clear();
     m_arraySolutionMesh.clear();
     m_arrayOrderMesh.clear();
-    m_arrayOrderMeshColor.clear();
 
     setControls();
 
@@ -238,7 +237,7 @@ void SceneViewMesh::paintInitialMesh()
 {
     if (!Agros2D::problem()->isMeshed()) return;
 
-    if (m_arrayInitialMesh.isEmpty())
+    if (!m_arrayInitialMesh.isValid())
     {
         if (!m_postHermes->linInitialMeshView()) return;
 
@@ -250,25 +249,22 @@ void SceneViewMesh::paintInitialMesh()
         {
             Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::edge_t& edge = it.get();
 
-            m_arrayInitialMesh.append(QVector2D(edge[0][0], edge[0][1]));
-            m_arrayInitialMesh.append(QVector2D(edge[1][0], edge[1][1]));
+            m_arrayInitialMesh.append(edge[0][0], edge[0][1]);
+            m_arrayInitialMesh.append(edge[1][0], edge[1][1]);
         }
+
+        m_arrayInitialMesh.upload();
     }
-    else
-    {
-        loadProjection2d(true);
 
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        glColor3d(COLORINITIALMESH[0], COLORINITIALMESH[1], COLORINITIALMESH[2]);
-        glLineWidth(1.3);
+    loadProjection2d(true);
 
-        glEnableClientState(GL_VERTEX_ARRAY);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+    glColor3d(COLORINITIALMESH[0], COLORINITIALMESH[1], COLORINITIALMESH[2]);
+    glLineWidth(1.3);
 
-        glVertexPointer(2, GL_FLOAT, 0, m_arrayInitialMesh.constData());
-        glDrawArrays(GL_LINES, 0, m_arrayInitialMesh.size());
+    m_arrayInitialMesh.draw(GL_LINES);
 
-        glDisableClientState(GL_VERTEX_ARRAY);
-    }
+    glLineWidth(1.0);
 }
 
 
@@ -276,7 +272,7 @@ void SceneViewMesh::paintSolutionMesh()
 {
     if (!Agros2D::problem()->isSolved()) return;
 
-    if (m_arraySolutionMesh.isEmpty())
+    if (!m_arraySolutionMesh.isValid())
     {
         if (!m_postHermes->linSolutionMeshView()) return;
 
@@ -288,32 +284,29 @@ void SceneViewMesh::paintSolutionMesh()
         {
             Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::edge_t& edge = it.get();
 
-            m_arraySolutionMesh.append(QVector2D(edge[0][0], edge[0][1]));
-            m_arraySolutionMesh.append(QVector2D(edge[1][0], edge[1][1]));
+            m_arraySolutionMesh.append(edge[0][0], edge[0][1]);
+            m_arraySolutionMesh.append(edge[1][0], edge[1][1]);
         }
+
+        m_arraySolutionMesh.upload();
     }
-    else
-    {
-        loadProjection2d(true);
 
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        glColor3d(COLORSOLUTIONMESH[0], COLORSOLUTIONMESH[1], COLORSOLUTIONMESH[2]);
-        glLineWidth(1.3);
+    loadProjection2d(true);
 
-        glEnableClientState(GL_VERTEX_ARRAY);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+    glColor3d(COLORSOLUTIONMESH[0], COLORSOLUTIONMESH[1], COLORSOLUTIONMESH[2]);
+    glLineWidth(1.3);
 
-        glVertexPointer(2, GL_FLOAT, 0, m_arraySolutionMesh.constData());
-        glDrawArrays(GL_LINES, 0, m_arraySolutionMesh.size());
+    m_arraySolutionMesh.draw(GL_LINES);
 
-        glDisableClientState(GL_VERTEX_ARRAY);
-    }
+    glLineWidth(1.0);
 }
 
 void SceneViewMesh::paintOrder()
 {
     if (!Agros2D::problem()->isSolved()) return;
 
-    if (m_arrayOrderMesh.isEmpty())
+    if (!m_arrayOrderMesh.isValid())
     {
         if (!m_postHermes->ordView()) return;
 
@@ -332,7 +325,6 @@ void SceneViewMesh::paintOrder()
 
         // triangles
         m_arrayOrderMesh.reserve(3 * m_postHermes->ordView()->get_num_triangles());
-        m_arrayOrderMeshColor.reserve(3 * m_postHermes->ordView()->get_num_triangles());
         for (int i = 0; i < m_postHermes->ordView()->get_num_triangles(); i++)
         {
             int color = vert[tris[i][0]][2];
@@ -340,35 +332,22 @@ void SceneViewMesh::paintOrder()
                     paletteColorOrder(color)[1],
                     paletteColorOrder(color)[2]);
 
-            m_arrayOrderMesh.append(QVector2D(vert[tris[i][0]][0], vert[tris[i][0]][1]));
-            m_arrayOrderMeshColor.append(colorVector);
-
-            m_arrayOrderMesh.append(QVector2D(vert[tris[i][1]][0], vert[tris[i][1]][1]));
-            m_arrayOrderMeshColor.append(colorVector);
-
-            m_arrayOrderMesh.append(QVector2D(vert[tris[i][2]][0], vert[tris[i][2]][1]));
-            m_arrayOrderMeshColor.append(colorVector);
+            m_arrayOrderMesh.append(vert[tris[i][0]][0], vert[tris[i][0]][1], colorVector);
+            m_arrayOrderMesh.append(vert[tris[i][1]][0], vert[tris[i][1]][1], colorVector);
+            m_arrayOrderMesh.append(vert[tris[i][2]][0], vert[tris[i][2]][1], colorVector);
         }
-    }
-    else
-    {
-        loadProjection2d(true);
 
-        glEnable(GL_POLYGON_OFFSET_FILL);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        m_arrayOrderMesh.upload();
+    }
 
-        glEnableClientState(GL_COLOR_ARRAY);
-        glEnableClientState(GL_VERTEX_ARRAY);
+    loadProjection2d(true);
 
-        glVertexPointer(2, GL_FLOAT, 0, m_arrayOrderMesh.constData());
-        glColorPointer(3, GL_FLOAT, 0, m_arrayOrderMeshColor.constData());
-        glDrawArrays(GL_TRIANGLES, 0, m_arrayOrderMesh.size());
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
-        glDisableClientState(GL_VERTEX_ARRAY);
-        glDisableClientState(GL_COLOR_ARRAY);
+    m_arrayOrderMesh.draw(GL_TRIANGLES);
 
-        glDisable(GL_POLYGON_OFFSET_FILL);
-    }
+    glDisable(GL_POLYGON_OFFSET_FILL);
 
     // paint labels
     if (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowOrderLabel).toBool())
@@ -56,10 +56,10 @@ protected:
     void paintOrderColorBar();
 
 private:
-    QVector<QVector2D> m_arrayInitialMesh;
-    QVector<QVector2D> m_arraySolutionMesh;
-    QVector<QVector2D> m_arrayOrderMesh;
-    QVector<QVector3D> m_arrayOrderMeshColor;
+    // vertex arrays (built once per linearization)
+    PostVertexArray m_arrayInitialMesh;
+    PostVertexArray m_arraySolutionMesh;
+    PostVertexArray m_arrayOrderMesh;
 
     void createActionsMesh();
 
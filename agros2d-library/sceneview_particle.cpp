@@ -124,6 +124,9 @@ void ParticleTracingWidget::createControls()
     lblParticleMotionEquations = new QLabel();
     chkParticleP2PElectricForce = new QCheckBox(tr("Electrostatic interaction"));
     chkParticleP2PMagneticForce = new QCheckBox(tr("Magnetic interaction"));
+    txtParticleP2POpeningAngle = new LineEditDouble(Agros2D::problem()->setting()->defaultValue(ProblemSetting::View_ParticleP2POpeningAngle).toDouble());
+    txtParticleP2POpeningAngle->setBottom(0.0);
+    txtParticleP2POpeningAngle->setToolTip(tr("Opening angle of tree code approximation (0 - exact computation)"));
 
     // initial particle position
     QGridLayout *gridLayoutGeneral = new QGridLayout();
@@ -219,6 +222,8 @@ void ParticleTracingWidget::createControls()
     QGridLayout *gridP2PForce = new QGridLayout();
     gridP2PForce->addWidget(chkParticleP2PElectricForce, 0, 0);
     gridP2PForce->addWidget(chkParticleP2PMagneticForce, 1, 0);
+    gridP2PForce->addWidget(new QLabel(tr("Opening angle (-):")), 2, 0);
+    gridP2PForce->addWidget(txtParticleP2POpeningAngle, 2, 1);
 
     QGroupBox *grpP2PForce = new QGroupBox(tr("Particle to particle"));
     grpP2PForce->setLayout(gridP2PForce);
@@ -335,6 +340,7 @@ void ParticleTracingWidget::updateControls()
     txtParticleDragCoefficient->setValue(Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleDragCoefficient).toDouble());
     chkParticleP2PElectricForce->setChecked(Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleP2PElectricForce).toBool());
     chkParticleP2PMagneticForce->setChecked(Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleP2PMagneticForce).toBool());
+    txtParticleP2POpeningAngle->setValue(Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleP2POpeningAngle).toDouble());
 
     lblParticlePointX->setText(QString("%1 (m):").arg(Agros2D::problem()->config()->labelX()));
     lblParticlePointY->setText(QString("%1 (m):").arg(Agros2D::problem()->config()->labelY()));
@@ -380,6 +386,7 @@ void ParticleTracingWidget::doParticleDefault()
     txtParticleDragCoefficient->setValue(Agros2D::problem()->setting()->defaultValue(ProblemSetting::View_ParticleDragCoefficient).toDouble());
     chkParticleP2PElectricForce->setChecked(Agros2D::problem()->setting()->defaultValue(ProblemSetting::View_ParticleP2PElectricForce).toBool());
     chkParticleP2PMagneticForce->setChecked(Agros2D::problem()->setting()->defaultValue(ProblemSetting::View_ParticleP2PMagneticForce).toBool());
+    txtParticleP2POpeningAngle->setValue(Agros2D::problem()->setting()->defaultValue(ProblemSetting::View_ParticleP2POpeningAngle).toDouble());
 }
 
 void ParticleTracingWidget::refresh()
@@ -418,6 +425,7 @@ void ParticleTracingWidget::doApply()
     Agros2D::problem()->setting()->setValue(ProblemSetting::View_ParticleDragReferenceArea, txtParticleDragReferenceArea->value());
     Agros2D::problem()->setting()->setValue(ProblemSetting::View_ParticleP2PElectricForce, chkParticleP2PElectricForce->isChecked());
     Agros2D::problem()->setting()->setValue(ProblemSetting::View_ParticleP2PMagneticForce, chkParticleP2PMagneticForce->isChecked());
+    Agros2D::problem()->setting()->setValue(ProblemSetting::View_ParticleP2POpeningAngle, txtParticleP2POpeningAngle->value());
 
     m_sceneViewParticleTracing->processParticleTracing();
 }
@@ -58,15 +58,11 @@ PostHermes::PostHermes() :
     m_activeAdaptivityStep(NOT_FOUND_SO_FAR),
     m_activeSolutionMode(SolutionMode_Undefined),
     m_isProcessed(false),
-    m_linInitialMeshView(NULL),
-    m_linSolutionMeshView(NULL),
-    m_orderView(NULL),
-    m_linContourView(NULL),
-    m_linScalarView(NULL),
-    m_vecVectorView(NULL)
+    m_cacheTotalMemory(0)
 {
     connect(Agros2D::scene(), SIGNAL(cleared()), this, SLOT(clear()));
     connect(Agros2D::problem(), SIGNAL(clearedSolution()), this, SLOT(clearView()));
+    connect(Agros2D::problem(), SIGNAL(clearedSolution()), this, SLOT(clearCache()));
     connect(Agros2D::problem(), SIGNAL(fieldsChanged()), this, SLOT(clear()));
 
     connect(Agros2D::problem(), SIGNAL(meshed()), this, SLOT(problemMeshed()));
@@ -78,29 +74,275 @@ PostHermes::~PostHermes()
     clear();
 }
 
+static qint64 linearizerMemory(Hermes::Hermes2D::Views::Linearizer *linearizer)
+{
+    return (qint64) linearizer->get_triangle_count() * sizeof(Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t)
+            + (qint64) linearizer->get_edge_count() * sizeof(Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::edge_t);
+}
+
+static qint64 vectorizerMemory(Hermes::Hermes2D::Views::Vectorizer *vectorizer)
+{
+    return (qint64) vectorizer->get_triangle_count() * sizeof(Hermes::Hermes2D::Views::VectorLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t)
+            + (qint64) vectorizer->get_edge_count() * sizeof(Hermes::Hermes2D::Views::VectorLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::edge_t);
+}
+
+static qint64 orderizerMemory(Hermes::Hermes2D::Views::Orderizer *orderizer)
+{
+    // triangles and their vertices
+    return (qint64) orderizer->get_num_triangles() * (sizeof(int3) + 3 * sizeof(double3));
+}
+
+QString PostHermes::cacheKey(const QString &view, const QString &variable, int component, int criterion, bool deform)
+{
+    FieldSolutionID fsid(activeViewField(), activeTimeStep(), activeAdaptivityStep(), activeAdaptivitySolutionType());
+
+    return QString("%1_%2_%3_%4_%5_%6").
+            arg(fsid.toString()).
+            arg(view).
+            arg(variable).
+            arg(component).
+            arg(criterion).
+            arg(deform ? 1 : 0);
+}
+
+bool PostHermes::cacheLookup(const QString &key, CacheItem &item)
+{
+    if (!m_cache.contains(key))
+        return false;
+
+    item = m_cache[key];
+
+    // most recently used
+    m_cacheKeyOrder.removeOne(key);
+    m_cacheKeyOrder.append(key);
+
+    return true;
+}
+
+void PostHermes::cacheInsert(const QString &key, const CacheItem &item)
+{
+    if (m_cache.contains(key))
+        return;
+
+    m_cache.insert(key, item);
+    m_cacheKeyOrder.append(key);
+    m_cacheTotalMemory += item.memory;
+
+    // flush cache (least recently used first), views in use stay alive until replaced
+    qint64 cacheSize = qint64(Agros2D::configComputer()->value(Config::Config_PostCacheMemorySize).toInt()) * 1024 * 1024;
+
+    while ((m_cacheTotalMemory > cacheSize) && !m_cacheKeyOrder.isEmpty())
+    {
+        QString keyRemove = m_cacheKeyOrder.takeFirst();
+
+        m_cacheTotalMemory -= m_cache[keyRemove].memory;
+        m_cache.remove(keyRemove);
+    }
+}
+
+void PostHermes::clearCache()
+{
+    m_cache.clear();
+    m_cacheKeyOrder.clear();
+    m_cacheTotalMemory = 0;
+}
+
+void PostHermes::setDisplacement(ProcessJob &job)
+{
+    MultiArray<double> ma = activeMultiSolutionArray();
+
+    Hermes::Hermes2D::MagFilter<double> *filter = new Hermes::Hermes2D::MagFilter<double>(Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> >(ma.solutions().at(0),
+                                                                                                                                                           ma.solutions().at(1)));
+
+    if (fabs(filter->get_approx_max_value() - filter->get_approx_min_value()) > EPS_ZERO)
+    {
+        RectPoint rect = Agros2D::scene()->boundingBox();
+
+        job.displacementX = ma.solutions().at(0);
+        job.displacementY = ma.solutions().at(1);
+        job.displacementMultiplier = qMax(rect.width(), rect.height()) / filter->get_approx_max_value() / 15.0;
+    }
+    delete filter;
+}
+
+void PostHermes::processJob(ProcessJob &job)
+{
+    try
+    {
+        if (job.type == ProcessType_Linearizer)
+        {
+            QSharedPointer<Hermes::Hermes2D::Views::Linearizer> linearizer(new Hermes::Hermes2D::Views::Linearizer(Hermes::Hermes2D::OpenGL));
+
+            if (job.displacementMultiplier > 0.0)
+                linearizer->set_displacement(job.displacementX, job.displacementY, job.displacementMultiplier);
+            else
+                linearizer->set_displacement(NULL, NULL);
+
+            // linearizer->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionAdaptive(Hermes::Hermes2D::Views::HERMES_EPS_VERYHIGH));
+            linearizer->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionFixed(job.criterion));
+            linearizer->process_solution(job.solutions.at(0), Hermes::Hermes2D::H2D_FN_VAL_0);
+
+            job.result.linearizer = linearizer;
+            job.result.memory = linearizerMemory(linearizer.data());
+        }
+        else if (job.type == ProcessType_Vectorizer)
+        {
+            QSharedPointer<Hermes::Hermes2D::Views::Vectorizer> vectorizer(new Hermes::Hermes2D::Views::Vectorizer(Hermes::Hermes2D::OpenGL));
+
+            if (job.displacementMultiplier > 0.0)
+                vectorizer->set_displacement(job.displacementX, job.displacementY, job.displacementMultiplier);
+            else
+                vectorizer->set_displacement(NULL, NULL);
+
+            Hermes::Hermes2D::MeshFunctionSharedPtr<double> slns[2] = { job.solutions.at(0), job.solutions.at(1) };
+            int items[2] = { Hermes::Hermes2D::H2D_FN_VAL_0, Hermes::Hermes2D::H2D_FN_VAL_0 };
+
+            vectorizer->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionFixed(job.criterion));
+            vectorizer->process_solution(slns, items);
+
+            job.result.vectorizer = vectorizer;
+            job.result.memory = vectorizerMemory(vectorizer.data());
+        }
+        else if (job.type == ProcessType_Orderizer)
+        {
+            QSharedPointer<Hermes::Hermes2D::Views::Orderizer> orderizer(new Hermes::Hermes2D::Views::Orderizer());
+            orderizer->process_space(job.space);
+
+            job.result.orderizer = orderizer;
+            job.result.memory = orderizerMemory(orderizer.data());
+        }
+    }
+    catch (Hermes::Exceptions::Exception &e)
+    {
+        job.error = QString::fromStdString(e.info());
+    }
+    catch (...)
+    {
+        job.error = QObject::tr("An unknown exception occurred");
+    }
+}
+
+void PostHermes::cloneSolutions(ProcessJob &job)
+{
+    for (int i = 0; i < job.solutions.size(); i++)
+        job.solutions[i] = job.solutions.at(i)->clone();
+
+    if (job.displacementMultiplier > 0.0)
+    {
+        job.displacementX = job.displacementX->clone();
+        job.displacementY = job.displacementY->clone();
+    }
+}
+
+class PostHermesRunnable : public QRunnable
+{
+public:
+    PostHermesRunnable(QList<PostHermes::ProcessJob> *jobs, QAtomicInt *next) : m_jobs(jobs), m_next(next) {}
+
+    void run()
+    {
+        int index;
+        while ((index = m_next->fetchAndAddOrdered(1)) < m_jobs->count())
+            PostHermes::processJob((*m_jobs)[index]);
+    }
+
+private:
+    QList<PostHermes::ProcessJob> *m_jobs;
+    QAtomicInt *m_next;
+};
+
+void PostHermes::processJobs()
+{
+    if (m_jobs.isEmpty())
+        return;
+
+    // views are independent (own filters and linearizers), the most expensive are queued first
+    int numberOfThreads = qMin(m_jobs.count(), Agros2D::configComputer()->value(Config::Config_NumberOfThreads).toInt());
+    if (numberOfThreads <= 1)
+    {
+        for (int i = 0; i < m_jobs.count(); i++)
+            processJob(m_jobs[i]);
+    }
+    else
+    {
+        // items of m_jobs are not reallocated during processing
+        m_jobs.detach();
+
+        // Hermes solutions (filters) are not reentrant, jobs except the first one process own copies
+        for (int i = 1; i < m_jobs.count(); i++)
+            cloneSolutions(m_jobs[i]);
+
+        // Hermes threads are divided between jobs
+        int numThreads = Agros2D::configComputer()->value(Config::Config_NumberOfThreads).toInt();
+        Hermes::HermesCommonApi.set_integral_param_value(Hermes::numThreads, qMax(1, numThreads / numberOfThreads));
+
+        QThreadPool pool;
+        pool.setMaxThreadCount(numberOfThreads);
+
+        QAtomicInt next(0);
+        QList<PostHermesRunnable *> runnables;
+        for (int i = 0; i < numberOfThreads; i++)
+        {
+            PostHermesRunnable *runnable = new PostHermesRunnable(&m_jobs, &next);
+            runnable->setAutoDelete(false);
+            runnables.append(runnable);
+
+            pool.start(runnable);
+        }
+        pool.waitForDone();
+
+        qDeleteAll(runnables);
+
+        Hermes::HermesCommonApi.set_integral_param_value(Hermes::numThreads, numThreads);
+    }
+
+    foreach (ProcessJob job, m_jobs)
+    {
+        if (!job.error.isEmpty())
+        {
+            Agros2D::log()->printError("Mesh View", QObject::tr("%1 processing failed: %2").arg(job.name).arg(job.error));
+            continue;
+        }
+
+        cacheInsert(job.key, job.result);
+
+        if (job.linearizerView)
+            *job.linearizerView = job.result.linearizer;
+        if (job.vectorizerView)
+            *job.vectorizerView = job.result.vectorizer;
+        if (job.orderizerView)
+            *job.orderizerView = job.result.orderizer;
+    }
+
+    m_jobs.clear();
+}
+
 void PostHermes::processInitialMesh()
 {
     if (Agros2D::problem()->isMeshed() && (m_activeViewField) && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowInitialMeshView).toBool()))
     {
         Agros2D::log()->printMessage(tr("Mesh View"), tr("Initial mesh with %1 elements").arg(m_activeViewField->initialMesh()->get_num_active_elements()));
 
-        if (m_linInitialMeshView)
-            delete m_linInitialMeshView;
-        m_linInitialMeshView = new Hermes::Hermes2D::Views::Linearizer(Hermes::Hermes2D::OpenGL);
+        // initial mesh does not depend on solution
+        QString key = QString("%1_initialmesh").arg(m_activeViewField->fieldId());
 
-        // init linearizer for initial mesh
-        try
+        CacheItem item;
+        if (cacheLookup(key, item))
         {
-            m_linInitialMeshView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionFixed(0));
-            m_linInitialMeshView->process_solution(Hermes::Hermes2D::MeshFunctionSharedPtr<double>(new Hermes::Hermes2D::ZeroSolution<double>(m_activeViewField->initialMesh())));
+            m_linInitialMeshView = item.linearizer;
+            return;
         }
-        catch (Hermes::Exceptions::Exception& e)
-        {
-            delete m_linInitialMeshView;
-            m_linInitialMeshView = NULL;
 
-            Agros2D::log()->printError("Mesh View", QObject::tr("Linearizer (initial mesh) processing failed: %1").arg(e.info().c_str()));
-        }
+        // init linearizer for initial mesh
+        ProcessJob job;
+        job.type = ProcessType_Linearizer;
+        job.key = key;
+        job.name = QObject::tr("Linearizer (initial mesh)");
+        job.solutions.push_back(Hermes::Hermes2D::MeshFunctionSharedPtr<double>(new Hermes::Hermes2D::ZeroSolution<double>(m_activeViewField->initialMesh())));
+        job.criterion = 0;
+        job.linearizerView = &m_linInitialMeshView;
+
+        m_jobs.append(job);
     }
 }
 
@@ -112,25 +354,27 @@ void PostHermes::processSolutionMesh()
 
         Agros2D::log()->printMessage(tr("Mesh View"), tr("Solution mesh with %1 elements").arg(activeMultiSolutionArray().solutions().at(comp)->get_mesh()->get_num_active_elements()));
 
-        // init linearizer for solution mesh
-        const Hermes::Hermes2D::MeshSharedPtr mesh = activeMultiSolutionArray().solutions().at(comp)->get_mesh();
-
-        if (m_linSolutionMeshView)
-            delete m_linSolutionMeshView;
-        m_linSolutionMeshView = new Hermes::Hermes2D::Views::Linearizer(Hermes::Hermes2D::OpenGL);
+        QString key = cacheKey("solutionmesh", QString(), comp, 0);
 
-        try
+        CacheItem item;
+        if (cacheLookup(key, item))
         {
-            m_linSolutionMeshView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionFixed(0));
-            m_linSolutionMeshView->process_solution(Hermes::Hermes2D::MeshFunctionSharedPtr<double>(new Hermes::Hermes2D::ZeroSolution<double>(mesh)));
+            m_linSolutionMeshView = item.linearizer;
+            return;
         }
-        catch (Hermes::Exceptions::Exception& e)
-        {
-            delete m_linSolutionMeshView;
-            m_linSolutionMeshView = NULL;
 
-            Agros2D::log()->printError("Mesh View", QObject::tr("Linearizer (solution mesh) processing failed: %1").arg(e.info().c_str()));
-        }
+        // init linearizer for solution mesh
+        const Hermes::Hermes2D::MeshSharedPtr mesh = activeMultiSolutionArray().solutions().at(comp)->get_mesh();
+
+        ProcessJob job;
+        job.type = ProcessType_Linearizer;
+        job.key = key;
+        job.name = QObject::tr("Linearizer (solution mesh)");
+        job.solutions.push_back(Hermes::Hermes2D::MeshFunctionSharedPtr<double>(new Hermes::Hermes2D::ZeroSolution<double>(mesh)));
+        job.criterion = 0;
+        job.linearizerView = &m_linSolutionMeshView;
+
+        m_jobs.append(job);
     }
 }
 
@@ -143,21 +387,23 @@ void PostHermes::processOrder()
 
         int comp = Agros2D::problem()->setting()->value(ProblemSetting::View_OrderComponent).toInt() - 1;
 
-        if (m_orderView)
-            delete m_orderView;
-        m_orderView = new Hermes::Hermes2D::Views::Orderizer();
+        QString key = cacheKey("order", QString(), comp);
 
-        try
+        CacheItem item;
+        if (cacheLookup(key, item))
         {
-            m_orderView->process_space(activeMultiSolutionArray().spaces().at(comp));
+            m_orderView = item.orderizer;
+            return;
         }
-        catch (Hermes::Exceptions::Exception& e)
-        {
-            delete m_orderView;
-            m_orderView = NULL;
 
-            Agros2D::log()->printError("Order View", QObject::tr("Orderizer processing failed: %1").arg(e.info().c_str()));
-        }
+        ProcessJob job;
+        job.type = ProcessType_Orderizer;
+        job.key = key;
+        job.name = QObject::tr("Orderizer");
+        job.space = activeMultiSolutionArray().spaces().at(comp);
+        job.orderizerView = &m_orderView;
+
+        m_jobs.append(job);
     }
 }
 
@@ -165,71 +411,35 @@ void PostHermes::processRangeContour()
 {
     if (Agros2D::problem()->isSolved() && m_activeViewField && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowContourView).toBool()))
     {
-        bool contains = false;
-        foreach (Module::LocalVariable variable, m_activeViewField->viewScalarVariables())
-        {
-            if (variable.id() == Agros2D::problem()->setting()->value(ProblemSetting::View_ContourVariable).toString())
-            {
-                contains = true;
-                break;
-            }
-        }
-
         Agros2D::log()->printMessage(tr("Post View"), tr("Contour view (%1)").arg(Agros2D::problem()->setting()->value(ProblemSetting::View_ContourVariable).toString()));
 
         QString variableName = Agros2D::problem()->setting()->value(ProblemSetting::View_ContourVariable).toString();
         Module::LocalVariable variable = m_activeViewField->localVariable(variableName);
+        PhysicFieldVariableComp comp = variable.isScalar() ? PhysicFieldVariableComp_Scalar : PhysicFieldVariableComp_Magnitude;
+        bool deform = m_activeViewField->hasDeformableShape() && Agros2D::problem()->setting()->value(ProblemSetting::View_DeformContour).toBool();
 
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnContourView;
-        if (variable.isScalar())
-            slnContourView = viewScalarFilter(m_activeViewField->localVariable(Agros2D::problem()->setting()->value(ProblemSetting::View_ContourVariable).toString()),
-                                              PhysicFieldVariableComp_Scalar);
-        else
-            slnContourView = viewScalarFilter(m_activeViewField->localVariable(Agros2D::problem()->setting()->value(ProblemSetting::View_ContourVariable).toString()),
-                                              PhysicFieldVariableComp_Magnitude);
-
-        // new linearizer
-        if (m_linContourView)
-            delete m_linContourView;
-        m_linContourView = new Hermes::Hermes2D::Views::Linearizer(Hermes::Hermes2D::OpenGL);
+        QString key = cacheKey("contour", variableName, comp, 1, deform);
 
-
-        // deformed shape
-        if (m_activeViewField->hasDeformableShape() && Agros2D::problem()->setting()->value(ProblemSetting::View_DeformContour).toBool())
+        CacheItem item;
+        if (cacheLookup(key, item))
         {
-            Hermes::Hermes2D::MagFilter<double> *filter = new Hermes::Hermes2D::MagFilter<double>(Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> >(activeMultiSolutionArray().solutions().at(0),
-                                                                                                                                                                   activeMultiSolutionArray().solutions().at(1)));
-
-            if (fabs(filter->get_approx_max_value() - filter->get_approx_min_value()) > EPS_ZERO)
-            {
-                RectPoint rect = Agros2D::scene()->boundingBox();
-                double dmult = qMax(rect.width(), rect.height()) / filter->get_approx_max_value() / 15.0;
-
-                m_linContourView->set_displacement(activeMultiSolutionArray().solutions().at(0),
-                                                  activeMultiSolutionArray().solutions().at(1),
-                                                  dmult);
-            }
-            delete filter;
-        }
-        else
-        {
-            m_linContourView->set_displacement(NULL, NULL);
+            m_linContourView = item.linearizer;
+            return;
         }
 
-        // process solution.
-        try
-        {
-            m_linContourView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionFixed(1));
-            // m_linContourView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionAdaptive(Hermes::Hermes2D::Views::HERMES_EPS_VERYHIGH));
-            m_linContourView->process_solution(slnContourView, Hermes::Hermes2D::H2D_FN_VAL_0);
-        }
-        catch (Hermes::Exceptions::Exception& e)
-        {
-            delete m_linContourView;
-            m_linContourView = NULL;
+        ProcessJob job;
+        job.type = ProcessType_Linearizer;
+        job.key = key;
+        job.name = QObject::tr("Linearizer (contour view)");
+        job.solutions.push_back(viewScalarFilter(variable, comp));
+        job.criterion = 1;
+        job.linearizerView = &m_linContourView;
 
-            Agros2D::log()->printError("Mesh View", QObject::tr("Linearizer (contour view) processing failed: %1").arg(e.info().c_str()));
-        }
+        // deformed shape
+        if (deform)
+            setDisplacement(job);
+
+        m_jobs.append(job);
     }
 }
 
@@ -239,87 +449,35 @@ void PostHermes::processRangeScalar()
             && ((Agros2D::problem()->setting()->value(ProblemSetting::View_ShowScalarView).toBool())
                 || (((SceneViewPost3DMode) Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DMode).toInt()) == SceneViewPost3DMode_ScalarView3D)))
     {
-        bool contains = false;
-        foreach (Module::LocalVariable variable, m_activeViewField->viewScalarVariables())
-        {
-            if (variable.id() == Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariable).toString())
-            {
-                contains = true;
-                break;
-            }
-        }
-
         Agros2D::log()->printMessage(tr("Post View"), tr("Scalar view (%1)").arg(Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariable).toString()));
 
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnScalarView = viewScalarFilter(m_activeViewField->localVariable(Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariable).toString()),
-                                                                                         (PhysicFieldVariableComp) Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariableComp).toInt());
+        QString variableName = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariable).toString();
+        PhysicFieldVariableComp comp = (PhysicFieldVariableComp) Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariableComp).toInt();
+        bool deform = m_activeViewField->hasDeformableShape() && Agros2D::problem()->setting()->value(ProblemSetting::View_DeformScalar).toBool();
 
-        // new linearizer
-        if (m_linScalarView)
-            delete m_linScalarView;
-        m_linScalarView = new Hermes::Hermes2D::Views::Linearizer(Hermes::Hermes2D::OpenGL);
+        QString key = cacheKey("scalar", variableName, comp, 1, deform);
 
-        // deformed shape
-        if (m_activeViewField->hasDeformableShape() && Agros2D::problem()->setting()->value(ProblemSetting::View_DeformScalar).toBool())
-        {
-            Hermes::Hermes2D::MagFilter<double> *filter = new Hermes::Hermes2D::MagFilter<double>(Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> >(activeMultiSolutionArray().solutions().at(0),
-                                                                                                                                                                   activeMultiSolutionArray().solutions().at(1)));
-
-            if (fabs(filter->get_approx_max_value() - filter->get_approx_min_value()) > EPS_ZERO)
-            {
-                RectPoint rect = Agros2D::scene()->boundingBox();
-                double dmult = qMax(rect.width(), rect.height()) / filter->get_approx_max_value() / 15.0;
-
-                m_linScalarView->set_displacement(activeMultiSolutionArray().solutions().at(0),
-                                                  activeMultiSolutionArray().solutions().at(1),
-                                                  dmult);
-            }
-            delete filter;
-        }
-        else
+        CacheItem item;
+        if (cacheLookup(key, item))
         {
-            m_linScalarView->set_displacement(NULL, NULL);
+            m_linScalarView = item.linearizer;
+            return;
         }
 
-        // process solution
-        try
-        {
-            /*
-            QTime time;
-
-            time.start();
-            m_linScalarView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionAdaptive(Hermes::Hermes2D::Views::HERMES_EPS_VERYHIGH));
-            m_linScalarView->process_solution(slnScalarView, Hermes::Hermes2D::H2D_FN_VAL_0);
-            qDebug() << "LinearizerCriterionAdaptive(Hermes::Hermes2D::Views::HERMES_EPS_VERYHIGH)" << time.elapsed();
-
-            time.start();
-            m_linScalarView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionAdaptive(Hermes::Hermes2D::Views::HERMES_EPS_HIGH));
-            m_linScalarView->process_solution(slnScalarView, Hermes::Hermes2D::H2D_FN_VAL_0);
-            qDebug() << "LinearizerCriterionAdaptive(Hermes::Hermes2D::Views::HERMES_EPS_HIGH)" << time.elapsed();
-
-            time.start();
-            m_linScalarView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionFixed(2));
-            m_linScalarView->process_solution(slnScalarView, Hermes::Hermes2D::H2D_FN_VAL_0);
-            qDebug() << "LinearizerCriterionFixed(2)" << time.elapsed();
-            */
-            // time.start();
-            m_linScalarView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionFixed(1));
-            m_linScalarView->process_solution(slnScalarView, Hermes::Hermes2D::H2D_FN_VAL_0);
-            // qDebug() << "LinearizerCriterionFixed(1)" << time.elapsed();
-
-            if (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool())
-            {
-                Agros2D::problem()->setting()->setValue(ProblemSetting::View_ScalarRangeMin, m_linScalarView->get_min_value());
-                Agros2D::problem()->setting()->setValue(ProblemSetting::View_ScalarRangeMax, m_linScalarView->get_max_value());
-            }
-        }
-        catch (Hermes::Exceptions::Exception &e)
-        {
-            delete m_linScalarView;
-            m_linScalarView = NULL;
+        ProcessJob job;
+        job.type = ProcessType_Linearizer;
+        job.key = key;
+        job.name = QObject::tr("Linearizer (scalar view)");
+        job.solutions.push_back(viewScalarFilter(m_activeViewField->localVariable(variableName), comp));
+        job.criterion = 1;
+        job.linearizerView = &m_linScalarView;
 
-            Agros2D::log()->printError("Mesh View", QObject::tr("Linearizer (scalar view) processing failed: %1").arg(e.info().c_str()));
-        }
+        // deformed shape
+        if (deform)
+            setDisplacement(job);
+
+        // scalar view is usually the most expensive one
+        m_jobs.prepend(job);
     }
 }
 
@@ -327,106 +485,58 @@ void PostHermes::processRangeVector()
 {
     if ((Agros2D::problem()->isSolved()) && (m_activeViewField) && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowVectorView).toBool()))
     {
-        bool contains = false;
-        foreach (Module::LocalVariable variable, m_activeViewField->viewVectorVariables())
-        {
-            if (variable.id() == Agros2D::problem()->setting()->value(ProblemSetting::View_VectorVariable).toString())
-            {
-                contains = true;
-                break;
-            }
-        }
-
         Agros2D::log()->printMessage(tr("Post View"), tr("Vector view (%1)").arg(Agros2D::problem()->setting()->value(ProblemSetting::View_VectorVariable).toString()));
 
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnVectorXView = viewScalarFilter(m_activeViewField->localVariable(Agros2D::problem()->setting()->value(ProblemSetting::View_VectorVariable).toString()),
-                                                                                          PhysicFieldVariableComp_X);
-
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnVectorYView = viewScalarFilter(m_activeViewField->localVariable(Agros2D::problem()->setting()->value(ProblemSetting::View_VectorVariable).toString()),
-                                                                                          PhysicFieldVariableComp_Y);
-
-        // new vectorizer
-        if (m_vecVectorView)
-            delete m_vecVectorView;
-        m_vecVectorView = new Hermes::Hermes2D::Views::Vectorizer(Hermes::Hermes2D::OpenGL);
+        QString variableName = Agros2D::problem()->setting()->value(ProblemSetting::View_VectorVariable).toString();
+        bool deform = m_activeViewField->hasDeformableShape() && Agros2D::problem()->setting()->value(ProblemSetting::View_DeformVector).toBool();
 
-        // deformed shape
-        if (m_activeViewField->hasDeformableShape() && Agros2D::problem()->setting()->value(ProblemSetting::View_DeformVector).toBool())
-        {
-            Hermes::Hermes2D::MagFilter<double> *filter = new Hermes::Hermes2D::MagFilter<double>(Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> >(activeMultiSolutionArray().solutions().at(0),
-                                                                                                                                                                   activeMultiSolutionArray().solutions().at(1)));
-            if (fabs(filter->get_approx_max_value() - filter->get_approx_min_value()) > EPS_ZERO)
-            {
-                RectPoint rect = Agros2D::scene()->boundingBox();
-                double dmult = qMax(rect.width(), rect.height()) / filter->get_approx_max_value() / 15.0;
+        QString key = cacheKey("vector", variableName, 0, 1, deform);
 
-                m_vecVectorView->set_displacement(activeMultiSolutionArray().solutions().at(0),
-                                                 activeMultiSolutionArray().solutions().at(1),
-                                                 dmult);
-            }
-            delete filter;
-        }
-        else
+        CacheItem item;
+        if (cacheLookup(key, item))
         {
-            m_vecVectorView->set_displacement(NULL, NULL);
+            m_vecVectorView = item.vectorizer;
+            return;
         }
 
-        // process solution
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> slns[2] = { slnVectorXView, slnVectorYView };
-        int items[2] = { Hermes::Hermes2D::H2D_FN_VAL_0, Hermes::Hermes2D::H2D_FN_VAL_0 };
+        ProcessJob job;
+        job.type = ProcessType_Vectorizer;
+        job.key = key;
+        job.name = QObject::tr("Vectorizer");
+        job.solutions.push_back(viewScalarFilter(m_activeViewField->localVariable(variableName), PhysicFieldVariableComp_X));
+        job.solutions.push_back(viewScalarFilter(m_activeViewField->localVariable(variableName), PhysicFieldVariableComp_Y));
+        job.criterion = 1;
+        job.vectorizerView = &m_vecVectorView;
 
-        try
-        {
-            // m_vecVectorView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionAdaptive(Hermes::Hermes2D::Views::HERMES_EPS_VERYHIGH));
-            m_vecVectorView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionFixed(1));
-            m_vecVectorView->process_solution(slns, items);
-        }
-        catch (Hermes::Exceptions::Exception &e)
-        {
-            delete m_vecVectorView;
-            m_vecVectorView = NULL;
+        // deformed shape
+        if (deform)
+            setDisplacement(job);
 
-            Agros2D::log()->printError("Mesh View", QObject::tr("Vectorizer processing failed: %1").arg(e.info().c_str()));
-        }
+        m_jobs.append(job);
     }
 }
 
-void PostHermes::clearView()
+void PostHermes::processRangeAuto()
 {
-    m_isProcessed = false;
-
-    if (m_linInitialMeshView)
-    {
-        delete m_linInitialMeshView;
-        m_linInitialMeshView = NULL;
-    }
-    if (m_linSolutionMeshView)
-    {
-        delete m_linSolutionMeshView;
-        m_linSolutionMeshView = NULL;
-    }
-    if (m_orderView)
+    if (m_linScalarView && Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool())
     {
-        delete m_orderView;
-        m_orderView = NULL;
+        Agros2D::problem()->setting()->setValue(ProblemSetting::View_ScalarRangeMin, m_linScalarView->get_min_value());
+        Agros2D::problem()->setting()->setValue(ProblemSetting::View_ScalarRangeMax, m_linScalarView->get_max_value());
     }
+}
 
-    if (m_linContourView)
-    {
-        delete m_linContourView;
-        m_linContourView = NULL;
-    }
-    if (m_linScalarView)
-    {
-        delete m_linScalarView;
-        m_linScalarView = NULL;
-    }
+void PostHermes::clearView()
+{
+    m_isProcessed = false;
 
-    if (m_vecVectorView)
-    {
-        delete m_vecVectorView;
-        m_vecVectorView = NULL;
-    }
+    // views stay in the cache
+    m_linInitialMeshView.clear();
+    m_linSolutionMeshView.clear();
+    m_orderView.clear();
+
+    m_linContourView.clear();
+    m_linScalarView.clear();
+    m_vecVectorView.clear();
 }
 
 void PostHermes::refresh()
@@ -440,6 +550,10 @@ void PostHermes::refresh()
     if (Agros2D::problem()->isSolved())
         processSolved();
 
+    // views not found in the cache
+    processJobs();
+    processRangeAuto();
+
     m_isProcessed = true;
     emit processed();
     Agros2D::problem()->setIsPostprocessingRunning(false);
@@ -448,6 +562,7 @@ void PostHermes::refresh()
 void PostHermes::clear()
 {
     clearView();
+    clearCache();
 
     m_activeViewField = NULL;
     m_activeTimeStep = NOT_FOUND_SO_FAR;
@@ -457,6 +572,9 @@ void PostHermes::clear()
 
 void PostHermes::problemMeshed()
 {
+    // new mesh
+    clearCache();
+
     if (!m_activeViewField)
     {
         setActiveViewField(Agros2D::problem()->fieldInfos().begin().value());
@@ -474,6 +592,9 @@ void PostHermes::problemMeshed()
 
 void PostHermes::problemSolved()
 {
+    // solutions can be replaced under the same solution ID
+    clearCache();
+
     if (!m_activeViewField)
     {
         setActiveViewField(Agros2D::problem()->fieldInfos().begin().value());
@@ -623,6 +744,143 @@ MultiArray<double> PostHermes::activeMultiSolutionArray()
 
 // ************************************************************************************************
 
+PostVertexArray::PostVertexArray()
+    : m_vertexBuffer(QGLBuffer::VertexBuffer),
+      m_colorBuffer(QGLBuffer::VertexBuffer),
+      m_texCoordBuffer(QGLBuffer::VertexBuffer),
+      m_count(0),
+      m_hasColors(false),
+      m_hasTexCoords(false),
+      m_useBuffers(false),
+      m_isValid(false)
+{
+}
+
+void PostVertexArray::clear()
+{
+    m_vertices.clear();
+    m_colors.clear();
+    m_texCoords.clear();
+
+    m_vertexBuffer.destroy();
+    m_colorBuffer.destroy();
+    m_texCoordBuffer.destroy();
+
+    m_count = 0;
+    m_hasColors = false;
+    m_hasTexCoords = false;
+    m_useBuffers = false;
+    m_isValid = false;
+}
+
+void PostVertexArray::reserve(int count)
+{
+    m_vertices.reserve(count);
+}
+
+static bool uploadVertexBuffer(QGLBuffer &buffer, const void *data, int bytes)
+{
+    if (!buffer.create() || !buffer.bind())
+        return false;
+
+    buffer.setUsagePattern(QGLBuffer::StaticDraw);
+    buffer.allocate(data, bytes);
+    buffer.release();
+
+    return true;
+}
+
+void PostVertexArray::upload()
+{
+    m_count = m_vertices.count();
+    m_hasColors = !m_colors.isEmpty();
+    m_hasTexCoords = !m_texCoords.isEmpty();
+    assert(!m_hasColors || m_colors.count() == m_count);
+    assert(!m_hasTexCoords || m_texCoords.count() == m_count);
+
+    m_useBuffers = false;
+    if (m_count > 0)
+    {
+        // create() fails without buffer object support
+        m_useBuffers = uploadVertexBuffer(m_vertexBuffer, m_vertices.constData(), m_count * sizeof(QVector2D))
+                && (!m_hasColors || uploadVertexBuffer(m_colorBuffer, m_colors.constData(), m_count * sizeof(QVector3D)))
+                && (!m_hasTexCoords || uploadVertexBuffer(m_texCoordBuffer, m_texCoords.constData(), m_count * sizeof(GLfloat)));
+
+        if (m_useBuffers)
+        {
+            m_vertices = QVector<QVector2D>();
+            m_colors = QVector<QVector3D>();
+            m_texCoords = QVector<GLfloat>();
+        }
+        else
+        {
+            m_vertexBuffer.destroy();
+            m_colorBuffer.destroy();
+            m_texCoordBuffer.destroy();
+        }
+    }
+
+    m_isValid = true;
+}
+
+void PostVertexArray::draw(GLenum mode)
+{
+    if (m_count == 0)
+        return;
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    if (m_useBuffers)
+    {
+        m_vertexBuffer.bind();
+        glVertexPointer(2, GL_FLOAT, 0, 0);
+    }
+    else
+    {
+        glVertexPointer(2, GL_FLOAT, 0, m_vertices.constData());
+    }
+
+    if (m_hasColors)
+    {
+        glEnableClientState(GL_COLOR_ARRAY);
+        if (m_useBuffers)
+        {
+            m_colorBuffer.bind();
+            glColorPointer(3, GL_FLOAT, 0, 0);
+        }
+        else
+        {
+            glColorPointer(3, GL_FLOAT, 0, m_colors.constData());
+        }
+    }
+
+    if (m_hasTexCoords)
+    {
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        if (m_useBuffers)
+        {
+            m_texCoordBuffer.bind();
+            glTexCoordPointer(1, GL_FLOAT, 0, 0);
+        }
+        else
+        {
+            glTexCoordPointer(1, GL_FLOAT, 0, m_texCoords.constData());
+        }
+    }
+
+    if (m_useBuffers)
+        QGLBuffer::release(QGLBuffer::VertexBuffer);
+
+    glDrawArrays(mode, 0, m_count);
+
+    if (m_hasTexCoords)
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    if (m_hasColors)
+        glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+// ************************************************************************************************
+
 SceneViewPostInterface::SceneViewPostInterface(PostHermes *postHermes, QWidget *parent)
     : SceneViewCommon(parent),
       m_postHermes(postHermes),
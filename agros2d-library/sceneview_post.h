@@ -23,11 +23,14 @@
 #include "util.h"
 #include "sceneview_common.h"
 
+#include <QGLBuffer>
+
 template <typename Scalar> class SceneSolution;
 template <typename Scalar> class MultiArray;
 
 class ParticleTracing;
 class FieldInfo;
+class PostHermesRunnable;
 
 class PostHermes : public QObject
 {
@@ -38,20 +41,21 @@ public:
     ~PostHermes();
 
     // mesh
-    inline Hermes::Hermes2D::Views::Linearizer *linInitialMeshView() { return m_linInitialMeshView; }
-    inline Hermes::Hermes2D::Views::Linearizer *linSolutionMeshView() { return m_linSolutionMeshView; }
+    inline Hermes::Hermes2D::Views::Linearizer *linInitialMeshView() { return m_linInitialMeshView.data(); }
+    inline Hermes::Hermes2D::Views::Linearizer *linSolutionMeshView() { return m_linSolutionMeshView.data(); }
 
     // order view
-    Hermes::Hermes2D::Views::Orderizer *ordView() { return m_orderView; }
+    Hermes::Hermes2D::Views::Orderizer *ordView() { return m_orderView.data(); }
 
     // contour
-    inline Hermes::Hermes2D::Views::Linearizer *linContourView() { return m_linContourView; }
+    inline Hermes::Hermes2D::Views::Linearizer *linContourView() { return m_linContourView.data(); }
 
     // scalar view
-    inline Hermes::Hermes2D::Views::Linearizer *linScalarView() { return m_linScalarView; }
+    inline Hermes::Hermes2D::Views::Linearizer *linScalarView() { return m_linScalarView.data(); }
 
     // vector view
-    inline Hermes::Hermes2D::Views::Vectorizer *vecVectorView() { return m_vecVectorView; }
+    inline Hermes::Hermes2D::Views::Vectorizer *vecVectorView() { return m_vecVectorView.data(); }
+    inline QSharedPointer<Hermes::Hermes2D::Views::Vectorizer> vecVectorViewPointer() { return m_vecVectorView; }
 
     Hermes::Hermes2D::MeshFunctionSharedPtr<double> viewScalarFilter(Module::LocalVariable physicFieldVariable,
                                                                      PhysicFieldVariableComp physicFieldVariableComp);
@@ -80,27 +84,93 @@ public slots:
     void refresh();
     void clear();
     void clearView();
+    void clearCache();
 
 private:
     bool m_isProcessed;
 
     // initial mesh
-    Hermes::Hermes2D::Views::Linearizer *m_linInitialMeshView;
+    QSharedPointer<Hermes::Hermes2D::Views::Linearizer> m_linInitialMeshView;
 
     // solution mesh
-    Hermes::Hermes2D::Views::Linearizer *m_linSolutionMeshView;
+    QSharedPointer<Hermes::Hermes2D::Views::Linearizer> m_linSolutionMeshView;
 
     // order view
-    Hermes::Hermes2D::Views::Orderizer *m_orderView;
+    QSharedPointer<Hermes::Hermes2D::Views::Orderizer> m_orderView;
 
     // contour
-    Hermes::Hermes2D::Views::Linearizer *m_linContourView;
+    QSharedPointer<Hermes::Hermes2D::Views::Linearizer> m_linContourView;
 
     // scalar view
-    Hermes::Hermes2D::Views::Linearizer *m_linScalarView; // linealizer for scalar view
+    QSharedPointer<Hermes::Hermes2D::Views::Linearizer> m_linScalarView; // linealizer for scalar view
 
     // vector view
-    Hermes::Hermes2D::Views::Vectorizer *m_vecVectorView; // vectorizer for vector view
+    QSharedPointer<Hermes::Hermes2D::Views::Vectorizer> m_vecVectorView; // vectorizer for vector view
+
+    // processed views keyed by solution, variable, component and linearizer criterion
+    // (least recently used are removed above Config_PostCacheMemorySize, views in use are shared)
+    struct CacheItem
+    {
+        CacheItem() : memory(0) {}
+
+        QSharedPointer<Hermes::Hermes2D::Views::Linearizer> linearizer;
+        QSharedPointer<Hermes::Hermes2D::Views::Vectorizer> vectorizer;
+        QSharedPointer<Hermes::Hermes2D::Views::Orderizer> orderizer;
+        qint64 memory;
+    };
+
+    QMap<QString, CacheItem> m_cache;
+    QList<QString> m_cacheKeyOrder;
+    qint64 m_cacheTotalMemory;
+
+    bool cacheLookup(const QString &key, CacheItem &item);
+    void cacheInsert(const QString &key, const CacheItem &item);
+    QString cacheKey(const QString &view, const QString &variable = QString(), int component = 0, int criterion = 0, bool deform = false);
+
+    // processing of one view is prepared in the GUI thread (settings, own filters, cache lookup)
+    // and runs concurrently with the other views in processJobs()
+    enum ProcessType
+    {
+        ProcessType_Linearizer,
+        ProcessType_Vectorizer,
+        ProcessType_Orderizer
+    };
+
+    struct ProcessJob
+    {
+        ProcessJob() : type(ProcessType_Linearizer), criterion(0), displacementMultiplier(0.0),
+            linearizerView(NULL), vectorizerView(NULL), orderizerView(NULL) {}
+
+        ProcessType type;
+        QString key;
+        QString name;
+
+        Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > solutions;
+        Hermes::Hermes2D::SpaceSharedPtr<double> space;
+        int criterion;
+
+        // deformed shape (multiplier is zero for undeformed shape)
+        Hermes::Hermes2D::MeshFunctionSharedPtr<double> displacementX;
+        Hermes::Hermes2D::MeshFunctionSharedPtr<double> displacementY;
+        double displacementMultiplier;
+
+        // view to be set
+        QSharedPointer<Hermes::Hermes2D::Views::Linearizer> *linearizerView;
+        QSharedPointer<Hermes::Hermes2D::Views::Vectorizer> *vectorizerView;
+        QSharedPointer<Hermes::Hermes2D::Views::Orderizer> *orderizerView;
+
+        CacheItem result;
+        QString error;
+    };
+
+    QList<ProcessJob> m_jobs;
+
+    void setDisplacement(ProcessJob &job);
+    void processJobs();
+    static void processJob(ProcessJob &job);
+    static void cloneSolutions(ProcessJob &job);
+
+    friend class PostHermesRunnable;
 
     // view
     FieldInfo *m_activeViewField;
@@ -119,6 +189,7 @@ private slots:
     void processRangeContour();
     void processRangeScalar();
     void processRangeVector();
+    void processRangeAuto();
 
     virtual void clearGLLists() {}
 
@@ -126,6 +197,44 @@ private slots:
     void problemSolved();
 };
 
+// vertices (with optional colors or 1D texture coordinates) of one layer of postprocessor views
+// built once per linearization and drawn from buffer objects, client side vertex arrays are used
+// if buffer objects are not supported (client copy is released after upload to the buffer objects)
+class PostVertexArray
+{
+public:
+    PostVertexArray();
+
+    void clear();
+    void reserve(int count);
+
+    inline void append(double x, double y) { m_vertices.append(QVector2D(x, y)); }
+    inline void append(double x, double y, const QVector3D &color) { m_vertices.append(QVector2D(x, y)); m_colors.append(color); }
+    inline void append(double x, double y, float texCoord) { m_vertices.append(QVector2D(x, y)); m_texCoords.append(texCoord); }
+
+    // finishes the array (context has to be current), empty array is valid
+    void upload();
+    inline bool isValid() const { return m_isValid; }
+    inline int count() const { return m_count; }
+
+    void draw(GLenum mode);
+
+private:
+    QVector<QVector2D> m_vertices;
+    QVector<QVector3D> m_colors;
+    QVector<GLfloat> m_texCoords;
+
+    QGLBuffer m_vertexBuffer;
+    QGLBuffer m_colorBuffer;
+    QGLBuffer m_texCoordBuffer;
+
+    int m_count;
+    bool m_hasColors;
+    bool m_hasTexCoords;
+    bool m_useBuffers;
+    bool m_isValid;
+};
+
 class SceneViewPostInterface : public SceneViewCommon
 {
     Q_OBJECT
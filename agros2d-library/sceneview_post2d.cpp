@@ -43,14 +43,12 @@
 #include "hermes2d/problem.h"
 #include "hermes2d/problem_config.h"
 #include "hermes2d/plugin_interface.h"
+#include "hermes2d/element_locator.h"
 
 #include "pythonlab/pythonengine_agros.h"
 
 SceneViewPost2D::SceneViewPost2D(PostHermes *postHermes, QWidget *parent)
     : SceneViewCommon2D(postHermes, parent),
-      m_listContours(-1),
-      m_listVectors(-1),
-      m_listScalarField(-1),
       m_selectedPoint(Point())
 {
     createActionsPost2D();
@@ -170,7 +168,8 @@ void SceneViewPost2D::mousePressEvent(QMouseEvent *event)
         // select volume integral area
         if (actPostprocessorModeVolumeIntegral->isChecked())
         {
-            Hermes::Hermes2D::Element *e = Hermes::Hermes2D::RefMap::element_on_physical_coordinates(false, postHermes()->activeViewField()->initialMesh(), p.x, p.y);
+            QSharedPointer<ElementLocator> locator = postHermes()->activeViewField()->initialMeshLocator();
+            Hermes::Hermes2D::Element *e = locator.isNull() ? NULL : locator->element(p.x, p.y);
             if (e)
             {
                 SceneLabel *label = Agros2D::scene()->labels->at(atoi(postHermes()->activeViewField()->initialMesh()->get_element_markers_conversion().
@@ -309,145 +308,73 @@ void SceneViewPost2D::paintScalarField()
 
     loadProjection2d(true);
 
-    if (m_listScalarField == -1)
+    if (!m_arrayScalarField.isValid())
     {
         if (!m_postHermes->linScalarView()) return;
 
         paletteCreate();
 
-        m_listScalarField = glGenLists(1);
-        glNewList(m_listScalarField, GL_COMPILE);
+        double rangeMin = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble();
+        double rangeMax = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble();
+        bool rangeAuto = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool();
+        bool rangeLog = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeLog).toBool();
+        int rangeBase = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeBase).toInt();
 
         // range
-        double irange = 1.0 / (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble());
+        double irange = 1.0 / (rangeMax - rangeMin);
         // special case: constant solution
-        if (fabs(Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) < EPS_ZERO)
+        if (fabs(rangeMax - rangeMin) < EPS_ZERO)
             irange = 1.0;
 
-        // set texture for coloring
-        glEnable(GL_TEXTURE_1D);
-        glBindTexture(GL_TEXTURE_1D, m_textureScalar);
-        glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_DECAL);
-
-        // set texture transformation matrix
-        glMatrixMode(GL_TEXTURE);
-        glLoadIdentity();
-        glTranslated(m_texShift, 0.0, 0.0);
-        glScaled(m_texScale, 0.0, 0.0);
-
-        glBegin(GL_TRIANGLES);
+        m_arrayScalarField.reserve(3 * m_postHermes->linScalarView()->get_triangle_count());
         for (Hermes::Hermes2D::Views::Linearizer::Iterator<Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t>
              it = m_postHermes->linScalarView()->triangles_begin(); !it.end; ++it)
         {
             Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t& triangle = it.get();
 
-            if (!Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool())
+            if (!rangeAuto)
             {
                 double avgValue = (triangle[0][2] + triangle[1][2] + triangle[2][2]) / 3.0;
-                if (avgValue < Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble() || avgValue > Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble())
+                if (avgValue < rangeMin || avgValue > rangeMax)
                     continue;
             }
 
             for (int j = 0; j < 3; j++)
             {
-                if (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeLog).toBool())
-                    glTexCoord1d(log10((double) (1 + (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeBase).toInt() - 1))
-                                       * (triangle[j][2] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) * irange) / log10((double) Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeBase).toInt()));
+                double texCoord;
+                if (rangeLog)
+                    texCoord = log10((double) (1 + (rangeBase - 1)) * (triangle[j][2] - rangeMin) * irange) / log10((double) rangeBase);
                 else
-                    glTexCoord1d((triangle[j][2] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) * irange);
+                    texCoord = (triangle[j][2] - rangeMin) * irange;
 
-                glVertex2d(triangle[j][0], triangle[j][1]);
+                m_arrayScalarField.append(triangle[j][0], triangle[j][1], (float) texCoord);
             }
         }
-        glEnd();
-
-        glDisable(GL_POLYGON_OFFSET_FILL);
-        glDisable(GL_TEXTURE_1D);
-
-        // switch-off texture transform
-        glMatrixMode(GL_TEXTURE);
-        glLoadIdentity();
-        glMatrixMode(GL_MODELVIEW);
-
-        glEndList();
-
-        glCallList(m_listScalarField);
-
-        /*
-        // range
-        double irange = PALETTEENTRIES / (Agros2D::problem()->configView()->scalarRangeMax - Agros2D::problem()->configView()->scalarRangeMin);
-        // special case: constant solution
-        if (fabs(Agros2D::problem()->configView()->scalarRangeMax - Agros2D::problem()->configView()->scalarRangeMin) < EPS_ZERO)
-            irange = PALETTEENTRIES / 2;
-
-        double3* linVert = m_postHermes->linScalarView()->get_vertices();
-        int3* linTris = m_postHermes->linScalarView()->get_triangles();
-        Point point[3];
-        double value[3];
 
-        for (int i = 0; i < m_postHermes->linScalarView()->get_num_triangles(); i++)
-        {
-            for (int j = 0; j < 3; j++)
-            {
-                point[j].x = linVert[linTris[i][j]][0];
-                point[j].y = linVert[linTris[i][j]][1];
-                value[j]   = linVert[linTris[i][j]][2];
-            }
-
-            if (!Agros2D::problem()->configView()->scalarRangeAuto)
-            {
-                double avgValue = (value[0] + value[1] + value[2]) / 3.0;
-                if (avgValue < Agros2D::problem()->configView()->scalarRangeMin || avgValue > Agros2D::problem()->configView()->scalarRangeMax)
-                    continue;
-            }
-
-            for (int j = 0; j < 3; j++)
-            {
-                m_arrayScalarField.push_back(QVector2D(point[j].x, point[j].y));
-
-                const double* color = paletteColor2((value[j] - Agros2D::problem()->configView()->scalarRangeMin) * irange);
-
-                m_arrayScalarFieldColors.push_back(QVector3D(color[0], color[1], color[2]));
-                // qDebug() << ((value[j] - Agros2D::problem()->configView()->scalarRangeMin) * irange) << m_arrayScalarFieldColors.at(m_arrayScalarFieldColors.count() - 1);
-
-            }
-        }
-        */
+        m_arrayScalarField.upload();
     }
-    else
-    {
-        glCallList(m_listScalarField);
 
-        /*
-        glLineWidth(1.0);
-        glDisable(GL_POLYGON_OFFSET_FILL);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-
-        glBegin(GL_TRIANGLES);
-        for (Hermes::Hermes2D::Views::Linearizer::Iterator<Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t>
-             it = m_postHermes->linScalarView()->triangles_begin(); !it.end; ++it)
-        {
-            Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t& triangle = it.get();
+    // set texture for coloring
+    glEnable(GL_TEXTURE_1D);
+    glBindTexture(GL_TEXTURE_1D, m_textureScalar);
+    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_DECAL);
 
-            for (int j = 0; j < 3; j++)
-                glVertex2d(triangle[j][0], triangle[j][1]);
-        }
-        glEnd();
-        */
+    // set texture transformation matrix
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glTranslated(m_texShift, 0.0, 0.0);
+    glScaled(m_texScale, 0.0, 0.0);
+    glMatrixMode(GL_MODELVIEW);
 
-        /*
-        glEnableClientState(GL_COLOR_ARRAY);
-        glEnableClientState(GL_VERTEX_ARRAY);
+    m_arrayScalarField.draw(GL_TRIANGLES);
 
-        glColorPointer(3, GL_FLOAT, 0, m_arrayScalarFieldColors.constData());
-        glVertexPointer(2, GL_FLOAT, 0, m_arrayScalarField.constData());
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glDisable(GL_TEXTURE_1D);
 
-        glDrawArrays(GL_TRIANGLES, 0, m_arrayScalarField.size());
-
-        glDisableClientState(GL_VERTEX_ARRAY);
-        glDisableClientState(GL_COLOR_ARRAY);
-        */
-    }
+    // switch-off texture transform
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glMatrixMode(GL_MODELVIEW);
 }
 
 void SceneViewPost2D::paintContours()
@@ -456,13 +383,10 @@ void SceneViewPost2D::paintContours()
 
     loadProjection2d(true);
 
-    if (m_listContours == -1)
+    if (!m_arrayContours.isValid())
     {
         if (!m_postHermes->linContourView()) return;
 
-        m_listContours = glGenLists(1);
-        glNewList(m_listContours, GL_COMPILE);
-
         // transform variable
         double rangeMin =  numeric_limits<double>::max();
         double rangeMax = -numeric_limits<double>::max();
@@ -476,36 +400,32 @@ void SceneViewPost2D::paintContours()
             if (vertex[2] < rangeMin) rangeMin = vertex[2];
         }
 
-        // draw contours
+        // contour lines
         if ((rangeMax-rangeMin) > EPS_ZERO)
         {
             // value range
             double step = (rangeMax-rangeMin) / Agros2D::problem()->setting()->value(ProblemSetting::View_ContoursCount).toInt();
 
-            glLineWidth(Agros2D::problem()->setting()->value(ProblemSetting::View_ContoursWidth).toInt());
-            glColor3d(COLORCONTOURS[0], COLORCONTOURS[1], COLORCONTOURS[2]);
-
-            glBegin(GL_LINES);
             for (Hermes::Hermes2D::Views::Linearizer::Iterator<Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t>
                  it = m_postHermes->linContourView()->triangles_begin(); !it.end; ++it)
             {
                 Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t& triangle = it.get();
-                paintContoursTri(triangle, step);
+                paintContoursTri(triangle, step, m_arrayContours);
             }
-            glEnd();
         }
 
-        glEndList();
-
-        glCallList(m_listContours);
-    }
-    else
-    {
-        glCallList(m_listContours);
+        m_arrayContours.upload();
     }
+
+    glLineWidth(Agros2D::problem()->setting()->value(ProblemSetting::View_ContoursWidth).toInt());
+    glColor3d(COLORCONTOURS[0], COLORCONTOURS[1], COLORCONTOURS[2]);
+
+    m_arrayContours.draw(GL_LINES);
+
+    glLineWidth(1.0);
 }
 
-void SceneViewPost2D::paintContoursTri(Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t& triangle, double step)
+void SceneViewPost2D::paintContoursTri(Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t& triangle, double step, PostVertexArray &array)
 {
     // sort the vertices by their value, keep track of the permutation sign.
     int i, idx[3] = { 0, 1, 2 }, perm = 0;
@@ -552,13 +472,13 @@ void SceneViewPost2D::paintContoursTri(Hermes::Hermes2D::Views::ScalarLinearizer
 
             if (perm & 1)
             {
-                glVertex2d(x1, y1);
-                glVertex2d(x2, y2);
+                array.append(x1, y1);
+                array.append(x2, y2);
             }
             else
             {
-                glVertex2d(x2, y2);
-                glVertex2d(x1, y1);
+                array.append(x2, y2);
+                array.append(x1, y1);
             }
 
             val += step;
@@ -796,231 +716,319 @@ void SceneViewPost2D::paintVectors()
 }
 */
 
+bool SceneViewPost2D::VectorSettings::operator==(const VectorSettings &other) const
+{
+    return (count == other.count) && (proportional == other.proportional) && (color == other.color)
+            && (scale == other.scale) && (center == other.center) && (type == other.type);
+}
+
+// triangle of the vectorizer, vector components are interpolated by planes
+struct VectorTriangle
+{
+    Point vertex[3];
+
+    // x = ax + bx * x + cx * y, y = ay + by * x + cy * y
+    double ax, bx, cx;
+    double ay, by, cy;
+};
+
+// maximal number of bins in one direction
+const int VECTOR_BINS_MAX = 1024;
+
 void SceneViewPost2D::paintVectors()
 {
     if (!Agros2D::problem()->isSolved()) return;
 
     loadProjection2d(true);
 
-    if (m_listVectors == -1)
+    VectorSettings settings;
+    settings.count = Agros2D::problem()->setting()->value(ProblemSetting::View_VectorCount).toInt();
+    settings.proportional = Agros2D::problem()->setting()->value(ProblemSetting::View_VectorProportional).toBool();
+    settings.color = Agros2D::problem()->setting()->value(ProblemSetting::View_VectorColor).toBool();
+    settings.scale = Agros2D::problem()->setting()->value(ProblemSetting::View_VectorScale).toDouble();
+    settings.center = (VectorCenter) Agros2D::problem()->setting()->value(ProblemSetting::View_VectorCenter).toInt();
+    settings.type = (VectorType) Agros2D::problem()->setting()->value(ProblemSetting::View_VectorType).toInt();
+
+    // glyphs are kept until the vectorizer or settings change
+    if (m_arrayVectors.isValid() && ((m_vectorsVectorizer != m_postHermes->vecVectorViewPointer()) || !(m_vectorsSettings == settings)))
+        m_arrayVectors.clear();
+
+    if (!m_arrayVectors.isValid())
     {
         if (!m_postHermes->vecVectorView()) return;
 
-        m_listVectors = glGenLists(1);
-        glNewList(m_listVectors, GL_COMPILE);
+        m_vectorsVectorizer = m_postHermes->vecVectorViewPointer();
+        m_vectorsSettings = settings;
 
-        double vectorRangeMin = m_postHermes->vecVectorView()->get_min_value();
-        double vectorRangeMax = m_postHermes->vecVectorView()->get_max_value();
+        paintVectorsGlyphs(settings);
 
-        //Add 20% margin to the range
-        double vectorRange = vectorRangeMax - vectorRangeMin;
-        vectorRangeMin = vectorRangeMin - 0.2*vectorRange;
-        vectorRangeMax = vectorRangeMax + 0.2*vectorRange;
+        m_arrayVectors.upload();
+    }
 
-        // qDebug() << "SceneViewCommon::paintVectors(), min = " << vectorRangeMin << ", max = " << vectorRangeMax;
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
-        double irange = 1.0 / (vectorRangeMax - vectorRangeMin);
-        // if (fabs(vectorRangeMin - vectorRangeMax) < EPS_ZERO) return;
+    m_arrayVectors.draw(GL_TRIANGLES);
 
-        RectPoint rect = Agros2D::scene()->boundingBox();
-        double gs = (rect.width() + rect.height()) / Agros2D::problem()->setting()->value(ProblemSetting::View_VectorCount).toInt();
+    glDisable(GL_POLYGON_OFFSET_FILL);
+}
 
-        /*
-        Point point[3];
-        double value[3];
+void SceneViewPost2D::paintVectorsGlyphs(const VectorSettings &settings)
+{
+    double vectorRangeMin = m_postHermes->vecVectorView()->get_min_value();
+    double vectorRangeMax = m_postHermes->vecVectorView()->get_max_value();
 
-        glEnable(GL_POLYGON_OFFSET_FILL);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+    //Add 20% margin to the range
+    double vectorRange = vectorRangeMax - vectorRangeMin;
+    vectorRangeMin = vectorRangeMin - 0.2*vectorRange;
+    vectorRangeMax = vectorRangeMax + 0.2*vectorRange;
 
-        glBegin(GL_TRIANGLES);
-        for (int i = 0; i < m_postHermes->vecVectorView().get_num_triangles(); i++)
-        {
-            for (int j = 0; j < 3; j++)
-            {
-                point[j].x = vecVert[vecTris[i][j]][0];
-                point[j].y = vecVert[vecTris[i][j]][1];
-                value[j]   = vecVert[vecTris[i][j]][2];
+    double irange = 1.0 / (vectorRangeMax - vectorRangeMin);
 
-                glVertex2d(point[j].x, point[j].y);
-            }
+    RectPoint rect = Agros2D::scene()->boundingBox();
+    double gs = (rect.width() + rect.height()) / settings.count;
+
+    // triangles and their extent
+    QVector<VectorTriangle> triangles;
+    triangles.reserve(m_postHermes->vecVectorView()->get_triangle_count());
+
+    Point min( numeric_limits<double>::max(),  numeric_limits<double>::max());
+    Point max(-numeric_limits<double>::max(), -numeric_limits<double>::max());
+
+    for (Hermes::Hermes2D::Views::Vectorizer::Iterator<Hermes::Hermes2D::Views::VectorLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t>
+         it = m_postHermes->vecVectorView()->triangles_begin(); !it.end; ++it)
+    {
+        Hermes::Hermes2D::Views::VectorLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t& triangle = it.get();
+
+        Point a(triangle[0][0], triangle[0][1]);
+        Point b(triangle[1][0], triangle[1][1]);
+        Point c(triangle[2][0], triangle[2][1]);
+
+        // double area
+        double area2 = a.x * (b.y - c.y) + b.x * (c.y - a.y) + c.x * (a.y - b.y);
+        if (fabs(area2) < EPS_ZERO * EPS_ZERO)
+            continue;
+
+        // plane equation
+        double aa = b.x*c.y - c.x*b.y;
+        double ab = c.x*a.y - a.x*c.y;
+        double ac = a.x*b.y - b.x*a.y;
+        double ba = b.y - c.y;
+        double bb = c.y - a.y;
+        double bc = a.y - b.y;
+        double ca = c.x - b.x;
+        double cb = a.x - c.x;
+        double cc = b.x - a.x;
+
+        VectorTriangle tri;
+        tri.vertex[0] = a;
+        tri.vertex[1] = b;
+        tri.vertex[2] = c;
+
+        tri.ax = (aa * triangle[0][2] + ab * triangle[1][2] + ac * triangle[2][2]) / area2;
+        tri.bx = (ba * triangle[0][2] + bb * triangle[1][2] + bc * triangle[2][2]) / area2;
+        tri.cx = (ca * triangle[0][2] + cb * triangle[1][2] + cc * triangle[2][2]) / area2;
+
+        tri.ay = (aa * triangle[0][3] + ab * triangle[1][3] + ac * triangle[2][3]) / area2;
+        tri.by = (ba * triangle[0][3] + bb * triangle[1][3] + bc * triangle[2][3]) / area2;
+        tri.cy = (ca * triangle[0][3] + cb * triangle[1][3] + cc * triangle[2][3]) / area2;
+
+        triangles.append(tri);
+
+        for (int l = 0; l < 3; l++)
+        {
+            min.x = qMin(min.x, tri.vertex[l].x);
+            min.y = qMin(min.y, tri.vertex[l].y);
+            max.x = qMax(max.x, tri.vertex[l].x);
+            max.y = qMax(max.y, tri.vertex[l].y);
         }
-        glEnd();
-        */
+    }
 
-        glEnable(GL_POLYGON_OFFSET_FILL);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    if (triangles.isEmpty())
+        return;
 
-        glBegin(GL_TRIANGLES);
-        for (Hermes::Hermes2D::Views::Vectorizer::Iterator<Hermes::Hermes2D::Views::VectorLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t>
-             it = m_postHermes->vecVectorView()->triangles_begin(); !it.end; ++it)
+    // bins with about one triangle each (triangles are stored in all bins covered by their bounding box)
+    double size = qMax(qMax(max.x - min.x, max.y - min.y), EPS_ZERO);
+    double binSize = qMax(sqrt(qMax(max.x - min.x, size / VECTOR_BINS_MAX) * qMax(max.y - min.y, size / VECTOR_BINS_MAX) / triangles.count()),
+                          size / VECTOR_BINS_MAX);
+    int nx = qMin(VECTOR_BINS_MAX, (int) ((max.x - min.x) / binSize) + 1);
+    int ny = qMin(VECTOR_BINS_MAX, (int) ((max.y - min.y) / binSize) + 1);
+
+    QVector<int> binStart(nx * ny + 1, 0);
+    QVector<int> binTriangles;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        QVector<int> binFill;
+        if (pass == 1)
+        {
+            // offsets of bins
+            for (int i = 0; i < nx * ny; i++)
+                binStart[i + 1] += binStart[i];
+            binTriangles.resize(binStart[nx * ny]);
+            binFill = binStart;
+        }
+
+        for (int t = 0; t < triangles.count(); t++)
         {
-            Hermes::Hermes2D::Views::VectorLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t& triangle = it.get();
-
-            Point a(triangle[0][0], triangle[0][1]);
-            Point b(triangle[1][0], triangle[1][1]);
-            Point c(triangle[2][0], triangle[2][1]);
-
-            RectPoint r;
-            r.start = Point(qMin(qMin(a.x, b.x), c.x), qMin(qMin(a.y, b.y), c.y));
-            r.end = Point(qMax(qMax(a.x, b.x), c.x), qMax(qMax(a.y, b.y), c.y));
-
-            // double area
-            double area2 = a.x * (b.y - c.y) + b.x * (c.y - a.y) + c.x * (a.y - b.y);
-
-            // plane equation
-            double aa = b.x*c.y - c.x*b.y;
-            double ab = c.x*a.y - a.x*c.y;
-            double ac = a.x*b.y - b.x*a.y;
-            double ba = b.y - c.y;
-            double bb = c.y - a.y;
-            double bc = a.y - b.y;
-            double ca = c.x - b.x;
-            double cb = a.x - c.x;
-            double cc = b.x - a.x;
-
-            double ax = (aa * triangle[0][2] + ab * triangle[1][2] + ac * triangle[2][2]) / area2;
-            double bx = (ba * triangle[0][2] + bb * triangle[1][2] + bc * triangle[2][2]) / area2;
-            double cx = (ca * triangle[0][2] + cb * triangle[1][2] + cc * triangle[2][2]) / area2;
-
-            double ay = (aa * triangle[0][3] + ab * triangle[1][3] + ac * triangle[2][3]) / area2;
-            double by = (ba * triangle[0][3] + bb * triangle[1][3] + bc * triangle[2][3]) / area2;
-            double cy = (ca * triangle[0][3] + cb * triangle[1][3] + cc * triangle[2][3]) / area2;
-
-            for (int j = floor(r.start.x / gs); j < ceil(r.end.x / gs); j++)
+            const VectorTriangle &tri = triangles.at(t);
+
+            double triMinX = qMin(qMin(tri.vertex[0].x, tri.vertex[1].x), tri.vertex[2].x);
+            double triMinY = qMin(qMin(tri.vertex[0].y, tri.vertex[1].y), tri.vertex[2].y);
+            double triMaxX = qMax(qMax(tri.vertex[0].x, tri.vertex[1].x), tri.vertex[2].x);
+            double triMaxY = qMax(qMax(tri.vertex[0].y, tri.vertex[1].y), tri.vertex[2].y);
+
+            int i0 = qBound(0, (int) floor((triMinX - min.x) / binSize), nx - 1);
+            int i1 = qBound(0, (int) floor((triMaxX - min.x) / binSize), nx - 1);
+            int j0 = qBound(0, (int) floor((triMinY - min.y) / binSize), ny - 1);
+            int j1 = qBound(0, (int) floor((triMaxY - min.y) / binSize), ny - 1);
+
+            for (int j = j0; j <= j1; j++)
             {
-                for (int k = floor(r.start.y / gs); k < ceil(r.end.y / gs); k++)
+                for (int i = i0; i <= i1; i++)
                 {
-                    Point point(j*gs, k*gs);
-                    if (k % 2 == 0) point.x += gs/2.0;
+                    if (pass == 0)
+                        binStart[j * nx + i + 1]++;
+                    else
+                        binTriangles[binFill[j * nx + i]++] = t;
+                }
+            }
+        }
+    }
 
-                    // find in triangle
-                    bool inTriangle = true;
+    // every point of the grid is located once
+    for (int k = ceil(min.y / gs); k <= floor(max.y / gs); k++)
+    {
+        double shift = (k % 2 == 0) ? gs/2.0 : 0.0;
 
-                    for (int l = 0; l < 3; l++)
-                    {
-                        int p = l + 1;
-                        if (p == 3)
-                            p = 0;
+        for (int j = ceil((min.x - shift) / gs); j <= floor((max.x - shift) / gs); j++)
+        {
+            Point point(j*gs + shift, k*gs);
 
-                        double z = (triangle[p][0] - triangle[l][0]) * (point.y - triangle[l][1]) - (triangle[p][1] - triangle[l][1]) * (point.x - triangle[l][0]);
+            int bi = qBound(0, (int) floor((point.x - min.x) / binSize), nx - 1);
+            int bj = qBound(0, (int) floor((point.y - min.y) / binSize), ny - 1);
 
-                        if (z < 0)
-                        {
-                            inTriangle = false;
-                            break;
-                        }
-                    }
+            // find in triangle
+            const VectorTriangle *found = NULL;
+            for (int b = binStart[bj * nx + bi]; b < binStart[bj * nx + bi + 1]; b++)
+            {
+                const VectorTriangle &tri = triangles.at(binTriangles.at(b));
 
-                    if (inTriangle)
-                    {
-                        // view
-                        double dx = ax + bx * point.x + cx * point.y;
-                        double dy = ay + by * point.x + cy * point.y;
+                bool inTriangle = true;
+                for (int l = 0; l < 3; l++)
+                {
+                    int p = l + 1;
+                    if (p == 3)
+                        p = 0;
 
-                        double value = sqrt(dx*dx + dy*dy);
-                        double angle = atan2(dy, dx);
+                    double z = (tri.vertex[p].x - tri.vertex[l].x) * (point.y - tri.vertex[l].y) - (tri.vertex[p].y - tri.vertex[l].y) * (point.x - tri.vertex[l].x);
 
-                        if ((Agros2D::problem()->setting()->value(ProblemSetting::View_VectorProportional).toBool()) && (fabs(vectorRangeMin - vectorRangeMax) > EPS_ZERO))
-                        {
-                            if ((value / vectorRangeMax) < 1e-6)
-                            {
-                                dx = 0.0;
-                                dy = 0.0;
-                            }
-                            else
-                            {
-                                dx = ((value - vectorRangeMin) * irange) * Agros2D::problem()->setting()->value(ProblemSetting::View_VectorScale).toDouble() * gs * cos(angle);
-                                dy = ((value - vectorRangeMin) * irange) * Agros2D::problem()->setting()->value(ProblemSetting::View_VectorScale).toDouble() * gs * sin(angle);
-                            }
-                        }
-                        else
-                        {
-                            dx = Agros2D::problem()->setting()->value(ProblemSetting::View_VectorScale).toDouble() * gs * cos(angle);
-                            dy = Agros2D::problem()->setting()->value(ProblemSetting::View_VectorScale).toDouble() * gs * sin(angle);
-                        }
+                    if (z < 0)
+                    {
+                        inTriangle = false;
+                        break;
+                    }
+                }
+
+                if (inTriangle)
+                {
+                    found = &tri;
+                    break;
+                }
+            }
 
-                        double dm = sqrt(dx*dx + dy*dy);
+            if (!found)
+                continue;
 
-                        // color
-                        if ((Agros2D::problem()->setting()->value(ProblemSetting::View_VectorColor).toBool())
-                                && (fabs(vectorRangeMin - vectorRangeMax) > EPS_ZERO))
-                        {
-                            double color = 0.7 - 0.7 * (value - vectorRangeMin) * irange;
-                            glColor3d(color, color, color);
-                        }
-                        else
-                        {
-                            glColor3d(COLORVECTORS[0], COLORVECTORS[1], COLORVECTORS[2]);
-                        }
+            // view
+            double dx = found->ax + found->bx * point.x + found->cx * point.y;
+            double dy = found->ay + found->by * point.x + found->cy * point.y;
 
-                        // tail
-                        Point shiftCenter(0.0, 0.0);
-                        if ((VectorCenter) Agros2D::problem()->setting()->value(ProblemSetting::View_VectorCenter).toInt() == VectorCenter_Head)
-                            shiftCenter = Point(- 2.0*dm * cos(angle), - 2.0*dm * sin(angle)); // head
-                        if ((VectorCenter) Agros2D::problem()->setting()->value(ProblemSetting::View_VectorCenter).toInt() == VectorCenter_Center)
-                            shiftCenter = Point(- dm * cos(angle), - dm * sin(angle)); // center
+            double value = sqrt(dx*dx + dy*dy);
+            double angle = atan2(dy, dx);
 
-                        if ((VectorType) Agros2D::problem()->setting()->value(ProblemSetting::View_VectorType).toInt() == VectorType_Arrow)
-                        {
-                            // arrow and shaft
-                            // head for an arrow
-                            double vh1x = point.x + dm/5.0 * cos(angle - M_PI/2.0) + dm * cos(angle) + shiftCenter.x;
-                            double vh1y = point.y + dm/5.0 * sin(angle - M_PI/2.0) + dm * sin(angle) + shiftCenter.y;
-                            double vh2x = point.x + dm/5.0 * cos(angle + M_PI/2.0) + dm * cos(angle) + shiftCenter.x;
-                            double vh2y = point.y + dm/5.0 * sin(angle + M_PI/2.0) + dm * sin(angle) + shiftCenter.y;
-                            double vh3x = point.x + 2.0 * dm * cos(angle) + shiftCenter.x;
-                            double vh3y = point.y + 2.0 * dm * sin(angle) + shiftCenter.y;
-
-                            glVertex2d(vh1x, vh1y);
-                            glVertex2d(vh2x, vh2y);
-                            glVertex2d(vh3x, vh3y);
-
-                            // shaft for an arrow
-                            double vs1x = point.x + dm/15.0 * cos(angle + M_PI/2.0) + dm * cos(angle) + shiftCenter.x;
-                            double vs1y = point.y + dm/15.0 * sin(angle + M_PI/2.0) + dm * sin(angle) + shiftCenter.y;
-                            double vs2x = point.x + dm/15.0 * cos(angle - M_PI/2.0) + dm * cos(angle) + shiftCenter.x;
-                            double vs2y = point.y + dm/15.0 * sin(angle - M_PI/2.0) + dm * sin(angle) + shiftCenter.y;
-                            double vs3x = vs1x - dm * cos(angle);
-                            double vs3y = vs1y - dm * sin(angle);
-                            double vs4x = vs2x - dm * cos(angle);
-                            double vs4y = vs2y - dm * sin(angle);
-
-                            glVertex2d(vs1x, vs1y);
-                            glVertex2d(vs2x, vs2y);
-                            glVertex2d(vs3x, vs3y);
-                            glVertex2d(vs4x, vs4y);
-                            glVertex2d(vs3x, vs3y);
-                            glVertex2d(vs2x, vs2y);
-                        }
-                        else if ((VectorType) Agros2D::problem()->setting()->value(ProblemSetting::View_VectorType).toInt() == VectorType_Cone)
-                        {
-                            // cone
-                            double vh1x = point.x + dm/3.5 * cos(angle - M_PI/2.0) + shiftCenter.x;
-                            double vh1y = point.y + dm/3.5 * sin(angle - M_PI/2.0) + shiftCenter.y;
-                            double vh2x = point.x + dm/3.5 * cos(angle + M_PI/2.0) + shiftCenter.x;
-                            double vh2y = point.y + dm/3.5 * sin(angle + M_PI/2.0) + shiftCenter.y;
-                            double vh3x = point.x + 2.0 * dm * cos(angle) + shiftCenter.x;
-                            double vh3y = point.y + 2.0 * dm * sin(angle) + shiftCenter.y;
-
-                            glVertex2d(vh1x, vh1y);
-                            glVertex2d(vh2x, vh2y);
-                            glVertex2d(vh3x, vh3y);
-                        }
-                    }
+            if (settings.proportional && (fabs(vectorRangeMin - vectorRangeMax) > EPS_ZERO))
+            {
+                if ((value / vectorRangeMax) < 1e-6)
+                {
+                    dx = 0.0;
+                    dy = 0.0;
+                }
+                else
+                {
+                    dx = ((value - vectorRangeMin) * irange) * settings.scale * gs * cos(angle);
+                    dy = ((value - vectorRangeMin) * irange) * settings.scale * gs * sin(angle);
                 }
             }
-        }
-        glEnd();
+            else
+            {
+                dx = settings.scale * gs * cos(angle);
+                dy = settings.scale * gs * sin(angle);
+            }
 
-        glDisable(GL_POLYGON_OFFSET_FILL);
+            double dm = sqrt(dx*dx + dy*dy);
 
-        glEndList();
+            // color
+            QVector3D color(COLORVECTORS[0], COLORVECTORS[1], COLORVECTORS[2]);
+            if (settings.color && (fabs(vectorRangeMin - vectorRangeMax) > EPS_ZERO))
+            {
+                double gray = 0.7 - 0.7 * (value - vectorRangeMin) * irange;
+                color = QVector3D(gray, gray, gray);
+            }
 
-        glCallList(m_listVectors);
-    }
-    else
-    {
-        glCallList(m_listVectors);
+            // tail
+            Point shiftCenter(0.0, 0.0);
+            if (settings.center == VectorCenter_Head)
+                shiftCenter = Point(- 2.0*dm * cos(angle), - 2.0*dm * sin(angle)); // head
+            if (settings.center == VectorCenter_Center)
+                shiftCenter = Point(- dm * cos(angle), - dm * sin(angle)); // center
+
+            if (settings.type == VectorType_Arrow)
+            {
+                // arrow and shaft
+                // head for an arrow
+                double vh1x = point.x + dm/5.0 * cos(angle - M_PI/2.0) + dm * cos(angle) + shiftCenter.x;
+                double vh1y = point.y + dm/5.0 * sin(angle - M_PI/2.0) + dm * sin(angle) + shiftCenter.y;
+                double vh2x = point.x + dm/5.0 * cos(angle + M_PI/2.0) + dm * cos(angle) + shiftCenter.x;
+                double vh2y = point.y + dm/5.0 * sin(angle + M_PI/2.0) + dm * sin(angle) + shiftCenter.y;
+                double vh3x = point.x + 2.0 * dm * cos(angle) + shiftCenter.x;
+                double vh3y = point.y + 2.0 * dm * sin(angle) + shiftCenter.y;
+
+                m_arrayVectors.append(vh1x, vh1y, color);
+                m_arrayVectors.append(vh2x, vh2y, color);
+                m_arrayVectors.append(vh3x, vh3y, color);
+
+                // shaft for an arrow
+                double vs1x = point.x + dm/15.0 * cos(angle + M_PI/2.0) + dm * cos(angle) + shiftCenter.x;
+                double vs1y = point.y + dm/15.0 * sin(angle + M_PI/2.0) + dm * sin(angle) + shiftCenter.y;
+                double vs2x = point.x + dm/15.0 * cos(angle - M_PI/2.0) + dm * cos(angle) + shiftCenter.x;
+                double vs2y = point.y + dm/15.0 * sin(angle - M_PI/2.0) + dm * sin(angle) + shiftCenter.y;
+                double vs3x = vs1x - dm * cos(angle);
+                double vs3y = vs1y - dm * sin(angle);
+                double vs4x = vs2x - dm * cos(angle);
+                double vs4y = vs2y - dm * sin(angle);
+
+                m_arrayVectors.append(vs1x, vs1y, color);
+                m_arrayVectors.append(vs2x, vs2y, color);
+                m_arrayVectors.append(vs3x, vs3y, color);
+                m_arrayVectors.append(vs4x, vs4y, color);
+                m_arrayVectors.append(vs3x, vs3y, color);
+                m_arrayVectors.append(vs2x, vs2y, color);
+            }
+            else if (settings.type == VectorType_Cone)
+            {
+                // cone
+                double vh1x = point.x + dm/3.5 * cos(angle - M_PI/2.0) + shiftCenter.x;
+                double vh1y = point.y + dm/3.5 * sin(angle - M_PI/2.0) + shiftCenter.y;
+                double vh2x = point.x + dm/3.5 * cos(angle + M_PI/2.0) + shiftCenter.x;
+                double vh2y = point.y + dm/3.5 * sin(angle + M_PI/2.0) + shiftCenter.y;
+                double vh3x = point.x + 2.0 * dm * cos(angle) + shiftCenter.x;
+                double vh3y = point.y + 2.0 * dm * sin(angle) + shiftCenter.y;
+
+                m_arrayVectors.append(vh1x, vh1y, color);
+                m_arrayVectors.append(vh2x, vh2y, color);
+                m_arrayVectors.append(vh3x, vh3y, color);
+            }
+        }
     }
 }
 
@@ -1108,18 +1116,17 @@ void SceneViewPost2D::paintPostprocessorSelectedPoint()
 
 void SceneViewPost2D::clearGLLists()
 {
-    if (m_listContours != -1) glDeleteLists(m_listContours, 1);
-    if (m_listVectors != -1) glDeleteLists(m_listVectors, 1);
-    if (m_listScalarField != -1) glDeleteLists(m_listScalarField, 1);
-
-    m_listContours = -1;
-    m_listVectors = -1;
-    m_listScalarField = -1;
+    m_arrayScalarField.clear();
+    m_arrayContours.clear();
+    m_arrayVectors.clear();
+    m_vectorsVectorizer.clear();
 }
 
 void SceneViewPost2D::refresh()
 {
-    clearGLLists();
+    // vector glyphs are checked against vectorizer and settings in paintVectors()
+    m_arrayScalarField.clear();
+    m_arrayContours.clear();
 
     setControls();
 
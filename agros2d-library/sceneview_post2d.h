@@ -72,7 +72,7 @@ protected:
 
     void paintScalarField(); // paint scalar field surface
     void paintContours(); // paint scalar field contours
-    void paintContoursTri(Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t& triangle, double step);
+    void paintContoursTri(Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t& triangle, double step, PostVertexArray &array);
     void paintVectors(); // paint vector field vectors
 
     void paintPostprocessorSelectedVolume(); // paint selected volume for integration
@@ -83,13 +83,29 @@ private:
     // selected point
     Point m_selectedPoint;
 
-    // gl lists
-    int m_listContours;
-    int m_listVectors;
-    int m_listScalarField;
-
-    // QVector<QVector2D> m_arrayScalarField;
-    // QVector<QVector3D> m_arrayScalarFieldColors;
+    // vertex arrays (built once per linearization)
+    PostVertexArray m_arrayScalarField;
+    PostVertexArray m_arrayContours;
+    PostVertexArray m_arrayVectors;
+
+    // vector view settings resolved before generation of glyphs
+    struct VectorSettings
+    {
+        int count;
+        bool proportional;
+        bool color;
+        double scale;
+        VectorCenter center;
+        VectorType type;
+
+        bool operator==(const VectorSettings &other) const;
+    };
+
+    // glyphs are generated for this vectorizer and settings
+    QSharedPointer<Hermes::Hermes2D::Views::Vectorizer> m_vectorsVectorizer;
+    VectorSettings m_vectorsSettings;
+
+    void paintVectorsGlyphs(const VectorSettings &settings);
 
     void createActionsPost2D();
 
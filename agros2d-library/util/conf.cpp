@@ -75,6 +75,17 @@ void Config::load()
         }
     }
 
+    // cache size (older versions stored number of cached solutions, default 10)
+    if (settings.contains("Config_CacheSize"))
+    {
+        if (!settings.contains(m_settingKey[Config_CacheMemorySize]))
+        {
+            int cacheSize = settings.value("Config_CacheSize").toInt() * m_settingDefault[Config_CacheMemorySize].toInt() / 10;
+            m_setting[Config_CacheMemorySize] = qBound(64, cacheSize, 65536);
+        }
+        settings.remove("Config_CacheSize");
+    }
+
     // number of threads
     if (m_setting[Config_NumberOfThreads].toInt() > omp_get_max_threads())
         m_setting[Config_NumberOfThreads] = omp_get_max_threads();
@@ -100,7 +111,8 @@ void Config::setStringKeys()
     m_settingKey[Config_ShowResults] = "Config_ShowResults";
     m_settingKey[Config_LinearSystemFormat] = "Config_LinearSystemFormat";
     m_settingKey[Config_LinearSystemSave] = "Config_LinearSystemSave";
-    m_settingKey[Config_CacheSize] = "Config_CacheSize";
+    m_settingKey[Config_CacheMemorySize] = "Config_CacheMemorySize";
+    m_settingKey[Config_PostCacheMemorySize] = "Config_PostCacheMemorySize";
     m_settingKey[Config_NumberOfThreads] = "Config_NumberOfThreads";
     m_settingKey[Config_ShowGrid] = "Config_ShowGrid";
     m_settingKey[Config_ShowRulers] = "Config_ShowRulers";
@@ -121,7 +133,8 @@ void Config::setDefaultValues()
     m_settingDefault[Config_ShowResults] = false;
     m_settingDefault[Config_LinearSystemFormat] = EXPORT_FORMAT_MATLAB_MATIO;
     m_settingDefault[Config_LinearSystemSave] = false;
-    m_settingDefault[Config_CacheSize] = 10;
+    m_settingDefault[Config_CacheMemorySize] = 1024;
+    m_settingDefault[Config_PostCacheMemorySize] = 256;
     m_settingDefault[Config_NumberOfThreads] = omp_get_max_threads();
     m_settingDefault[Config_ShowGrid] = true;
     m_settingDefault[Config_ShowRulers] = true;
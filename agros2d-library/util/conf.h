@@ -40,7 +40,8 @@ public:
         Config_ShowResults,
         Config_LinearSystemFormat,
         Config_LinearSystemSave,
-        Config_CacheSize,
+        Config_CacheMemorySize,
+        Config_PostCacheMemorySize,
         Config_NumberOfThreads,
         Config_RulersFontFamily,
         Config_RulersFontPointSize,
@@ -24,6 +24,7 @@
 #include "pythonlab/pythonengine_agros.h"
 #include "hermes2d/problem_config.h"
 #include "parser/lex.h"
+#include "parser/expression.h"
 
 Value::Value(double value)
     : m_isEvaluated(true), m_isTimeDependent(false), m_isCoordinateDependent(false), m_time(0.0), m_point(Point()), m_table(DataTable()), m_problem(Agros2D::problem())
@@ -32,7 +33,8 @@ Value::Value(double value)
     m_number = value;      
 }
 
-Value::Value(double value, std::vector<double> x, std::vector<double> y, DataTableType type, bool splineFirstDerivatives, bool extrapolateConstant)
+Value::Value(double value, std::vector<double> x, std::vector<double> y, DataTableType type, bool splineFirstDerivatives, bool extrapolateConstant,
+             bool uniformResampling)
     : m_isEvaluated(true), m_isTimeDependent(false), m_isCoordinateDependent(false), m_time(0.0), m_point(Point()), m_table(DataTable()), m_problem(Agros2D::problem())
 {
     assert(x.size() == y.size());
@@ -42,7 +44,8 @@ Value::Value(double value, std::vector<double> x, std::vector<double> y, DataTab
     m_table.setValues(x, y);
     m_table.setType(type);
     m_table.setSplineFirstDerivatives(splineFirstDerivatives);
-    m_table.setExtrapolateConstant(extrapolateConstant);       
+    m_table.setExtrapolateConstant(extrapolateConstant);
+    m_table.setUniformResampling(uniformResampling);
 }
 
 Value::Value(const QString &value)
@@ -52,7 +55,8 @@ Value::Value(const QString &value)
     evaluateAndSave();
 }
 
-Value::Value(const QString &value, std::vector<double> x, std::vector<double> y, DataTableType type, bool splineFirstDerivatives, bool extrapolateConstant)
+Value::Value(const QString &value, std::vector<double> x, std::vector<double> y, DataTableType type, bool splineFirstDerivatives, bool extrapolateConstant,
+             bool uniformResampling)
     : m_isEvaluated(false), m_isTimeDependent(false), m_isCoordinateDependent(false), m_time(0.0), m_point(Point()), m_table(DataTable()), m_problem(Agros2D::problem())
 {
     assert(x.size() == y.size());
@@ -62,6 +66,7 @@ Value::Value(const QString &value, std::vector<double> x, std::vector<double> y,
     m_table.setType(type);
     m_table.setSplineFirstDerivatives(splineFirstDerivatives);
     m_table.setExtrapolateConstant(extrapolateConstant);
+    m_table.setUniformResampling(uniformResampling);
     evaluateAndSave();
 }
 
@@ -74,7 +79,6 @@ Value::Value(const QString &value, const DataTable &table)
 Value::Value(const Value &origin)
 {
     *this = origin;
-    evaluateAndSave();
 //    qDebug() << "Copy Value" << this->m_text << ", " << this->m_number;
 }
 
@@ -87,9 +91,19 @@ Value& Value::operator =(const Value &origin)
     m_point = origin.m_point;
     m_isTimeDependent = origin.m_isTimeDependent;
     m_isCoordinateDependent = origin.m_isCoordinateDependent;
+    m_expression = origin.m_expression;
     m_table = origin.m_table;
 
-    evaluateAndSave();
+    // result of native expression (or plain number) depends only on time and point
+    if (origin.m_isEvaluated && (m_expression.isNull() || m_expression->isCompiled()))
+    {
+        m_number = origin.m_number;
+        m_isEvaluated = true;
+    }
+    else
+    {
+        evaluateAndSave();
+    }
 
     return *this;
 //    qDebug() << "operator= Value" << this->m_text << ", " << this->m_number;
@@ -207,6 +221,33 @@ Hermes::Ord Value::derivativeFromTable(Hermes::Ord key) const
     return Hermes::Ord(1);
 }
 
+void Value::numbersFromTable(const double *keys, double *numbers, int count) const
+{
+    if (m_problem->isNonlinear() && hasTable())
+    {
+        m_table.values(keys, numbers, count);
+    }
+    else
+    {
+        double value = number();
+        for (int i = 0; i < count; i++)
+            numbers[i] = value;
+    }
+}
+
+void Value::derivativesFromTable(const double *keys, double *derivatives, int count) const
+{
+    if (m_problem->isNonlinear() && hasTable())
+    {
+        m_table.derivatives(keys, derivatives, count);
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+            derivatives[i] = 0.0;
+    }
+}
+
 void Value::setText(const QString &str)
 {
     m_isEvaluated = false;
@@ -215,12 +256,17 @@ void Value::setText(const QString &str)
     m_isTimeDependent = false;
     m_isCoordinateDependent = false;
 
+    m_expression = QSharedPointer<CompiledExpression>(new CompiledExpression());
+
     LexicalAnalyser lex;
 
     // ToDo: Improve
     try
     {
         lex.setExpression(m_text);
+
+        // compile once, expressions not supported by native engine are evaluated by Python
+        m_expression->compile(lex.tokens());
     }
 
     catch(ParserException e)
@@ -317,6 +363,10 @@ bool Value::evaluateExpression(const QString &expression, double time, const Poi
         return true;
     }
 
+    // native expression
+    if (evaluateCompiledExpression(time, point, evaluationResult))
+        return true;
+
     bool signalBlocked = currentPythonEngineAgros()->signalsBlocked();
     currentPythonEngineAgros()->blockSignals(true);
 
@@ -381,6 +431,45 @@ bool Value::evaluateExpression(const QString &expression, double time, const Poi
     return successfulRun;
 }
 
+bool Value::evaluateCompiledExpression(double time, const Point &point, double &evaluationResult) const
+{
+    if (m_expression.isNull() || !m_expression->isCompiled())
+        return false;
+
+    double variables[ExpressionVariable_Count];
+    variables[ExpressionVariable_Time] = time;
+    variables[ExpressionVariable_X] = point.x;
+    variables[ExpressionVariable_Y] = point.y;
+    variables[ExpressionVariable_R] = point.x;
+    variables[ExpressionVariable_Z] = point.y;
+
+    bool isPlanarDependent = m_expression->dependsOn(ExpressionVariable_X) || m_expression->dependsOn(ExpressionVariable_Y);
+    bool isAxisymmetricDependent = m_expression->dependsOn(ExpressionVariable_R) || m_expression->dependsOn(ExpressionVariable_Z);
+    if (isPlanarDependent || isAxisymmetricDependent)
+    {
+        // coordinates of the other coordinate type are not defined (or they are user variables)
+        if (m_problem->config()->coordinateType() == CoordinateType_Planar)
+        {
+            if (isAxisymmetricDependent)
+                return false;
+        }
+        else
+        {
+            if (isPlanarDependent)
+                return false;
+        }
+    }
+
+    double result;
+    if (!m_expression->evaluate(variables, result))
+        return false;
+
+    // same as Python engine
+    evaluationResult = (fabs(result) < EPS_ZERO) ? 0.0 : result;
+
+    return true;
+}
+
 // ************************************************************************************************
 
 PointValue::PointValue(double x, double y)
@@ -27,6 +27,7 @@
 #include "datatable.h"
 
 class DataTable;
+class CompiledExpression;
 class FieldInfo;
 class Problem;
 
@@ -35,11 +36,13 @@ class AGROS_LIBRARY_API Value
 public:
     Value(double value = 0.0);
     Value(double value,
-          std::vector<double> x, std::vector<double> y, DataTableType type = DataTableType_PiecewiseLinear, bool splineFirstDerivatives = true, bool extrapolateConstant = true);
+          std::vector<double> x, std::vector<double> y, DataTableType type = DataTableType_PiecewiseLinear, bool splineFirstDerivatives = true, bool extrapolateConstant = true,
+          bool uniformResampling = false);
 
     Value(const QString &value);
     Value(const QString &value,
-          std::vector<double> x, std::vector<double> y, DataTableType type = DataTableType_PiecewiseLinear, bool splineFirstDerivatives = true, bool extrapolateConstant = true);
+          std::vector<double> x, std::vector<double> y, DataTableType type = DataTableType_PiecewiseLinear, bool splineFirstDerivatives = true, bool extrapolateConstant = true,
+          bool uniformResampling = false);
     Value(const QString &value, const DataTable &table);
 
     Value(const Value& origin);
@@ -68,6 +71,9 @@ public:
     Hermes::Ord numberFromTable(Hermes::Ord ord) const;
     double derivativeFromTable(double key) const;
     Hermes::Ord derivativeFromTable(Hermes::Ord ord) const;
+    // all keys of element at once, results can overwrite keys
+    void numbersFromTable(const double *keys, double *numbers, int count) const;
+    void derivativesFromTable(const double *keys, double *derivatives, int count) const;
 
     bool hasTable() const;
 
@@ -93,6 +99,9 @@ private:
     bool m_isTimeDependent;
     bool m_isCoordinateDependent;
 
+    // native expression (shared between copies), Python is used if not compiled
+    QSharedPointer<CompiledExpression> m_expression;
+
     // table
     DataTable m_table;
 
@@ -100,6 +109,7 @@ private:
     bool evaluate(double time, const Point &point, double& result) const;
     bool evaluateAndSave();
     bool evaluateExpression(const QString &expression, double time, const Point &point, double& evaluationResult) const ;
+    bool evaluateCompiledExpression(double time, const Point &point, double& evaluationResult) const;
 
     friend class ValueLineEdit;
     friend class PointValue;
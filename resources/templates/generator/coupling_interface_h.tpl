@@ -65,13 +65,15 @@ public:
 
     // local values
     virtual LocalValue *localValue(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType, const Point &point) { assert(0); return NULL; }
+    virtual LocalValues *localValues(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                                     const QVector<Point> &points, const QStringList &variables = QStringList()) { assert(0); return NULL; }
     // surface integrals
     virtual IntegralValue *surfaceIntegral(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType) { assert(0); return NULL; }
     // volume integrals
     virtual IntegralValue *volumeIntegral(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType) { assert(0); return NULL; }
 
     // force calculation
-    virtual Point3 force(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+    virtual Point3 force(const FieldInfo *fieldInfo, int timeStep, const Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > &solutions,
                          Hermes::Hermes2D::Element *element, SceneMaterial *material,
                          const Point3 &point, const Point3 &velocity) { assert(0); return Point3(); }
     virtual bool hasForce(const FieldInfo *fieldInfo) { return false; }
@@ -35,15 +35,17 @@ class {{CLASS}}ErrorCalculatorNorm_{{COORDINATE_TYPE}}_{{LINEARITY_TYPE}}_{{ANAL
 {
 public:
     {{CLASS}}ErrorCalculatorNorm_{{COORDINATE_TYPE}}_{{LINEARITY_TYPE}}_{{ANALYSIS_TYPE}}_{{ID_CALCULATOR}}<Scalar>(const FieldInfo *fieldInfo, int i, int j)
-        : Hermes::Hermes2D::NormFormVol<Scalar>(i, j), m_fieldInfo(fieldInfo) {}
+        : Hermes::Hermes2D::NormFormVol<Scalar>(i, j), m_fieldInfo(fieldInfo)
+    {
+        // material values indexed by Hermes element marker
+        {{#VARIABLE_SOURCE}}
+        m_{{VARIABLE_SHORT}} = m_fieldInfo->hermesMarkerValues(QLatin1String("{{VARIABLE}}"));{{/VARIABLE_SOURCE}}
+    }
 
     virtual Scalar value(int n, double *wt, Hermes::Hermes2D::Func<Scalar> *u, Hermes::Hermes2D::Func<Scalar> *v, Hermes::Hermes2D::Geom<double> *e) const
     {
-        SceneLabel *label = Agros2D::scene()->labels->at(atoi(m_fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(e->elem_marker).marker.c_str()));
-        SceneMaterial *material = label->marker(m_fieldInfo);
-
         {{#VARIABLE_SOURCE}}
-        const Value *{{VARIABLE_SHORT}} = material->valueNakedPtr(QLatin1String("{{VARIABLE}}"));{{/VARIABLE_SOURCE}}
+        const Value *{{VARIABLE_SHORT}} = m_{{VARIABLE_SHORT}}.at(e->elem_marker);{{/VARIABLE_SOURCE}}
 
         Scalar result = Scalar(0);
         for (int i = 0; i < n; i++)
@@ -53,6 +55,9 @@ public:
     }
 
     const FieldInfo *m_fieldInfo;
+
+    {{#VARIABLE_SOURCE}}
+    QVector<const Value *> m_{{VARIABLE_SHORT}};{{/VARIABLE_SOURCE}}
 };
 
 template class {{CLASS}}ErrorCalculatorNorm_{{COORDINATE_TYPE}}_{{LINEARITY_TYPE}}_{{ANALYSIS_TYPE}}_{{ID_CALCULATOR}}<double>;
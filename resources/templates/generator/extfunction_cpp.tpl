@@ -54,12 +54,14 @@ void {{EXT_FUNCTION_NAME}}::value (int n, Hermes::Hermes2D::Func<double>** ext,
     }
     assert((labelIndex >= 0) && (labelIndex < {{QUANTITY_SHORTNAME}}.size()));
     const Value* value = {{QUANTITY_SHORTNAME}}[labelIndex].data();
-    Offset offset = this->m_wfAgros->offsetInfo(nullptr, this->m_fieldInfo);
+    const Offset &offset = this->m_offset;
 
+    // keys of all integration points, table is evaluated at once
     for(int i = 0; i < n; i++)
     {
-        result->val[i] = value->{{VALUE_METHOD}}({{DEPENDENCE}});
+        result->val[i] = {{DEPENDENCE}};
     }
+    value->{{VALUE_METHOD}}(result->val, result->val, n);
 }
 {{/EXT_FUNCTION}}
 
@@ -94,7 +96,7 @@ double {{VALUE_FUNCTION_FULL_NAME}}::getValue(int hermesMarker, double h) const
 void {{VALUE_FUNCTION_FULL_NAME}}::value (int n, Hermes::Hermes2D::Func<double>** ext, Hermes::Hermes2D::Func<double>** u_ext, Hermes::Hermes2D::Func<double>* result, Hermes::Hermes2D::Geom<double>* e) const
 {
     const int fieldID = this->m_fieldInfo->numberId();
-    Offset offset = this->m_wfAgros->offsetInfo(nullptr, this->m_fieldInfo);
+    const Offset &offset = this->m_offset;
 
     int labelIndex = m_fieldInfo->hermesMarkerToAgrosLabel(e->elem_marker);
     if(labelIndex == LABEL_OUTSIDE_FIELD)
@@ -136,7 +138,7 @@ void {{VALUE_FUNCTION_FULL_NAME}}::value (int n, Hermes::Hermes2D::Func<double>*
     m_boundHi = {{TO}};
     m_variant = "{{SELECTED_VARIANT}}";
 
-{{#PARAMETERS}}    {{PARAMETER_NAME}}_pointers = m_fieldInfo->valuePointerTable("{{PARAMETER_ID}}");
+{{#PARAMETERS}}    {{PARAMETER_NAME}}_pointers = parameterPointerTable("{{PARAMETER_ID}}");
 {{/PARAMETERS}}
     init();
 }
@@ -170,7 +172,7 @@ double {{SPECIAL_EXT_FUNCTION_FULL_NAME}}::calculateValue(int hermesMarker, doub
     void {{SPECIAL_EXT_FUNCTION_FULL_NAME}}::value (int n, Hermes::Hermes2D::Func<double>** ext, Hermes::Hermes2D::Func<double>** u_ext, Hermes::Hermes2D::Func<double>* result, Hermes::Hermes2D::Geom<double>* e) const
 {
     const int fieldID = this->m_fieldInfo->numberId();
-    Offset offset = this->m_wfAgros->offsetInfo(nullptr, this->m_fieldInfo);
+    const Offset &offset = this->m_offset;
 
     for(int i = 0; i < n; i++)
     {
@@ -48,7 +48,20 @@
     dudy = new double*[this->num];
 
     m_coordinateType = Agros2D::problem()->config()->coordinateType();
-    m_labels = Agros2D::scene()->labels;
+
+    // expression of the variable, component, analysis and coordinate type
+    m_expression = -1;
+    {{#VARIABLE_SOURCE}}
+    if ((m_variableHash == {{VARIABLE_HASH}})
+            && (m_coordinateType == {{COORDINATE_TYPE}})
+            && (m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}})
+            && (m_physicFieldVariableComp == {{PHYSICFIELDVARIABLECOMP_TYPE}}))
+        m_expression = {{EXPRESSION_INDEX}};
+    {{/VARIABLE_SOURCE}}
+
+    // material values indexed by Hermes element marker
+    {{#VARIABLE_MATERIAL}}m_material_{{MATERIAL_VARIABLE}} = m_fieldInfo->hermesMarkerValues(QLatin1String("{{MATERIAL_VARIABLE}}"));
+    {{/VARIABLE_MATERIAL}}
 }
 
 {{CLASS}}ViewScalarFilter::~{{CLASS}}ViewScalarFilter()
@@ -83,22 +96,19 @@ void {{CLASS}}ViewScalarFilter::precalculate(int order, int mask)
     double *y = this->refmap->get_phys_y(order);
     Hermes::Hermes2D::Element *e = this->refmap->get_active_element();
 
-    // set material
-    SceneMaterial *material = m_labels->at(atoi(m_fieldInfo->initialMesh()->get_element_markers_conversion().
-                                           get_user_marker(e->marker).marker.c_str()))->marker(m_fieldInfo);
-
     int elementMarker = e->marker;
 
-    {{#VARIABLE_MATERIAL}}const Value *material_{{MATERIAL_VARIABLE}} = material->valueNakedPtr(QLatin1String("{{MATERIAL_VARIABLE}}"));
+    {{#VARIABLE_MATERIAL}}const Value *material_{{MATERIAL_VARIABLE}} = m_material_{{MATERIAL_VARIABLE}}.at(elementMarker);
     {{/VARIABLE_MATERIAL}}    
+    switch (m_expression)
+    {
     {{#VARIABLE_SOURCE}}
-    if ((m_variableHash == {{VARIABLE_HASH}})
-            && (m_coordinateType == {{COORDINATE_TYPE}})
-            && (m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}})
-            && (m_physicFieldVariableComp == {{PHYSICFIELDVARIABLECOMP_TYPE}}))
+    case {{EXPRESSION_INDEX}}:
         for (int i = 0; i < np; i++)
             this->values[0][0][i] = {{EXPRESSION}};
+        break;
     {{/VARIABLE_SOURCE}}
+    }
 }
 
 {{CLASS}}ViewScalarFilter* {{CLASS}}ViewScalarFilter::clone() const
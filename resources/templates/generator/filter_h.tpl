@@ -29,8 +29,6 @@
 
 #include "{{ID}}_interface.h"
 
-class SceneLabelContainer;
-
 class {{CLASS}}ViewScalarFilter : public Hermes::Hermes2D::Filter<double>
 {
 public:
@@ -54,12 +52,16 @@ private:
     int m_adaptivityStep;
     SolutionMode m_solutionType;
 
-    SceneLabelContainer *m_labels;
+    // material values indexed by Hermes element marker
+    {{#VARIABLE_MATERIAL}}QVector<const Value *> m_material_{{MATERIAL_VARIABLE}};
+    {{/VARIABLE_MATERIAL}}
 
     QString m_variable;
     uint m_variableHash;
     PhysicFieldVariableComp m_physicFieldVariableComp;
     CoordinateType m_coordinateType;
+    // index of the expression (resolved in constructor)
+    int m_expression;
 
     {{#SPECIAL_FUNCTION_SOURCE}}
     QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}> {{SPECIAL_FUNCTION_NAME}};{{/SPECIAL_FUNCTION_SOURCE}}
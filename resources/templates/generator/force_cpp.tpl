@@ -43,14 +43,12 @@ bool hasForce{{CLASS}}(const FieldInfo *fieldInfo)
     return false;
 }
 
-Point3 force{{CLASS}}(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+// time dependent materials are not updated (evaluation from more threads), see ParticleTracing
+Point3 force{{CLASS}}(const FieldInfo *fieldInfo, int timeStep, const Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > &solutions,
                       Hermes::Hermes2D::Element *element, SceneMaterial *material, const Point3 &point, const Point3 &velocity)
 {
     int numberOfSolutions = fieldInfo->numberOfSolutions();
 
-    FieldSolutionID fsid(fieldInfo, timeStep, adaptivityStep, solutionType);
-    MultiArray<double> ma = Agros2D::solutionStore()->multiArray(fsid);
-
     {{#VARIABLE_MATERIAL}}const Value *material_{{MATERIAL_VARIABLE}} = material->valueNakedPtr(QLatin1String("{{MATERIAL_VARIABLE}}"));
     {{/VARIABLE_MATERIAL}}
 
@@ -58,13 +56,6 @@ Point3 force{{CLASS}}(const FieldInfo *fieldInfo, int timeStep, int adaptivitySt
 
     if (Agros2D::problem()->isSolved())
     {
-        // update time functions
-        if (fieldInfo->analysisType() == AnalysisType_Transient)
-        {
-            QList<double> timeLevels = Agros2D::solutionStore()->timeLevels(fieldInfo);
-            Module::updateTimeFunctions(timeLevels[timeStep]);
-        }
-
         // set variables
         double x = point.x;
         double y = point.y;
@@ -77,7 +68,7 @@ Point3 force{{CLASS}}(const FieldInfo *fieldInfo, int timeStep, int adaptivitySt
         {
             // point values
             // point values
-            Hermes::Hermes2D::Func<double> *values = ma.solutions().at(k)->get_pt_value(point.x, point.y, true, element);
+            Hermes::Hermes2D::Func<double> *values = solutions.at(k)->get_pt_value(point.x, point.y, true, element);
             if (!values)
             {
                 throw AgrosException(QObject::tr("Point [%1, %2] does not lie in any element").arg(x).arg(y));
@@ -28,7 +28,7 @@
 
 bool hasForce{{CLASS}}(const FieldInfo *fieldInfo);
 
-Point3 force{{CLASS}}(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+Point3 force{{CLASS}}(const FieldInfo *fieldInfo, int timeStep, const Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > &solutions,
                       Hermes::Hermes2D::Element *element, SceneMaterial *material, const Point3 &point, const Point3 &velocity = Point3());
 
 
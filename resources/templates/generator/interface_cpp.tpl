@@ -160,6 +160,12 @@ LocalValue *{{CLASS}}Interface::localValue(const FieldInfo *fieldInfo, int timeS
     return new {{CLASS}}LocalValue(fieldInfo, timeStep, adaptivityStep, solutionType, point);
 }
 
+LocalValues *{{CLASS}}Interface::localValues(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                                             const QVector<Point> &points, const QStringList &variables)
+{
+    return new {{CLASS}}LocalValues(fieldInfo, timeStep, adaptivityStep, solutionType, points, variables);
+}
+
 IntegralValue *{{CLASS}}Interface::surfaceIntegral(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType)
 {
     return new {{CLASS}}SurfaceIntegral(fieldInfo, timeStep, adaptivityStep, solutionType);
@@ -170,11 +176,11 @@ IntegralValue *{{CLASS}}Interface::volumeIntegral(const FieldInfo *fieldInfo, in
     return new {{CLASS}}VolumeIntegral(fieldInfo, timeStep, adaptivityStep, solutionType);
 }
 
-Point3 {{CLASS}}Interface::force(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+Point3 {{CLASS}}Interface::force(const FieldInfo *fieldInfo, int timeStep, const Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > &solutions,
                                  Hermes::Hermes2D::Element *element, SceneMaterial *material,
                                  const Point3 &point, const Point3 &velocity)
 {
-    return force{{CLASS}}(fieldInfo, timeStep, adaptivityStep, solutionType, element, material, point, velocity);
+    return force{{CLASS}}(fieldInfo, timeStep, solutions, element, material, point, velocity);
 }
 
 bool {{CLASS}}Interface::hasForce(const FieldInfo *fieldInfo)
@@ -29,6 +29,7 @@
 #include "hermes2d/problem_config.h"
 #include "hermes2d/field.h"
 #include "hermes2d/solutionstore.h"
+#include "hermes2d/element_locator.h"
 
 #include "hermes2d/plugin_interface.h"
 
@@ -63,8 +64,9 @@ void {{CLASS}}LocalValue::calculate()
         double x = m_point.x;
         double y = m_point.y;
 
-        Hermes::Hermes2D::Element *e = Hermes::Hermes2D::RefMap::element_on_physical_coordinates(false, m_fieldInfo->initialMesh(),
-                                                                                                 m_point.x, m_point.y);
+        // locator is not available without initial mesh (no value)
+        QSharedPointer<ElementLocator> initialMeshLocator = m_fieldInfo->initialMeshLocator();
+        Hermes::Hermes2D::Element *e = initialMeshLocator.isNull() ? NULL : initialMeshLocator->element(m_point.x, m_point.y);
         if (e)
         {
             // find marker
@@ -97,8 +99,11 @@ void {{CLASS}}LocalValue::calculate()
                 }
                 else
                 {
-                    // point values
-                    Hermes::Hermes2D::Func<double> *values = ma.solutions().at(k)->get_pt_value(m_point.x, m_point.y, true);
+                    // point values (element is known on the initial mesh)
+                    Hermes::Hermes2D::MeshFunctionSharedPtr<double> solution = ma.solutions().at(k);
+                    Hermes::Hermes2D::Func<double> *values = (solution->get_mesh().get() == m_fieldInfo->initialMesh().get())
+                            ? solution->get_pt_value(m_point.x, m_point.y, false, e)
+                            : solution->get_pt_value(m_point.x, m_point.y, true);
 
                     // set variables
                     value[k] = values->val[0];
@@ -124,3 +129,163 @@ void {{CLASS}}LocalValue::calculate()
         }
     }
 }
+
+{{CLASS}}LocalValues::{{CLASS}}LocalValues(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                                           const QVector<Point> &points, const QStringList &variables)
+    : LocalValues(fieldInfo, timeStep, adaptivityStep, solutionType, points, variables)
+{
+    calculate();
+}
+
+void {{CLASS}}LocalValues::calculate()
+{
+    int numberOfSolutions = m_fieldInfo->numberOfSolutions();
+    int numberOfPoints = m_points.size();
+
+    m_values.clear();
+    m_found.fill(false, numberOfPoints);
+
+    FieldSolutionID fsid(m_fieldInfo, m_timeStep, m_adaptivityStep, m_solutionType);
+    // check existence
+    if (!Agros2D::solutionStore()->contains(fsid))
+        return;
+
+    MultiArray<double> ma = Agros2D::solutionStore()->multiArray(fsid);
+
+    // update time functions
+    if (!Agros2D::problem()->isSolving() && m_fieldInfo->analysisType() == AnalysisType_Transient)
+    {
+       Module::updateTimeFunctions(Agros2D::problem()->timeStepToTotalTime(m_timeStep));
+    }
+
+    if (!Agros2D::problem()->isSolved())
+        return;
+
+    // elements of the initial mesh (markers), points are evaluated grouped by elements
+    QVector<int> elementMarkers(numberOfPoints, -1);
+    QVector<QPair<int, int> > order;
+    order.reserve(numberOfPoints);
+
+    // walks the mesh along ordered points (chart lines), without initial mesh no point is found
+    QSharedPointer<ElementLocator> initialMeshLocator = m_fieldInfo->initialMeshLocator();
+    if (initialMeshLocator.isNull())
+        return;
+
+    QVector<Hermes::Hermes2D::Element *> initialElements = initialMeshLocator->elements(m_points);
+    for (int p = 0; p < numberOfPoints; p++)
+    {
+        Hermes::Hermes2D::Element *e = initialElements[p];
+        if (e)
+        {
+            m_found.setBit(p);
+            elementMarkers[p] = e->marker;
+            order.append(QPair<int, int>(e->id, p));
+        }
+    }
+    qSort(order);
+
+    // solution values (solutions with the same mesh share the locator, elements of the initial mesh
+    // are used directly, few points are located by Hermes)
+    QVector<double> pointValues(numberOfPoints * numberOfSolutions, 0.0);
+    QVector<double> pointDudx(numberOfPoints * numberOfSolutions, 0.0);
+    QVector<double> pointDudy(numberOfPoints * numberOfSolutions, 0.0);
+
+    QList<QSharedPointer<ElementLocator> > locators;
+    for (int k = 0; k < numberOfSolutions; k++)
+    {
+        if ((m_fieldInfo->analysisType() == AnalysisType_Transient) && m_timeStep == 0)
+        {
+            double initialCondition = m_fieldInfo->value(FieldInfo::TransientInitialCondition).toDouble();
+            for (int i = 0; i < order.size(); i++)
+                pointValues[order[i].second * numberOfSolutions + k] = initialCondition;
+
+            continue;
+        }
+
+        Hermes::Hermes2D::MeshFunctionSharedPtr<double> solution = ma.solutions().at(k);
+        bool isInitialMesh = (solution->get_mesh().get() == m_fieldInfo->initialMesh().get());
+
+        QSharedPointer<ElementLocator> locator;
+        if (!isInitialMesh && order.size() >= LOCAL_VALUES_MIN_POINTS_LOCATOR)
+        {
+            foreach (QSharedPointer<ElementLocator> solutionLocator, locators)
+                if (solutionLocator->mesh().get() == solution->get_mesh().get())
+                    locator = solutionLocator;
+
+            if (locator.isNull())
+            {
+                locator = QSharedPointer<ElementLocator>(new ElementLocator(solution->get_mesh(), m_fieldInfo->minimalArcRadius()));
+                locators.append(locator);
+            }
+        }
+
+        Hermes::Hermes2D::Element *hint = NULL;
+        for (int i = 0; i < order.size(); i++)
+        {
+            int p = order[i].second;
+
+            Hermes::Hermes2D::Element *e = NULL;
+            if (isInitialMesh)
+                e = initialElements[p];
+            else if (!locator.isNull())
+                e = locator->element(m_points[p].x, m_points[p].y, hint);
+
+            Hermes::Hermes2D::Func<double> *values = e ? solution->get_pt_value(m_points[p].x, m_points[p].y, false, e)
+                                                       : solution->get_pt_value(m_points[p].x, m_points[p].y, true);
+            if (e)
+                hint = e;
+            if (!values)
+                continue;
+
+            pointValues[p * numberOfSolutions + k] = values->val[0];
+            pointDudx[p * numberOfSolutions + k] = values->dx[0];
+            pointDudy[p * numberOfSolutions + k] = values->dy[0];
+
+            delete values;
+        }
+    }
+
+    // materials indexed by Hermes element marker
+    QVector<SceneMaterial *> materials = m_fieldInfo->hermesMarkerMaterials();
+    {{#VARIABLE_MATERIAL}}QVector<const Value *> materialTable_{{MATERIAL_VARIABLE}} = m_fieldInfo->hermesMarkerValues(QLatin1String("{{MATERIAL_VARIABLE}}"));
+    {{/VARIABLE_MATERIAL}}
+    {{#SPECIAL_FUNCTION_SOURCE}}
+    QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}> {{SPECIAL_FUNCTION_NAME}};
+    if(m_fieldInfo->functionUsedInAnalysis("{{SPECIAL_FUNCTION_ID}}"))
+        {{SPECIAL_FUNCTION_NAME}} = QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}>(new {{SPECIAL_EXT_FUNCTION_FULL_NAME}}(m_fieldInfo, 0));
+    {{/SPECIAL_FUNCTION_SOURCE}}
+
+    double *pointValuesData = pointValues.data();
+    double *pointDudxData = pointDudx.data();
+    double *pointDudyData = pointDudy.data();
+
+    // expressions
+    {{#VARIABLE_SOURCE}}
+    if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}})
+            && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}})
+            && isRequested(QLatin1String("{{VARIABLE}}")))
+    {
+        QVector<LocalPointValue> &result = m_values[QLatin1String("{{VARIABLE}}")];
+        result.resize(numberOfPoints);
+
+        for (int i = 0; i < order.size(); i++)
+        {
+            int p = order[i].second;
+
+            double x = m_points[p].x;
+            double y = m_points[p].y;
+
+            int elementMarker = elementMarkers[p];
+            SceneMaterial *material = materials[elementMarker];
+
+            {{#VARIABLE_MATERIAL}}const Value *material_{{MATERIAL_VARIABLE}} = materialTable_{{MATERIAL_VARIABLE}}[elementMarker];
+            {{/VARIABLE_MATERIAL}}
+            double *value = pointValuesData + p * numberOfSolutions;
+            double *dudx = pointDudxData + p * numberOfSolutions;
+            double *dudy = pointDudyData + p * numberOfSolutions;
+
+            result[p] = LocalPointValue({{EXPRESSION_SCALAR}}, Point({{EXPRESSION_VECTORX}}, {{EXPRESSION_VECTORY}}), material);
+        }
+    }
+    {{/VARIABLE_SOURCE}}
+}
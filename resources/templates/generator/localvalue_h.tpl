@@ -38,4 +38,13 @@ public:
     void calculate();
 };
 
+class {{CLASS}}LocalValues : public LocalValues
+{
+public:
+    {{CLASS}}LocalValues(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                         const QVector<Point> &points, const QStringList &variables);
+
+    void calculate();
+};
+
 #endif // {{ID}}_LOCALVALUE_H
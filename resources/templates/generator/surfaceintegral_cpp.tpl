@@ -38,27 +38,29 @@ public:
     {{CLASS}}SurfaceIntegralCalculator(const FieldInfo *fieldInfo, Hermes::Hermes2D::MeshFunctionSharedPtr<double> source_function, int number_of_integrals)
         : Hermes::Hermes2D::PostProcessing::SurfaceIntegralCalculator<double>(source_function, number_of_integrals), m_fieldInfo(fieldInfo)
     {
+        resolveMaterialValues();
+        resolvePart();
     }
 
     {{CLASS}}SurfaceIntegralCalculator(const FieldInfo *fieldInfo, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > source_functions, int number_of_integrals)
         : Hermes::Hermes2D::PostProcessing::SurfaceIntegralCalculator<double>(source_functions, number_of_integrals), m_fieldInfo(fieldInfo)
     {
+        resolveMaterialValues();
+        resolvePart();
     }
 
     virtual void integral(int n, double* wt, Hermes::Hermes2D::Func<double> **fns, Hermes::Hermes2D::Geom<double> *e, double* result)
     {
-        SceneLabel *label = Agros2D::scene()->labels->at(atoi(m_fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(e->elem_marker).marker.c_str()));
-        SceneMaterial *material = label->marker(m_fieldInfo);
-
         double *x = e->x;
         double *y = e->y;
 
-        {{#VARIABLE_MATERIAL}}const Value *material_{{MATERIAL_VARIABLE}} = material->valueNakedPtr(QLatin1String("{{MATERIAL_VARIABLE}}"));
+        {{#VARIABLE_MATERIAL}}const Value *material_{{MATERIAL_VARIABLE}} = m_material_{{MATERIAL_VARIABLE}}.at(e->elem_marker);
         {{/VARIABLE_MATERIAL}}
 
-        double **value = new double*[source_functions.size()];
-        double **dudx = new double*[source_functions.size()];
-        double **dudy = new double*[source_functions.size()];
+        // solution values on the stack (integral is evaluated per element)
+        QVarLengthArray<double *, 8> value(source_functions.size());
+        QVarLengthArray<double *, 8> dudx(source_functions.size());
+        QVarLengthArray<double *, 8> dudy(source_functions.size());
 
         for (int i = 0; i < source_functions.size(); i++)
         {
@@ -67,31 +69,59 @@ public:
             dudy[i] = fns[i]->dy;
         }
 
-        // expressions
-        {{#VARIABLE_SOURCE}}
-        if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
+        // expressions of the analysis and coordinate type (part is resolved in constructor)
+        switch (m_part)
         {
+        {{#VARIABLE_SOURCE_PART}}
+        case {{PART_INDEX}}:
+            {{#PART_EXPRESSION}}
             for (int i = 0; i < n; i++)
                 result[{{POSITION}}] += wt[i] * ({{EXPRESSION}});
+            {{/PART_EXPRESSION}}
+            break;
+        {{/VARIABLE_SOURCE_PART}}
         }
-        {{/VARIABLE_SOURCE}}
-
-        delete [] value;
-        delete [] dudx;
-        delete [] dudy;
     }
 
     virtual void order(Hermes::Hermes2D::Func<Hermes::Ord> **fns, Hermes::Ord* result)
     {
-        {{#VARIABLE_SOURCE}}
-        if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
+        switch (m_part)
+        {
+        {{#VARIABLE_SOURCE_PART}}
+        case {{PART_INDEX}}:
+            {{#PART_EXPRESSION}}
             result[{{POSITION}}] = Hermes::Ord(20);
-        {{/VARIABLE_SOURCE}}
+            {{/PART_EXPRESSION}}
+            break;
+        {{/VARIABLE_SOURCE_PART}}
+        }
     }
 
 private:
     // field info
     const FieldInfo *m_fieldInfo;
+
+    // material values indexed by Hermes element marker
+    {{#VARIABLE_MATERIAL}}QVector<const Value *> m_material_{{MATERIAL_VARIABLE}};
+    {{/VARIABLE_MATERIAL}}
+
+    void resolveMaterialValues()
+    {
+        {{#VARIABLE_MATERIAL}}m_material_{{MATERIAL_VARIABLE}} = m_fieldInfo->hermesMarkerValues(QLatin1String("{{MATERIAL_VARIABLE}}"));
+        {{/VARIABLE_MATERIAL}}
+    }
+
+    // part of expressions for the analysis and coordinate type of the problem
+    int m_part;
+
+    void resolvePart()
+    {
+        m_part = -1;
+        {{#VARIABLE_SOURCE_PART}}
+        if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
+            m_part = {{PART_INDEX}};
+        {{/VARIABLE_SOURCE_PART}}
+    }
 };
 
 {{CLASS}}SurfaceIntegral::{{CLASS}}SurfaceIntegral(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType)
@@ -50,7 +50,7 @@ Scalar {{FUNCTION_NAME}}<Scalar>::value(int n, double *wt, Hermes::Hermes2D::Fun
                                           Hermes::Hermes2D::Func<double> *v, Hermes::Hermes2D::Geom<double> *e, Hermes::Hermes2D::Func<Scalar> **ext) const
 {
     Scalar result = 0;
-    Offset offset = this->m_wfAgros->offsetInfo(this->m_markerSource, this->m_markerTarget);
+    const Offset &offset = this->m_offset;
     for (int i = 0; i < n; i++)
     {
         result += wt[i] * ({{EXPRESSION}});
@@ -63,7 +63,7 @@ Hermes::Ord {{FUNCTION_NAME}}<Scalar>::ord(int n, double *wt, Hermes::Hermes2D::
                                              Hermes::Hermes2D::Func<Hermes::Ord> *v, Hermes::Hermes2D::Geom<Hermes::Ord> *e, Hermes::Hermes2D::Func<Hermes::Ord> **ext) const
 {
     Hermes::Ord result(0);
-    Offset offset = this->m_wfAgros->offsetInfo(this->m_markerSource, this->m_markerTarget);
+    const Offset &offset = this->m_offset;
     for (int i = 0; i < n; i++)
     {
        result += wt[i] * ({{EXPRESSION}});
@@ -94,7 +94,7 @@ Scalar {{FUNCTION_NAME}}<Scalar>::value(int n, double *wt, Hermes::Hermes2D::Fun
                                           Hermes::Hermes2D::Geom<double> *e, Hermes::Hermes2D::Func<Scalar> **ext) const
 {
     Scalar result = 0;
-    Offset offset = this->m_wfAgros->offsetInfo(this->m_markerSource, this->m_markerTarget);
+    const Offset &offset = this->m_offset;
     for (int i = 0; i < n; i++)
     {
         result += wt[i] * ({{EXPRESSION}});
@@ -107,7 +107,7 @@ Hermes::Ord {{FUNCTION_NAME}}<Scalar>::ord(int n, double *wt, Hermes::Hermes2D::
                                              Hermes::Hermes2D::Geom<Hermes::Ord> *e, Hermes::Hermes2D::Func<Hermes::Ord> **ext) const
 {
     Hermes::Ord result(0);
-    Offset offset = this->m_wfAgros->offsetInfo(this->m_markerSource, this->m_markerTarget);
+    const Offset &offset = this->m_offset;
     for (int i = 0; i < n; i++)
     {
        result += wt[i] * ({{EXPRESSION}});
@@ -139,7 +139,7 @@ Scalar {{FUNCTION_NAME}}<Scalar>::value(int n, double *wt, Hermes::Hermes2D::Fun
                                            Hermes::Hermes2D::Geom<double> *e, Hermes::Hermes2D::Func<Scalar> **ext) const
 {
     Scalar result = 0;
-    Offset offset = this->m_wfAgros->offsetInfo(this->m_markerSource, this->m_markerTarget);
+    const Offset &offset = this->m_offset;
     for (int i = 0; i < n; i++)
     {
         result += wt[i] * ({{EXPRESSION}});
@@ -152,7 +152,7 @@ Hermes::Ord {{FUNCTION_NAME}}<Scalar>::ord(int n, double *wt, Hermes::Hermes2D::
                                               Hermes::Hermes2D::Geom<Hermes::Ord> *e, Hermes::Hermes2D::Func<Hermes::Ord> **ext) const
 {
     Hermes::Ord result(0);
-    Offset offset = this->m_wfAgros->offsetInfo(this->m_markerSource, this->m_markerTarget);
+    const Offset &offset = this->m_offset;
     for (int i = 0; i < n; i++)
     {
        result += wt[i] * ({{EXPRESSION}});
@@ -193,7 +193,7 @@ Scalar {{FUNCTION_NAME}}<Scalar>::value(int n, double *wt, Hermes::Hermes2D::Fun
                                            Hermes::Hermes2D::Geom<double> *e, Hermes::Hermes2D::Func<Scalar> **ext) const
 {
     Scalar result = 0;
-    Offset offset = this->m_wfAgros->offsetInfo(this->m_markerSource, this->m_markerTarget);
+    const Offset &offset = this->m_offset;
     for (int i = 0; i < n; i++)
     {
         result += wt[i] * ({{EXPRESSION}});
@@ -206,7 +206,7 @@ Hermes::Ord {{FUNCTION_NAME}}<Scalar>::ord(int n, double *wt, Hermes::Hermes2D::
                                               Hermes::Hermes2D::Geom<Hermes::Ord> *e, Hermes::Hermes2D::Func<Hermes::Ord> **ext) const
 {
     Hermes::Ord result(0);
-    Offset offset = this->m_wfAgros->offsetInfo(this->m_markerSource, this->m_markerTarget);
+    const Offset &offset = this->m_offset;
     for (int i = 0; i < n; i++)
     {
        result += wt[i] * ({{EXPRESSION}});
@@ -65,10 +65,13 @@ test_adaptivity = get_tests(adaptivity.adaptivity)
 
 """ fields """
 test_tracing = get_tests(particle_tracing.particle_tracing)
+test_tracing += [particle_tracing.multiparticle_tracing.TestMultiParticleTracingOpeningAngle,
+                 particle_tracing.multiparticle_tracing.TestMultiParticleTracingAxisymmetric]
 
 """ script """
 test_script = get_tests([script.problem, script.field, script.geometry,
-                         script.benchmark, script.script])
+                         script.benchmark, script.script, script.datatable,
+                         script.expression])
 
 """ examples """
 test_examples = examples.examples.tests
@@ -76,6 +79,8 @@ test_examples = examples.examples.tests
 """ core """
 test_core = get_tests(core.matrix_solvers)
 test_core += get_tests(core.generator)
+test_core += get_tests(core.solution_store)
+test_core += get_tests(core.weak_form)
 test_core += core.xslt.tests
 
 """ complete """
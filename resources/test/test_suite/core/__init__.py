@@ -1,5 +1,7 @@
-__all__ = ["matrix_solvers", "xslt", "generator"]
+__all__ = ["matrix_solvers", "xslt", "generator", "solution_store", "weak_form"]
 
 import matrix_solvers
 import xslt
-import generator
\ No newline at end of file
+import generator
+import solution_store
+import weak_form
\ No newline at end of file
@@ -0,0 +1,277 @@
+import agros2d as a2d
+import pythonlab
+
+import os
+import re
+import zipfile
+
+from test_suite.scenario import Agros2DTestCase
+from test_suite.scenario import Agros2DTestResult
+
+def transient_problem(adaptivity = True, time_skip = 0.0):
+    problem = a2d.problem(clear = True)
+    problem.coordinate_type = "planar"
+    problem.mesh_type = "triangle"
+    problem.time_step_method = "fixed"
+    problem.time_method_order = 2
+    problem.time_total = 10
+    problem.time_steps = 10
+
+    heat = a2d.field("heat")
+    heat.analysis_type = "transient"
+    heat.transient_initial_condition = 293.15
+    heat.number_of_refinements = 0
+    heat.polynomial_order = 1
+    heat.solver = "linear"
+    heat.transient_time_skip = time_skip
+    if adaptivity:
+        heat.adaptivity_type = "hp-adaptivity"
+        heat.adaptivity_parameters['steps'] = 3
+        heat.adaptivity_parameters['tolerance'] = 1
+
+    heat.add_boundary("Neumann", "heat_heat_flux", {"heat_heat_flux" : 0})
+    heat.add_boundary("Dirichlet", "heat_temperature", {"heat_temperature" : { "expression" : "293.15 + 10*time" }})
+
+    heat.add_material("Material", {"heat_conductivity" : 237, "heat_volume_heat" : 0, "heat_density" : 2700, "heat_specific_heat" : 896})
+
+    geometry = a2d.geometry
+    geometry.add_edge(0.25, 0, 0, 0.25, angle = 90, boundaries = {"heat" : "Neumann"})
+    geometry.add_edge(0, 0.25, -0.25, 0, angle = 90, boundaries = {"heat" : "Neumann"})
+    geometry.add_edge(-0.25, 0, 0, -0.25, angle = 90, boundaries = {"heat" : "Neumann"})
+    geometry.add_edge(0, -0.25, 0.25, 0, angle = 90, boundaries = {"heat" : "Neumann"})
+    geometry.add_edge(0.05, 0, 0, 0.05, boundaries = {"heat" : "Dirichlet"})
+    geometry.add_edge(0, 0.05, -0.05, 0, boundaries = {"heat" : "Dirichlet"})
+    geometry.add_edge(-0.05, 0, 0, -0.05, boundaries = {"heat" : "Dirichlet"})
+    geometry.add_edge(0, -0.05, 0.05, 0, boundaries = {"heat" : "Dirichlet"})
+
+    geometry.add_label(0, 0, materials = {"heat" : "none"})
+    geometry.add_label(0.15, 0, materials = {"heat" : "Material"})
+
+    a2d.view.mesh.disable()
+    a2d.view.post2d.disable()
+
+    return problem, heat
+
+def solution_values(problem, heat):
+    # temperature and dofs of all time and adaptivity steps
+    values = []
+    for time_step in range(problem.time_steps + 1):
+        dofs = heat.adaptivity_info(time_step = time_step)['dofs']
+        for adaptivity_step in range(len(dofs)):
+            point = heat.local_values(0.1, 0.05, time_step = time_step, adaptivity_step = adaptivity_step)
+            mesh = heat.solution_mesh_info(time_step = time_step, adaptivity_step = adaptivity_step)
+            values.append((time_step, adaptivity_step, mesh['dofs'], point['T']))
+
+    return values
+
+def solution_file(filename):
+    return '{0}/{1}.sol'.format(os.path.dirname(filename), os.path.splitext(os.path.basename(filename))[0])
+
+def read_from_solution_file(filename, name):
+    archive = zipfile.ZipFile(solution_file(filename), 'r')
+    content = None
+    for item in archive.infolist():
+        if os.path.basename(item.filename) == name:
+            content = archive.read(item.filename)
+    archive.close()
+
+    return content
+
+def rewrite_solution_file(filename, name, content = None):
+    # content None removes file from the archive
+    fn = solution_file(filename)
+    fn_temp = fn + '.tmp'
+
+    archive = zipfile.ZipFile(fn, 'r')
+    archive_temp = zipfile.ZipFile(fn_temp, 'w', zipfile.ZIP_DEFLATED)
+    for item in archive.infolist():
+        if os.path.basename(item.filename) == name:
+            if content is not None:
+                archive_temp.writestr(item, content)
+        else:
+            archive_temp.writestr(item, archive.read(item.filename))
+    archive.close()
+    archive_temp.close()
+
+    os.remove(fn)
+    os.rename(fn_temp, fn)
+
+class TestSolutionStoreCache(Agros2DTestCase):
+    def setUp(self):
+        self.cache_size = a2d.options.cache_size
+
+    def tearDown(self):
+        a2d.options.cache_size = self.cache_size
+
+    def test_cache_memory_size(self):
+        # reference solution with default memory budget
+        problem, heat = transient_problem()
+        problem.solve()
+        reference = solution_values(problem, heat)
+
+        # solution with least recently used solutions evicted immediately
+        a2d.options.cache_size = 0
+        problem, heat = transient_problem()
+        problem.solve()
+        values = solution_values(problem, heat)
+
+        self.assertEqual(len(values), len(reference))
+        for (value, normal) in zip(values, reference):
+            self.assertEqual(value[0:3], normal[0:3])
+            self.value_test("Temperature (time step {0}, adaptivity step {1})".format(value[0], value[1]), value[3], normal[3], 1e-10)
+
+class TestSolutionStoreIndex(Agros2DTestCase):
+    def test_time_skip(self):
+        problem, heat = transient_problem(adaptivity = False, time_skip = 2.5)
+        problem.solve()
+
+        time_steps = heat.calculated_time_steps()
+        self.assertEqual(time_steps, sorted(set(time_steps)))
+        self.assertEqual(time_steps[0], 0)
+        self.assertTrue(len(time_steps) < problem.time_steps + 1)
+
+        # brute force
+        for time_step in range(problem.time_steps + 1):
+            nearest = max([step for step in time_steps if step <= time_step])
+            self.assertEqual(heat.nearest_calculated_time_step(time_step), nearest)
+
+        # last time step
+        self.assertEqual(heat.nearest_calculated_time_step(), time_steps[-1])
+        self.assertEqual(heat.local_values(0.1, 0.05)['T'], heat.local_values(0.1, 0.05, time_step = time_steps[-1])['T'])
+
+    def test_adaptive_steps(self):
+        problem, heat = transient_problem()
+        problem.solve()
+
+        time_steps = heat.calculated_time_steps()
+        self.assertEqual(time_steps, range(problem.time_steps + 1))
+
+        for time_step in time_steps:
+            self.assertEqual(heat.nearest_calculated_time_step(time_step), time_step)
+
+            # last adaptive step is used by default
+            adaptivity_steps = len(heat.adaptivity_info(time_step = time_step)['dofs'])
+            self.assertTrue(adaptivity_steps >= 1)
+            self.assertEqual(heat.local_values(0.1, 0.05, time_step = time_step)['T'],
+                             heat.local_values(0.1, 0.05, time_step = time_step, adaptivity_step = adaptivity_steps - 1)['T'])
+            self.assertEqual(heat.solution_mesh_info(time_step = time_step)['dofs'],
+                             heat.adaptivity_info(time_step = time_step)['dofs'][-1])
+
+class TestSolutionStoreFile(Agros2DTestCase):
+    def setUp(self):
+        self.problem, self.heat = transient_problem()
+        self.problem.solve()
+
+        self.reference = solution_values(self.problem, self.heat)
+        self.time_steps = self.heat.calculated_time_steps()
+        self.adaptivity_info = [self.heat.adaptivity_info(time_step = time_step) for time_step in self.time_steps]
+
+        # solution files are written in background and flushed before save
+        self.filename = '{0}/solution_store.a2d'.format(os.path.dirname(pythonlab.tempname()))
+        a2d.save_file(self.filename, True)
+
+    def open_file(self):
+        a2d.open_file(self.filename, True)
+
+        self.problem = a2d.problem()
+        self.heat = a2d.field("heat")
+
+    def compare(self):
+        values = solution_values(self.problem, self.heat)
+
+        self.assertEqual(len(values), len(self.reference))
+        for (value, normal) in zip(values, self.reference):
+            self.assertEqual(value[0:3], normal[0:3])
+            self.value_test("Temperature (time step {0}, adaptivity step {1})".format(value[0], value[1]), value[3], normal[3], 1e-10)
+
+        self.assertEqual(self.heat.calculated_time_steps(), self.time_steps)
+        for time_step in self.time_steps:
+            info = self.heat.adaptivity_info(time_step = time_step)
+            self.assertEqual(info['dofs'], self.adaptivity_info[time_step]['dofs'])
+            for (error, normal) in zip(info['error'], self.adaptivity_info[time_step]['error']):
+                self.assertAlmostEqual(error, normal, 12)
+
+    def journal_records(self):
+        journal = read_from_solution_file(self.filename, 'runtime.journal')
+        self.assertTrue(journal is not None)
+
+        return [line.split('\t') for line in journal.splitlines() if line]
+
+    def test_save_and_reload(self):
+        self.open_file()
+        self.compare()
+
+    def test_journal_compaction(self):
+        # saved journal contains one record per stored solution (same as runtime.xml)
+        records = self.journal_records()
+        ids = [tuple(record[1:5]) for record in records]
+
+        xml = read_from_solution_file(self.filename, 'runtime.xml')
+        self.assertTrue(xml is not None)
+
+        self.assertTrue(all([record[0] == 'A' for record in records]))
+        self.assertEqual(len(ids), len(set(ids)))
+        self.assertEqual(len(ids), len(re.findall(r'<(\w+:)?element_data[ >]', xml)))
+
+    def test_fallback_to_runtime_xml(self):
+        ids = [tuple(record[1:5]) for record in self.journal_records()]
+
+        # file saved without journal (previous versions)
+        rewrite_solution_file(self.filename, 'runtime.journal')
+        self.assertTrue(read_from_solution_file(self.filename, 'runtime.journal') is None)
+
+        self.open_file()
+        self.compare()
+
+        # journal is created from runtime.xml
+        a2d.save_file(self.filename, True)
+        self.assertEqual(sorted([tuple(record[1:5]) for record in self.journal_records()]), sorted(ids))
+
+        self.open_file()
+        self.compare()
+
+    def test_journal_replay(self):
+        records = self.journal_records()
+        last_time_step = self.time_steps[-1]
+
+        journal = ['\t'.join(record) for record in records]
+
+        # later record replaces the previous one
+        for record in records:
+            if (record[2:5] == ['1', '0', 'normal']):
+                replaced = list(record)
+                replaced[7] = '12345'
+                journal.append('\t'.join(replaced))
+
+        # removal of the last time step
+        for record in records:
+            if (int(record[2]) == last_time_step):
+                journal.append('\t'.join(['R'] + record[1:5]))
+
+        # unfinished record (interrupted write)
+        journal.append('A\theat\t1')
+
+        rewrite_solution_file(self.filename, 'runtime.journal', '\n'.join(journal) + '\n')
+        self.open_file()
+
+        self.assertEqual(self.heat.calculated_time_steps(), self.time_steps[:-1])
+        self.assertEqual(self.heat.nearest_calculated_time_step(), self.time_steps[-2])
+        self.assertEqual(self.heat.adaptivity_info(time_step = 1)['dofs'][0], 12345)
+
+        # solutions of other time steps are not changed
+        for (time_step, adaptivity_step, dofs, temperature) in self.reference:
+            if (time_step == last_time_step):
+                continue
+
+            point = self.heat.local_values(0.1, 0.05, time_step = time_step, adaptivity_step = adaptivity_step)
+            self.value_test("Temperature (time step {0}, adaptivity step {1})".format(time_step, adaptivity_step), point['T'], temperature, 1e-10)
+
+if __name__ == '__main__':
+    import unittest as ut
+
+    suite = ut.TestSuite()
+    result = Agros2DTestResult()
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestSolutionStoreCache))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestSolutionStoreIndex))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestSolutionStoreFile))
+    suite.run(result)
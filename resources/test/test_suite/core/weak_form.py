@@ -0,0 +1,108 @@
+import agros2d as a2d
+
+from test_suite.scenario import Agros2DTestCase
+from test_suite.scenario import Agros2DTestResult
+
+# van Genuchten parameters
+ks = 1.0
+a = 0.1
+n = 2.0
+m = 0.5
+
+# samples of tabulated special functions (richards.xml)
+bound_low = -40.0
+bound_hi = -1e-9
+count = 100
+
+points_x = [0.5, 0.5, 0.25, 0.75, 0.5]
+points_y = [0.5, 1.5, 2.5, 3.5, 4.5]
+
+def hydraulic_conductivity(h):
+    return ks * (1 + (-a*h)**n)**(-m/2) * (1 - (-a*h)**(m*n) * (1 + (-a*h)**n)**(-m))**2
+
+def richards_problem(analysis_type, pressure_head):
+    problem = a2d.problem(clear = True)
+    problem.coordinate_type = "planar"
+    problem.mesh_type = "triangle"
+    problem.time_step_method = "fixed"
+    problem.time_method_order = 2
+    problem.time_total = 1
+    problem.time_steps = 4
+
+    richards = a2d.field("richards")
+    richards.analysis_type = analysis_type
+    richards.transient_initial_condition = -5
+    richards.number_of_refinements = 2
+    richards.polynomial_order = 2
+    richards.adaptivity_type = "disabled"
+    richards.solver = "newton"
+    richards.solver_parameters['relative_change_of_solutions'] = 1e-6
+
+    richards.add_boundary("Top", "richards_pressure_head", {"richards_pressure_head" : pressure_head})
+    richards.add_boundary("Bottom", "richards_pressure_head", {"richards_pressure_head" : -1})
+    richards.add_boundary("Sides", "richards_darcy_velocity", {"richards_darcy_velocity" : 0})
+
+    # no specific moisture capacity (theta_s = theta_r, zero storativity), every time step is a steady state
+    richards.add_material("Soil", {"richards_ks" : ks, "richards_a" : a, "richards_n" : n, "richards_m" : m,
+                                   "richards_storativity" : 0, "richards_theta_s" : 0.4, "richards_theta_r" : 0.4})
+
+    geometry = a2d.geometry
+    geometry.add_edge(0, 0, 1, 0, boundaries = {"richards" : "Bottom"})
+    geometry.add_edge(1, 0, 1, 5, boundaries = {"richards" : "Sides"})
+    geometry.add_edge(1, 5, 0, 5, boundaries = {"richards" : "Top"})
+    geometry.add_edge(0, 5, 0, 0, boundaries = {"richards" : "Sides"})
+    geometry.add_label(0.5, 2.5, materials = {"richards" : "Soil"})
+
+    a2d.view.mesh.disable()
+    a2d.view.post2d.disable()
+
+    return problem, richards
+
+class TestWeakFormTransientNonlinear(Agros2DTestCase):
+    def setUp(self):
+        # pressure head on the top rises in time
+        self.problem, self.richards = richards_problem("transient", { "expression" : "-10 + 5*time" })
+        self.problem.solve()
+
+        self.times = self.problem.time_steps_total()
+
+    def test_reused_ext_functions(self):
+        # ext functions are kept for all time steps and Newton iterations
+        transient = []
+        for time_step in range(1, len(self.times)):
+            transient.append(self.richards.local_values(points_x, points_y, time_step = time_step))
+
+        # steady state problems with new ext functions
+        for time_step in range(1, len(self.times)):
+            problem, richards = richards_problem("steadystate", -10 + 5*self.times[time_step])
+            problem.solve()
+
+            steady = richards.local_values(points_x, points_y)
+            for i in range(len(points_x)):
+                self.value_test("Pressure head (time step {0})".format(time_step),
+                                transient[time_step - 1]['h'][i], steady['h'][i], 1e-4)
+                self.value_test("Hydraulic conductivity (time step {0})".format(time_step),
+                                transient[time_step - 1]['K'][i], steady['K'][i], 1e-4)
+
+    def test_special_function_table(self):
+        # previous lookup (piecewise linear data table of the samples)
+        step = (bound_hi - bound_low) / (count - 1)
+        keys = [bound_low + i * step for i in range(count)]
+        table = a2d.data_table(keys, [hydraulic_conductivity(key) for key in keys],
+                               interpolation = "piecewise_linear")
+
+        for time_step in range(1, len(self.times)):
+            values = self.richards.local_values(points_x, points_y, time_step = time_step)
+            for i in range(len(points_x)):
+                h = values['h'][i]
+                self.assertTrue(bound_low < h < bound_hi)
+                self.value_test("Hydraulic conductivity (time step {0})".format(time_step),
+                                values['K'][i], table.value(h), 1e-6)
+
+if __name__ == '__main__':
+    import unittest as ut
+
+    suite = ut.TestSuite()
+    result = Agros2DTestResult()
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestWeakFormTransientNonlinear))
+    suite.run(result)
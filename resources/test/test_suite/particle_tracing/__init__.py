@@ -1,3 +1,4 @@
-__all__ = ["particle_tracing"]
+__all__ = ["particle_tracing", "multiparticle_tracing"]
 
 import particle_tracing
+import multiparticle_tracing
@@ -3,6 +3,7 @@ from test_suite.scenario import Agros2DTestCase
 from test_suite.scenario import Agros2DTestResult
 
 from pairparticle_tracing import save_data
+from math import pi
 import time
 
 class TestMultiParticleTracingPlanar(Agros2DTestCase):
@@ -89,10 +90,140 @@ class TestMultiParticleTracingPlanar(Agros2DTestCase):
         data.append({'te' : elapsed_time})
         save_data(data, 'convergence-{0}-{1}'.format(self.tracing.butcher_table_type, self.tracing.maximum_relative_error))
 
+class TestMultiParticleTracingOpeningAngle(Agros2DTestCase):
+    # same problem as planar multiparticle tracing
+    setUpClass = TestMultiParticleTracingPlanar.setUpClass
+
+    def setUp(self):
+        self.tracing = a2d.particle_tracing
+
+        # cloud of particles (more than one leaf of the tree)
+        n = 24
+        self.tracing.number_of_particles = n
+        self.initial_positions = [[-0.075 + 0.05 * (i % 4), 0.55 + 0.05 * (i // 4), 0] for i in range(n)]
+        self.initial_velocities = [[0, 0, 0] for i in range(n)]
+        self.particle_charges = [1e-10 for i in range(n)]
+
+        self.tracing.mass = 3.5e-5
+        self.tracing.custom_force = [0, - self.tracing.mass * 9.823, 0]
+        self.tracing.charge = 0
+        self.tracing.electrostatic_interaction = True
+        self.tracing.magnetic_interaction = False
+        self.tracing.drag_force_coefficient = 0
+
+        self.tracing.butcher_table_type = 'fehlberg'
+        self.tracing.maximum_relative_error = 1e-6
+        self.tracing.maximum_step = 0
+        self.tracing.maximum_number_of_steps = 100
+        self.tracing.include_relativistic_correction = False
+
+    def tearDown(self):
+        self.tracing.interaction_opening_angle = 0
+
+    def trajectories(self, angle):
+        self.tracing.interaction_opening_angle = angle
+        self.tracing.solve(self.initial_positions, self.initial_velocities, self.particle_charges)
+
+        x, y, z = self.tracing.positions()
+        return x, y
+
+    def compare(self, exact, approx, error):
+        for i in range(len(exact[0])):
+            # last common point of trajectories
+            n = min(len(exact[0][i]), len(approx[0][i])) - 1
+            self.assertTrue(n > 0)
+
+            self.value_test("Particle {0}: x".format(i), approx[0][i][n], exact[0][i][n], error)
+            self.value_test("Particle {0}: y".format(i), approx[1][i][n], exact[1][i][n], error)
+
+    def test_opening_angle_zero(self):
+        exact = self.trajectories(0)
+        self.assertEqual(self.tracing.interaction_opening_angle, 0)
+
+        # tree with very small opening angle has to reproduce the exact computation
+        self.compare(exact, self.trajectories(1e-6), 1e-6)
+
+    def test_opening_angle_small(self):
+        exact = self.trajectories(0)
+        self.compare(exact, self.trajectories(0.3), 1e-3)
+
+    def test_opening_angle_negative(self):
+        with self.assertRaises(IndexError):
+            self.tracing.interaction_opening_angle = -0.5
+
+class TestMultiParticleTracingAxisymmetric(Agros2DTestCase):
+    # particles without azimuthal velocity stay in their meridian plane,
+    # exact particle to particle forces have to give the same trajectories as planar problem
+    def solve_problem(self, coordinate_type):
+        problem = a2d.problem(clear = True)
+        problem.coordinate_type = coordinate_type
+        problem.mesh_type = "triangle"
+
+        electrostatic = a2d.field("electrostatic")
+        electrostatic.analysis_type = "steadystate"
+        electrostatic.number_of_refinements = 1
+        electrostatic.polynomial_order = 2
+        electrostatic.adaptivity_type = "disabled"
+        electrostatic.solver = "linear"
+
+        electrostatic.add_boundary("Ground", "electrostatic_potential", {"electrostatic_potential" : 0})
+        electrostatic.add_boundary("Neumann", "electrostatic_surface_charge_density", {"electrostatic_surface_charge_density" : 0})
+        electrostatic.add_material("Air", {"electrostatic_permittivity" : 1, "electrostatic_charge_density" : 0})
+
+        geometry = a2d.geometry
+        geometry.add_edge(0, 0, 1, 0, boundaries = {"electrostatic" : "Neumann"})
+        geometry.add_edge(1, 0, 1, 1, boundaries = {"electrostatic" : "Ground"})
+        geometry.add_edge(1, 1, 0, 1, boundaries = {"electrostatic" : "Neumann"})
+        geometry.add_edge(0, 1, 0, 0, boundaries = {"electrostatic" : "Neumann"})
+        geometry.add_label(0.5, 0.5, materials = {"electrostatic" : "Air"})
+
+        problem.solve()
+
+    def trajectories(self, coordinate_type, phi):
+        self.solve_problem(coordinate_type)
+
+        tracing = a2d.particle_tracing
+        tracing.number_of_particles = 2
+        tracing.mass = 3.5e-5
+        tracing.custom_force = [0, - tracing.mass * 9.823, 0]
+        tracing.charge = 0
+        tracing.electrostatic_interaction = True
+        tracing.magnetic_interaction = True
+        tracing.interaction_opening_angle = 0
+        tracing.drag_force_coefficient = 0
+
+        tracing.butcher_table_type = 'fehlberg'
+        tracing.maximum_relative_error = 1e-9
+        tracing.maximum_step = 0
+        tracing.maximum_number_of_steps = 100
+        tracing.include_relativistic_correction = False
+
+        # third coordinate is z (planar) or phi (axisymmetric)
+        tracing.solve([[0.4, 0.6, phi], [0.43, 0.575, phi]],
+                      [[0, -0.25, 0], [0.1, 0, 0]],
+                      [-5e-10, 1e-10])
+
+        return tracing.positions()
+
+    def test_meridian_plane(self):
+        phi = pi/6.0
+        planar = self.trajectories("planar", 0)
+        axisymmetric = self.trajectories("axisymmetric", phi)
+
+        for i in range(2):
+            n = min(len(planar[0][i]), len(axisymmetric[0][i])) - 1
+            self.assertTrue(n > 0)
+
+            self.value_test("Particle {0}: r".format(i), axisymmetric[0][i][n], planar[0][i][n], 1e-6)
+            self.value_test("Particle {0}: z".format(i), axisymmetric[1][i][n], planar[1][i][n], 1e-6)
+            self.value_test("Particle {0}: phi".format(i), axisymmetric[2][i][n], phi, 1e-6)
+
 if __name__ == '__main__':
     import unittest as ut
 
     suite = ut.TestSuite()
     result = Agros2DTestResult()
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestMultiParticleTracingPlanar))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestMultiParticleTracingOpeningAngle))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestMultiParticleTracingAxisymmetric))
     suite.run(result)
@@ -1,7 +1,9 @@
-__all__ = ["benchmark", "field", "geometry", "problem", "script"]
+__all__ = ["benchmark", "field", "geometry", "problem", "script", "datatable", "expression"]
 
 import problem
 import field
 import geometry
 import benchmark
-import script
\ No newline at end of file
+import script
+import datatable
+import expression
\ No newline at end of file
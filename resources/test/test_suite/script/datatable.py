@@ -0,0 +1,90 @@
+import agros2d as a2d
+from test_suite.scenario import Agros2DTestCase
+from test_suite.scenario import Agros2DTestResult
+
+from bisect import bisect_left
+from math import atan
+
+class TestDataTable(Agros2DTestCase):
+    def setUp(self):
+        # graded keys (dense at the beginning) to exercise bucket lookup
+        self.keys = [0.0, 0.001, 0.003, 0.01, 0.03, 0.1, 0.2, 0.5, 1.0, 1.5, 2.5, 4.0, 7.0, 10.0]
+        self.values = [1e3 * atan(5.0 * x) + 100.0 * x for x in self.keys]
+
+        # points outside the range, exact nodes and points close to nodes
+        self.points = [-1.0, -1e-12, 11.0, 1e3]
+        for key in self.keys:
+            self.points += [key, key - 1e-12, key + 1e-12]
+        for i in range(len(self.keys) - 1):
+            self.points.append((self.keys[i] + self.keys[i+1]) / 2.0)
+
+    def piecewise_linear(self, x):
+        if x <= self.keys[0]:
+            return self.values[0], 0.0
+        if x >= self.keys[-1]:
+            return self.values[-1], 0.0
+
+        i = max(bisect_left(self.keys, x) - 1, 0)
+        derivative = (self.values[i+1] - self.values[i]) / (self.keys[i+1] - self.keys[i])
+        return self.values[i] + derivative * (x - self.keys[i]), derivative
+
+    def test_piecewise_linear(self):
+        table = a2d.data_table(self.keys, self.values, interpolation = "piecewise_linear")
+
+        for x in self.points:
+            value, derivative = self.piecewise_linear(x)
+            self.assertAlmostEqual(table.value(x), value, 9, "value at {0}".format(x))
+            self.assertAlmostEqual(table.derivative(x), derivative, 9, "derivative at {0}".format(x))
+
+    def test_batch_evaluation(self):
+        for interpolation in ["piecewise_linear", "cubic_spline", "constant"]:
+            for extrapolation in ["constant", "linear"]:
+                for uniform_resampling in [False, True]:
+                    table = a2d.data_table(self.keys, self.values, interpolation = interpolation,
+                                           extrapolation = extrapolation, uniform_resampling = uniform_resampling)
+
+                    values = table.values(self.points)
+                    derivatives = table.derivatives(self.points)
+
+                    for i in range(len(self.points)):
+                        text = "{0}, {1}, {2} at {3}".format(interpolation, extrapolation, uniform_resampling, self.points[i])
+                        self.assertEqual(values[i], table.value(self.points[i]), text)
+                        self.assertEqual(derivatives[i], table.derivative(self.points[i]), text)
+
+    def test_batch_evaluation_empty(self):
+        table = a2d.data_table(self.keys, self.values)
+        self.assertEqual(table.values([]), [])
+        self.assertEqual(table.derivatives([]), [])
+
+    def test_uniform_resampling(self):
+        for extrapolation in ["constant", "linear"]:
+            spline = a2d.data_table(self.keys, self.values, interpolation = "cubic_spline",
+                                    extrapolation = extrapolation)
+            resampled = a2d.data_table(self.keys, self.values, interpolation = "cubic_spline",
+                                       extrapolation = extrapolation, uniform_resampling = True)
+
+            value_scale = max([abs(spline.value(x)) for x in self.points])
+            derivative_scale = max([abs(spline.derivative(x)) for x in self.points])
+            for x in self.points:
+                self.assertTrue(abs(resampled.value(x) - spline.value(x)) < 1e-5 * value_scale,
+                                "value at {0}: {1} != {2}".format(x, resampled.value(x), spline.value(x)))
+                self.assertTrue(abs(resampled.derivative(x) - spline.derivative(x)) < 1e-5 * derivative_scale,
+                                "derivative at {0}: {1} != {2}".format(x, resampled.derivative(x), spline.derivative(x)))
+
+    def test_wrong_arguments(self):
+        with self.assertRaises(ValueError):
+            a2d.data_table([0, 1, 2], [0, 1])
+        with self.assertRaises(ValueError):
+            a2d.data_table([0, 1], [0, 1], interpolation = "wrong_interpolation")
+        with self.assertRaises(ValueError):
+            a2d.data_table([0, 1], [0, 1], extrapolation = "wrong_extrapolation")
+        with self.assertRaises(ValueError):
+            a2d.data_table([0, 1], [0, 1], derivative_at_endpoints = "wrong_derivative")
+
+if __name__ == '__main__':
+    import unittest as ut
+
+    suite = ut.TestSuite()
+    result = Agros2DTestResult()
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestDataTable))
+    suite.run(result)
@@ -0,0 +1,86 @@
+import agros2d as a2d
+from test_suite.scenario import Agros2DTestCase
+from test_suite.scenario import Agros2DTestResult
+
+import math
+
+class TestExpression(Agros2DTestCase):
+    def setUp(self):
+        self.problem = a2d.problem(clear = True)
+        self.problem.coordinate_type = "planar"
+
+        # (time, x, y), values are passed to Python with six significant digits
+        self.points = [(0.0, 0.5, 1.25), (1.5, -0.75, 2.5), (4.25, 0.125, -3.5), (10.5, 2.5, 0.5)]
+
+    def python_value(self, expression, time, x, y):
+        variables = dict(vars(math))
+        variables["time"] = time
+        if (self.problem.coordinate_type == "planar"):
+            variables["x"] = x
+            variables["y"] = y
+        else:
+            variables["r"] = x
+            variables["z"] = y
+
+        value = float(eval(expression, variables))
+        return 0.0 if abs(value) < 1e-10 else value
+
+    def compare(self, expressions, compiled = True):
+        for text in expressions:
+            expression = a2d.expression(text)
+            self.assertEqual(expression.compiled, compiled, "{0}: compiled = {1}".format(text, expression.compiled))
+
+            for (time, x, y) in self.points:
+                value = expression.value(time, x, y)
+                normal = self.python_value(text, time, x, y)
+                self.value_test("{0} (time = {1}, x = {2}, y = {3})".format(text, time, x, y), value, normal, 1e-12)
+
+    def test_division(self):
+        self.compare(["7.0/2", "7/2.0", "1/4.0*x", "time/2", "x/y", "float(7)/2", "-7/2.0", "1e3/4"])
+        # integer division (Python 2)
+        self.compare(["7/2", "-7/2", "2*3/4", "abs(-7)/2"], compiled = False)
+
+    def test_power(self):
+        self.compare(["x**2", "2**0.5", "-2**2", "2**3**2", "2**-1", "time**2*x + y**3", "(-x)**2", "pow(x, 3)"])
+
+    def test_comparison(self):
+        self.compare(["1e3*(time<4)", "(x>=0.5)*2.0", "(x==y)+0.5", "(x!=y)*3.5", "(time<=2)*1.5 + (time>2)*2.5",
+                      "(x < y) - (y > x)", "(x + y < 1) * sin(x)"])
+        # chained comparison and conditional expression are evaluated by Python
+        self.compare(["0 < x < 1", "1.0 if time < 2 else 2.0", "(time < 2) and (x > 0)"], compiled = False)
+
+    def test_functions(self):
+        self.compare(["sin(x) + cos(y) + tan(x/2)", "asin(x/4) + acos(y/4) + atan(y)", "sinh(x) + cosh(y) + tanh(x)",
+                      "exp(-time) + expm1(x) + log(abs(y)) + log10(abs(y)) + log1p(abs(x))",
+                      "sqrt(abs(x)) + fabs(y) + floor(y) + ceil(x) + round(y)", "erf(x) + erfc(y)",
+                      "degrees(x) + radians(y)", "atan2(y, x) + fmod(y, x) + hypot(x, y) + copysign(x, y)",
+                      "log(abs(y), 2)", "min(x, y) + max(x, y, time)", "pi*e*x"])
+
+    def test_coordinates_planar(self):
+        self.compare(["x", "y", "x*y + time", "sqrt(x**2 + y**2)"])
+
+    def test_coordinates_axisymmetric(self):
+        self.problem.coordinate_type = "axisymmetric"
+        self.compare(["r", "z", "r*z + time", "sqrt(r**2 + z**2)"])
+
+    def test_time_dependent(self):
+        self.compare(["time", "2e5*(time<4.9)", "sin(2*pi*50*time)", "293.15 + 10*time", "exp(-time/2.0)*x"])
+
+    def test_invalid_expression(self):
+        # user functions and variables fall back to Python
+        self.compare(["int(y) + x", "float(int(4*y))/4"], compiled = False)
+
+        for text in ["1 +", "sin(", "x ** * 2", "undefined_variable_in_expression * 2"]:
+            expression = a2d.expression(text)
+            self.assertFalse(expression.compiled, text)
+
+            with self.assertRaises(RuntimeError):
+                expression.value(0.5, 0.5, 0.5)
+
+if __name__ == '__main__':
+    import unittest as ut
+
+    suite = ut.TestSuite()
+    result = Agros2DTestResult()
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestExpression))
+    suite.run(result)
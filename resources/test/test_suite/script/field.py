@@ -2,7 +2,7 @@ import agros2d as a2d
 from test_suite.scenario import Agros2DTestCase
 from test_suite.scenario import Agros2DTestResult
 
-from math import pi, sqrt
+from math import pi, sqrt, isnan
 
 class TestField(Agros2DTestCase):
     def setUp(self):
@@ -512,6 +512,29 @@ class TestFieldLocalValues(Agros2DTestCase):
         with self.assertRaises(RuntimeError):
             self.field.local_values(-1, -1)
 
+    def test_local_values_points(self):
+        self.problem.solve()
+        # last point is outside of the field
+        xs = [self.size/4.0, self.size/2.0, 3*self.size/4.0, self.size/8.0, -1]
+        ys = [self.size/4.0, self.size/3.0, 3*self.size/4.0, 7*self.size/8.0, -1]
+
+        values = self.field.local_values(xs, ys)
+        for i in range(len(xs) - 1):
+            point_values = self.field.local_values(xs[i], ys[i])
+            self.assertEqual(sorted(values.keys()), sorted(point_values.keys()))
+            for key in point_values:
+                self.assertEqual(len(values[key]), len(xs))
+                self.assertAlmostEqual(values[key][i], point_values[key], delta = 1e-9 * max(1.0, abs(point_values[key])))
+
+        self.assertEqual(len(self.field.local_values(xs[-1], ys[-1])), 0)
+        for key in values:
+            self.assertTrue(isnan(values[key][-1]))
+
+    def test_local_values_points_with_wrong_length(self):
+        self.problem.solve()
+        with self.assertRaises(ValueError):
+            self.field.local_values([0.1, 0.2], [0.1])
+
 class TestFieldIntegrals(Agros2DTestCase):
     def setUp(self):
         self.problem = a2d.problem(clear = True)
@@ -1,5 +1,6 @@
 import agros2d as a2d
-from math import pi, sqrt
+import random
+from math import pi, sqrt, sin, cos
 from test_suite.scenario import Agros2DTestCase
 from test_suite.scenario import Agros2DTestResult
 
@@ -188,6 +189,85 @@ class TestGeometryTransformations(Agros2DTestCase):
         self.problem.solve()
         self.assertAlmostEqual(self.electrostatic.volume_integrals([0])['S'], (self.a * scale) * (self.b * scale))
         
+class TestGeometryChecks(Agros2DTestCase):
+    def setUp(self):
+        self.problem = a2d.problem(clear = True)
+        self.geometry = a2d.geometry
+
+    def check_brute_force(self):
+        crossings = self.geometry.crossings()
+        lying_nodes = self.geometry.lying_nodes()
+
+        self.assertEqual(crossings, self.geometry.crossings(brute_force = True))
+        self.assertEqual(lying_nodes, self.geometry.lying_nodes(brute_force = True))
+
+        return crossings, lying_nodes
+
+    def test_grid(self):
+        # every horizontal edge crosses every vertical edge
+        n = 5
+        for i in range(n):
+            self.geometry.add_edge(0, i + 0.5, n, i + 0.5)
+            self.geometry.add_edge(i + 0.5, 0, i + 0.5, n)
+
+        # separated rectangle
+        self.geometry.add_edge(2*n, 0, 3*n, 0)
+        self.geometry.add_edge(3*n, 0, 3*n, n)
+        self.geometry.add_edge(3*n, n, 2*n, n)
+        self.geometry.add_edge(2*n, n, 2*n, 0)
+
+        crossings, lying_nodes = self.check_brute_force()
+        self.assertEqual(crossings, range(2*n))
+        self.assertEqual(lying_nodes, [])
+
+    def test_arc(self):
+        # edge inside bounding box of the arc (outside the circle)
+        self.geometry.add_edge(1, 0, 0, 1, angle = 90)
+        self.geometry.add_edge(0.8, 0.98, 0.9, 0.95)
+
+        crossings, lying_nodes = self.check_brute_force()
+        self.assertEqual(crossings, [])
+
+        # edge through the arc
+        self.geometry.add_edge(0, 0, 1, 1)
+
+        crossings, lying_nodes = self.check_brute_force()
+        self.assertEqual(crossings, [0, 2])
+
+    def test_lying_nodes(self):
+        # long edge stored in many cells of the index
+        self.geometry.add_edge(0, 0, 10, 10)
+        for i in range(10):
+            self.geometry.add_edge(i + 0.5, 0, i + 0.6, 0)
+            self.geometry.add_node(i + 0.25, i + 0.25)
+
+        crossings, lying_nodes = self.check_brute_force()
+        self.assertEqual(crossings, [])
+        self.assertEqual(len(lying_nodes), 10)
+
+    def test_random(self):
+        generator = random.Random(0)
+
+        for i in range(200):
+            x = generator.uniform(0, 10)
+            y = generator.uniform(0, 10)
+            length = generator.uniform(0.1, 2.0)
+            angle = generator.uniform(0, 2*pi)
+            self.geometry.add_edge(x, y, x + length * cos(angle), y + length * sin(angle))
+
+            # node in the middle of the edge
+            if (i % 10 == 0):
+                self.geometry.add_node(x + length * cos(angle) / 2.0, y + length * sin(angle) / 2.0)
+
+        for i in range(10):
+            x = generator.uniform(0, 10)
+            y = generator.uniform(0, 10)
+            self.geometry.add_edge(x, y, x + generator.uniform(0.5, 1.0), y, angle = generator.uniform(30, 90))
+
+        crossings, lying_nodes = self.check_brute_force()
+        self.assertTrue(len(crossings) > 0)
+        self.assertTrue(len(lying_nodes) >= 20)
+
 if __name__ == '__main__':        
     import unittest as ut
     
@@ -195,4 +275,5 @@ if __name__ == '__main__':
     result = Agros2DTestResult()
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestGeometry))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestGeometryTransformations))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestGeometryChecks))
     suite.run(result)
\ No newline at end of file
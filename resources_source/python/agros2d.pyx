@@ -110,6 +110,8 @@ include "pyfield.pxi"
 include "pygeometry.pxi"
 include "pyview.pxi"
 include "pyparticletracing.pxi"
+include "pydatatable.pxi"
+include "pyexpression.pxi"
 
 cdef extern from "../../agros2d-library/pythonlab/pythonengine_agros.h":
     # open and save
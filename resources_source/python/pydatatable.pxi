@@ -0,0 +1,65 @@
+cdef extern from "../../agros2d-library/pythonlab/pydatatable.h":
+    cdef cppclass PyDataTable:
+        PyDataTable()
+
+        void setValues(vector[double] &keys, vector[double] &values,
+                       string &interpolation, string &extrapolation,
+                       string &derivativeAtEndpoints, bool uniformResampling) except +
+
+        double value(double key) except +
+        double derivative(double key) except +
+
+        void values(vector[double] &keys, vector[double] &values) except +
+        void derivatives(vector[double] &keys, vector[double] &derivatives) except +
+
+cdef class __DataTable__:
+    cdef PyDataTable *thisptr
+
+    def __cinit__(self):
+        self.thisptr = new PyDataTable()
+    def __dealloc__(self):
+        del self.thisptr
+
+    def value(self, key):
+        """Return value of table at key."""
+        return self.thisptr.value(key)
+
+    def derivative(self, key):
+        """Return derivative of table at key."""
+        return self.thisptr.derivative(key)
+
+    def values(self, keys):
+        """Return list of values of table at keys."""
+        cdef vector[double] values_vector
+        self.thisptr.values(list_to_double_vector(keys), values_vector)
+
+        return double_vector_to_list(values_vector)
+
+    def derivatives(self, keys):
+        """Return list of derivatives of table at keys."""
+        cdef vector[double] derivatives_vector
+        self.thisptr.derivatives(list_to_double_vector(keys), derivatives_vector)
+
+        return double_vector_to_list(derivatives_vector)
+
+def data_table(x, y, interpolation = "piecewise_linear", extrapolation = "constant",
+               derivative_at_endpoints = "first", uniform_resampling = False):
+    """Create table of nonlinear material parameter.
+
+    data_table(x, y, interpolation = "piecewise_linear", extrapolation = "constant",
+               derivative_at_endpoints = "first", uniform_resampling = False)
+
+    Keyword arguments:
+    x -- keys in ascending order
+    y -- values
+    interpolation -- interpolation ("piecewise_linear", "cubic_spline" or "constant")
+    extrapolation -- extrapolation of cubic spline ("constant" or "linear")
+    derivative_at_endpoints -- derivative of cubic spline to be zero at endpoints ("first" or "second")
+    uniform_resampling -- resample cubic spline on uniform grid (default is False)
+    """
+    table = __DataTable__()
+    table.thisptr.setValues(list_to_double_vector(x), list_to_double_vector(y),
+                            string(interpolation), string(extrapolation),
+                            string(derivative_at_endpoints), uniform_resampling)
+
+    return table
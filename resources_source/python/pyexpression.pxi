@@ -0,0 +1,51 @@
+cdef extern from "../../agros2d-library/pythonlab/pyexpression.h":
+    cdef cppclass PyExpression:
+        PyExpression()
+
+        void setExpression(string &expression) except +
+        string expression()
+
+        bool isCompiled()
+
+        double value(double time, double x, double y) except +
+
+cdef class __Expression__:
+    cdef PyExpression *thisptr
+
+    def __cinit__(self):
+        self.thisptr = new PyExpression()
+    def __dealloc__(self):
+        del self.thisptr
+
+    property expression:
+        def __get__(self):
+            return self.thisptr.expression().c_str()
+
+    property compiled:
+        def __get__(self):
+            return self.thisptr.isCompiled()
+
+    def value(self, time = 0.0, x = 0.0, y = 0.0):
+        """Return value of expression.
+
+        value(time = 0.0, x = 0.0, y = 0.0)
+
+        Keyword arguments:
+        time -- time (default is 0.0)
+        x -- first coordinate, x or r (default is 0.0)
+        y -- second coordinate, y or z (default is 0.0)
+        """
+        return self.thisptr.value(time, x, y)
+
+def expression(expression):
+    """Create expression of material or boundary condition.
+
+    expression(expression)
+
+    Keyword arguments:
+    expression -- expression with variables time, x, y (planar) or r, z (axisymmetric)
+    """
+    expr = __Expression__()
+    expr.thisptr.setExpression(string(expression))
+
+    return expr
@@ -75,6 +75,8 @@ cdef extern from "../../agros2d-library/pythonlab/pyfield.h":
 
         void localValues(double x, double y, int timeStep, int adaptivityStep,
                          string &solutionType, map[string, double] &results) except +
+        void localValuesPoints(vector[double] &x, vector[double] &y, int timeStep, int adaptivityStep,
+                               string &solutionType, map[string, vector[double]] &results) except +
         void surfaceIntegrals(vector[int], int timeStep, int adaptivityStep,
                               string &solutionType, map[string, double] &results) except +
         void volumeIntegrals(vector[int], int timeStep, int adaptivityStep,
@@ -89,6 +91,9 @@ cdef extern from "../../agros2d-library/pythonlab/pyfield.h":
 
         void adaptivityInfo(int timeStep, string &solutionType, vector[double] &error, vector[int] &dofs) except +
 
+        void calculatedTimeSteps(vector[int] &timeSteps) except +
+        int nearestCalculatedTimeStep(int timeStep) except +
+
         string filenameMatrix(int timeStep, int adaptivityStep) except +
         string filenameRHS(int timeStep, int adaptivityStep) except +
 
@@ -183,6 +188,11 @@ cdef map[string, map[string, string]] get_settings_map(parameters):
                 setting.second = string(parameters[key]["extrapolation"])
                 settings.insert(setting)
 
+            if ("uniform_resampling" in parameters[key]):
+                setting.first = string("uniform_resampling")
+                setting.second = string("true" if parameters[key]["uniform_resampling"] else "false")
+                settings.insert(setting)
+
         if (settings.size()):
             settings_map_pair.first = string(key)
             settings_map_pair.second = settings
@@ -505,13 +515,19 @@ cdef class __Field__:
 
         local_values(x, y, time_step = None, adaptivity_step = None, solution_type = "normal")
 
+        If x and y are sequences, values in all points are computed at once
+        and dictionary contains lists of values (NaN for points outside of the field).
+
         Keyword arguments:
-        x -- x or r coordinate of point
-        y -- y or z coordinate of point
+        x -- x or r coordinate of point (or sequence of coordinates)
+        y -- y or z coordinate of point (or sequence of coordinates)
         time_step -- time step (default is None - use last time step)
         adaptivity_step -- adaptivity step (default is None - use adaptive step)
         solution_type -- solution type (default is "normal")
         """
+        if hasattr(x, '__len__') and hasattr(y, '__len__'):
+            return self._local_values_points(x, y, time_step, adaptivity_step, solution_type)
+
         out = dict()
         cdef map[string, double] results
 
@@ -526,6 +542,28 @@ cdef class __Field__:
 
         return out
 
+    def _local_values_points(self, x, y, time_step, adaptivity_step, solution_type):
+        cdef vector[double] x_vector
+        cdef vector[double] y_vector
+        for i in x:
+            x_vector.push_back(i)
+        for i in y:
+            y_vector.push_back(i)
+
+        out = dict()
+        cdef map[string, vector[double]] results
+
+        self.thisptr.localValuesPoints(x_vector, y_vector,
+                                       int(-1 if time_step is None else time_step),
+                                       int(-1 if adaptivity_step is None else adaptivity_step),
+                                       string(solution_type), results)
+        it = results.begin()
+        while it != results.end():
+            out[deref(it).first.c_str()] = deref(it).second
+            incr(it)
+
+        return out
+
     # surface integrals
     def surface_integrals(self, edges = [], time_step = None, adaptivity_step = None, solution_type = "normal"):
         """Compute surface integrals on edges and return dictionary with results.
@@ -684,6 +722,28 @@ cdef class __Field__:
 
         return {'error' : error, 'dofs' : dofs}
 
+    # time steps
+    def calculated_time_steps(self):
+        """Return list of time steps, in which field was calculated."""
+        cdef vector[int] time_steps_vector
+        self.thisptr.calculatedTimeSteps(time_steps_vector)
+
+        time_steps = list()
+        for i in range(time_steps_vector.size()):
+            time_steps.append(time_steps_vector[i])
+
+        return time_steps
+
+    def nearest_calculated_time_step(self, time_step = None):
+        """Return nearest time step (not greater than time_step), in which field was calculated.
+
+        nearest_calculated_time_step(time_step = None)
+
+        Keyword arguments:
+        time_step -- time step (default is None - use last time step)
+        """
+        return self.thisptr.nearestCalculatedTimeStep(int(-1 if time_step is None else time_step))
+
         # filename - matrix
     def filename_matrix(self, time_step = None, adaptivity_step = None):
         return self.thisptr.filenameMatrix(int(-1 if time_step is None else time_step),
@@ -35,6 +35,9 @@ cdef extern from "../../agros2d-library/pythonlab/pygeometry.h":
         void scaleSelection(double x, double y, double scale, bool copy, bool withMarkers)
         void removeSelection()
 
+        void crossings(vector[int] &edges, bool bruteForce)
+        void lyingNodes(vector[int] &nodes, bool bruteForce)
+
         void exportVTK(string filename)
 
 cdef class __Geometry__:
@@ -256,6 +259,40 @@ cdef class __Geometry__:
         """Return count of existing labels."""
         return self.thisptr.labelsCount()
 
+    def crossings(self, brute_force = False):
+        """Return list of indexes of crossed edges.
+
+        crossings(brute_force = False)
+
+        Keyword arguments:
+        brute_force -- check all pairs of edges instead of spatial index (very slow, default is False)
+        """
+        cdef vector[int] edges_vector
+        self.thisptr.crossings(edges_vector, brute_force)
+
+        edges = list()
+        for i in range(edges_vector.size()):
+            edges.append(edges_vector[i])
+
+        return edges
+
+    def lying_nodes(self, brute_force = False):
+        """Return list of indexes of nodes lying on edges.
+
+        lying_nodes(brute_force = False)
+
+        Keyword arguments:
+        brute_force -- check all pairs of nodes and edges instead of spatial index (very slow, default is False)
+        """
+        cdef vector[int] nodes_vector
+        self.thisptr.lyingNodes(nodes_vector, brute_force)
+
+        nodes = list()
+        for i in range(nodes_vector.size()):
+            nodes.append(nodes_vector[i])
+
+        return nodes
+
     def select_nodes(self, nodes = []):
         """Select nodes according to their indexes.
 
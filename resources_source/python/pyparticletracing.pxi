@@ -34,6 +34,8 @@ cdef extern from "../../agros2d-library/pythonlab/pyparticletracing.h":
         void setElectrostaticInteraction(bool interaction)
         bool getMagneticInteraction()
         void setMagneticInteraction(bool interaction)
+        double getInteractionOpeningAngle()
+        void setInteractionOpeningAngle(double angle) except +
 
         bool getIncludeRelativisticCorrection()
         void setIncludeRelativisticCorrection(bool incl)
@@ -240,6 +242,12 @@ cdef class __ParticleTracing__:
         def __set__(self, interaction):
             self.thisptr.setMagneticInteraction(interaction)
 
+    property interaction_opening_angle:
+        def __get__(self):
+            return self.thisptr.getInteractionOpeningAngle()
+        def __set__(self, angle):
+            self.thisptr.setInteractionOpeningAngle(angle)
+
     property butcher_table_type:
         def __get__(self):
             return self.thisptr.getButcherTableType().c_str()
@@ -17,10 +17,276 @@
 // University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
 // Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
 
+#include <QCoreApplication>
+#include <QLocalServer>
+#include <QSharedMemory>
+
 #include "hermes2d.h"
 #include "util/memory_handling.h"
 
 #include "../3rdparty/tclap/CmdLine.h"
+#include "../agros2d-library/hermes2d/solver_external_protocol.h"
+
+// factorized system kept between solves
+struct Factorization
+{
+    Factorization(const QString &solverName) : matrix(NULL), rhs(new SimpleVector<double>()), solver(NULL)
+    {
+        if (solverName == "umfpack")
+        {
+            matrix = new CSCMatrix<double>();
+            solver = new UMFPackLinearMatrixSolver<double>(matrix, rhs);
+        }
+        else if (solverName == "mumps")
+        {
+            matrix = new MumpsMatrix<double>();
+            solver = new MumpsSolver<double>(static_cast<MumpsMatrix<double> *>(matrix), rhs);
+        }
+    }
+
+    ~Factorization()
+    {
+        delete solver;
+        delete matrix;
+        delete rhs;
+    }
+
+    CSCMatrix<double> *matrix;
+    SimpleVector<double> *rhs;
+    LinearMatrixSolver<double> *solver;
+
+    // copy of the factorized matrix (reuse is decided by exact comparison, hash only finds the candidate)
+    QVector<int> Ap;
+    QVector<int> Ai;
+    QVector<double> Ax;
+
+    void storeMatrix(void *data, int size, int nnz)
+    {
+        Ap.resize(size + 1);
+        Ai.resize(nnz);
+        Ax.resize(nnz);
+        memcpy(Ap.data(), solverExternalAp(data, size, nnz), (size + 1) * sizeof(int));
+        memcpy(Ai.data(), solverExternalAi(data, size, nnz), nnz * sizeof(int));
+        memcpy(Ax.data(), solverExternalAx(data, size, nnz), nnz * sizeof(double));
+    }
+
+    bool sameStructure(void *data, int size, int nnz) const
+    {
+        return (Ap.size() == size + 1) && (Ai.size() == nnz)
+                && (memcmp(Ap.constData(), solverExternalAp(data, size, nnz), (size + 1) * sizeof(int)) == 0)
+                && (memcmp(Ai.constData(), solverExternalAi(data, size, nnz), nnz * sizeof(int)) == 0);
+    }
+
+    bool sameValues(void *data, int size, int nnz) const
+    {
+        return (Ax.size() == nnz)
+                && (memcmp(Ax.constData(), solverExternalAx(data, size, nnz), nnz * sizeof(double)) == 0);
+    }
+};
+
+// factorizations keyed by solver and matrix structure hash (least recently used are released)
+class FactorizationCache
+{
+public:
+    FactorizationCache() : m_last(NULL) {}
+
+    ~FactorizationCache()
+    {
+        qDeleteAll(m_factorizations);
+    }
+
+    // solve system stored in shared memory, solution is written back to shared memory
+    SolverExternalStatus solve(const QString &solverName, void *data, int size, int nnz,
+                               quint64 structureHash, bool matrixIncluded)
+    {
+        QPair<QString, quint64> key(solverName, structureHash);
+        Factorization *factorization = m_factorizations.value(key, NULL);
+
+        if (factorization && (factorization->matrix->get_size() != size || factorization->matrix->get_nnz() != nnz
+                              || (matrixIncluded && !factorization->sameStructure(data, size, nnz))))
+        {
+            remove(key);
+            factorization = NULL;
+        }
+
+        // without matrix only the factorization of the previous solve is valid (client did not assemble the matrix again)
+        if (!matrixIncluded && (!factorization || factorization != m_last))
+            return SolverExternalStatus_MatrixRequired;
+
+        if (!factorization)
+        {
+            // new structure, symbolic and numeric factorization
+            factorization = new Factorization(solverName);
+            if (!factorization->solver)
+            {
+                delete factorization;
+                throw Hermes::Exceptions::Exception("Unknown solver '%s'.", solverName.toStdString().c_str());
+            }
+
+            factorization->matrix->create(size, nnz,
+                                          solverExternalAp(data, size, nnz),
+                                          solverExternalAi(data, size, nnz),
+                                          solverExternalAx(data, size, nnz));
+            factorization->rhs->alloc(size);
+            factorization->solver->set_reuse_scheme(HERMES_CREATE_STRUCTURE_FROM_SCRATCH);
+            factorization->storeMatrix(data, size, nnz);
+
+            m_factorizations[key] = factorization;
+            m_order.append(key);
+
+            while (m_order.count() > MAX_FACTORIZATIONS)
+                remove(m_order.first());
+        }
+        else if (matrixIncluded && !factorization->sameValues(data, size, nnz))
+        {
+            // same structure, numeric factorization only (symbolic analysis is kept by the solver)
+            factorization->matrix->free();
+            factorization->matrix->create(size, nnz,
+                                          solverExternalAp(data, size, nnz),
+                                          solverExternalAi(data, size, nnz),
+                                          solverExternalAx(data, size, nnz));
+            factorization->solver->set_reuse_scheme(HERMES_REUSE_MATRIX_REORDERING);
+            factorization->storeMatrix(data, size, nnz);
+
+            m_order.removeOne(key);
+            m_order.append(key);
+        }
+        else
+        {
+            // same matrix, triangular solves only
+            factorization->solver->set_reuse_scheme(HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY);
+
+            m_order.removeOne(key);
+            m_order.append(key);
+        }
+
+        factorization->rhs->set_vector(solverExternalRHS(data, size, nnz));
+
+        try
+        {
+            factorization->solver->solve();
+            m_last = factorization;
+        }
+        catch (...)
+        {
+            // factorization is not valid
+            remove(key);
+            throw;
+        }
+
+        memcpy(solverExternalSln(data, size, nnz), factorization->solver->get_sln_vector(), size * sizeof(double));
+
+        return SolverExternalStatus_OK;
+    }
+
+private:
+    static const int MAX_FACTORIZATIONS = 4;
+
+    QMap<QPair<QString, quint64>, Factorization *> m_factorizations;
+    QList<QPair<QString, quint64> > m_order;
+    // factorization used in the previous solve
+    Factorization *m_last;
+
+    void remove(const QPair<QString, quint64> &key)
+    {
+        Factorization *factorization = m_factorizations.take(key);
+        if (factorization == m_last)
+            m_last = NULL;
+
+        delete factorization;
+        m_order.removeOne(key);
+    }
+};
+
+// server mode, repeated solves requested over local socket
+int runServer(const QString &serverName)
+{
+    QLocalServer::removeServer(serverName);
+
+    QLocalServer server;
+    if (!server.listen(serverName))
+    {
+        std::cerr << "error: could not listen on " << serverName.toStdString() << ": " << server.errorString().toStdString() << std::endl;
+        return 1;
+    }
+
+    if (!server.waitForNewConnection(-1))
+        return 1;
+
+    QLocalSocket *socket = server.nextPendingConnection();
+    QSharedMemory sharedMemory;
+    FactorizationCache factorizations;
+
+    QByteArray request;
+    while (readSolverExternalMessage(socket, request))
+    {
+        QDataStream in(&request, QIODevice::ReadOnly);
+        qint32 command;
+        in >> command;
+
+        if (command == SolverExternalCommand_Quit)
+            break;
+
+        QString solverName;
+        QString key;
+        qint32 size;
+        qint32 nnz;
+        quint64 structureHash;
+        bool matrixIncluded;
+        in >> solverName >> key >> size >> nnz >> structureHash >> matrixIncluded;
+
+        qint32 status = SolverExternalStatus_OK;
+        QString message;
+
+        // client creates new segment when the system grows
+        if (sharedMemory.key() != key)
+        {
+            if (sharedMemory.isAttached())
+                sharedMemory.detach();
+            sharedMemory.setKey(key);
+            sharedMemory.attach();
+        }
+
+        if (!sharedMemory.isAttached())
+        {
+            status = SolverExternalStatus_Error;
+            message = sharedMemory.errorString();
+        }
+        else
+        {
+            sharedMemory.lock();
+            try
+            {
+                status = factorizations.solve(solverName, sharedMemory.data(), size, nnz,
+                                              structureHash, matrixIncluded);
+            }
+            catch (Hermes::Exceptions::Exception &e)
+            {
+                status = SolverExternalStatus_Error;
+                message = QString::fromStdString(e.info());
+            }
+            catch (std::exception &e)
+            {
+                status = SolverExternalStatus_Error;
+                message = QString::fromLatin1(e.what());
+            }
+            sharedMemory.unlock();
+        }
+
+        QByteArray response;
+        QDataStream out(&response, QIODevice::WriteOnly);
+        out << status << message;
+
+        if (!writeSolverExternalMessage(socket, response))
+            break;
+    }
+
+    if (sharedMemory.isAttached())
+        sharedMemory.detach();
+    socket->disconnectFromServer();
+
+    return 0;
+}
 
 int main(int argc, char *argv[])
 {
@@ -29,21 +295,35 @@ int main(int argc, char *argv[])
         // command line info
         TCLAP::CmdLine cmd("Solver MUMPS", ' ');
 
-        TCLAP::ValueArg<std::string> solverArg("o", "solver", "Solver", true, "", "string");
-        TCLAP::ValueArg<std::string> matrixArg("m", "matrix", "Matrix", true, "", "string");
-        TCLAP::ValueArg<std::string> rhsArg("r", "rhs", "RHS", true, "", "string");
-        TCLAP::ValueArg<std::string> solutionArg("s", "solution", "Solution", true, "", "string");
+        TCLAP::ValueArg<std::string> solverArg("o", "solver", "Solver", false, "", "string");
+        TCLAP::ValueArg<std::string> matrixArg("m", "matrix", "Matrix", false, "", "string");
+        TCLAP::ValueArg<std::string> rhsArg("r", "rhs", "RHS", false, "", "string");
+        TCLAP::ValueArg<std::string> solutionArg("s", "solution", "Solution", false, "", "string");
         TCLAP::ValueArg<std::string> initialArg("i", "initial", "Initial vector", false, "", "string");
+        TCLAP::ValueArg<std::string> serverArg("", "server", "Run as server (local socket name)", false, "", "string");
 
         cmd.add(solverArg);
         cmd.add(matrixArg);
         cmd.add(rhsArg);
         cmd.add(solutionArg);
         cmd.add(initialArg);
+        cmd.add(serverArg);
 
         // parse the argv array.
         cmd.parse(argc, argv);
 
+        if (!serverArg.getValue().empty())
+        {
+            QCoreApplication app(argc, argv);
+            return runServer(QString::fromStdString(serverArg.getValue()));
+        }
+
+        if (solverArg.getValue().empty() || matrixArg.getValue().empty() || rhsArg.getValue().empty() || solutionArg.getValue().empty())
+        {
+            std::cerr << "error: solver, matrix, rhs and solution are required" << std::endl;
+            return 1;
+        }
+
         CSCMatrix<double> *matrix = NULL;
         SimpleVector<double> *rhs = new SimpleVector<double>();
         LinearMatrixSolver<double> *solver;